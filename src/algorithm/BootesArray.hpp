@@ -3,16 +3,37 @@
 #include <string>
 #include <memory>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// alignment (in bytes) of the storage of every owning BootesArray; one AVX-512 register / cache line
+const std::size_t BOOTES_ALIGNMENT = 64;
 
 
 template<typename T>
 class BootesArray {
+    static_assert(std::is_trivial<T>::value, "BootesArray only holds trivial types (storage is raw aligned memory)");
 
     public:
     BootesArray(){
         arr_ = nullptr;
         shape_ = nullptr;
+        dimension_ = 0;
+        arrsize_ = 0;
         allocated_ = false;
+        owner_ = false;
+    }
+
+    // copy constructor, always makes an owning deep copy (also when copying a view)
+    BootesArray(const BootesArray<T> &rhs) : BootesArray(){
+        copy_from(rhs);
+    }
+
+    // move constructor, steals the buffer (a moved view stays a view)
+    BootesArray(BootesArray<T> &&rhs) noexcept : BootesArray(){
+        steal_from(rhs);
     }
     __attribute__((nothrow)) void NewBootesArray(int size1){
             if (allocated_){ clean(); }
@@ -115,9 +136,14 @@ class BootesArray {
             }
     // destructor
     void clean(){
-        delete[] arr_;
+        if (owner_){
+            ::operator delete[](arr_, std::align_val_t(BOOTES_ALIGNMENT));
+        }
         delete[] shape_;
+        arr_ = nullptr;
+        shape_ = nullptr;
         allocated_ = false;
+        owner_ = false;
     }
 
     // destructor
@@ -162,28 +188,59 @@ class BootesArray {
         return arr_[x1 + size1_*(x2 + size2_*(x3 + size3_ * (x4 + size4_ * (x5 + size5_ * x6))))];
     }
 
-    //cloner
+    //cloner, keeps the current buffer if it already has the shape of rhs (e.g. output snapshots taken every frame)
     BootesArray<T> &operator=(const BootesArray<T> &rhs){
-        arr_ = new T[rhs.arrsize_];
-        for (int ii = 0; ii < rhs.arrsize_; ii++){
-            arr_[ii] = rhs.arr_[ii];
+        if (this != &rhs){
+            if (owner_ && allocated_ && rhs.allocated_ && same_shape(rhs)){
+                for (int ii = 0; ii < arrsize_; ii++){
+                    arr_[ii] = rhs.arr_[ii];
+                }
+            }
+            else {
+                clean();
+                copy_from(rhs);
+            }
         }
-        size1_ = rhs.size1_;
-        size2_ = rhs.size2_;
-        size3_ = rhs.size3_;
-        size4_ = rhs.size4_;
-        size5_ = rhs.size5_;
-        size6_ = rhs.size6_;
-        int shape_length = sizeof(rhs.shape_) / sizeof(rhs.shape_[0]);
-        shape_ = new int[shape_length];
-        for (int ii = 0; ii < shape_length; ii++){
-            shape_[ii] = rhs.shape_[ii];
+        return *this;
+    }
+
+    BootesArray<T> &operator=(BootesArray<T> &&rhs) noexcept {
+        if (this != &rhs){
+            clean();
+            steal_from(rhs);
         }
-        dimension_ = rhs.dimension_;
-        arrsize_ = rhs.arrsize_;
         return *this;
     }
 
+    // non-owning view of one index of the leading dimension, e.g. cons.slice(IDN) is the 3D density
+    // array and dcons.slice(specIND) the 4D array of one species. Indexing a view does not copy;
+    // the view must not outlive the array it was taken from.
+    BootesArray<T> slice(int x){
+        BootesArray<T> view;
+        int stride = arrsize_ / shape_[0];
+        view.arr_ = arr_ + x * stride;
+        view.size1_ = size1_;
+        view.size2_ = size2_;
+        view.size3_ = size3_;
+        view.size4_ = size4_;
+        view.size5_ = size5_;
+        view.size6_ = 1;
+        view.dimension_ = dimension_ - 1;
+        view.shape_ = new int[view.dimension_];
+        for (int ii = 0; ii < view.dimension_; ii++){
+            view.shape_[ii] = shape_[ii + 1];
+        }
+        // the leading size of the view is now stored one slot lower
+        if      (dimension_ == 2){ view.size2_ = 1; }
+        else if (dimension_ == 3){ view.size3_ = 1; }
+        else if (dimension_ == 4){ view.size4_ = 1; }
+        else if (dimension_ == 5){ view.size5_ = 1; }
+        view.arrsize_ = stride;
+        view.allocated_ = true;
+        view.owner_ = false;
+        return view;
+    }
+
     int *shape(){
         return shape_;
     }
@@ -204,6 +261,10 @@ class BootesArray {
         return allocated_;
     }
 
+    bool checkowner(){
+        return owner_;
+    }
+
     void set_uniform(int x){
         for (int ii = 0; ii < arrsize_; ii ++){
             arr_[ii] = (double) x;
@@ -232,10 +293,61 @@ class BootesArray {
         int dimension_;
         int arrsize_;
         bool allocated_;
+        bool owner_;            // false for views created by slice()
 
     void Allocate(){
         arrsize_ = size1_*size2_*size3_*size4_*size5_*size6_;
-        arr_ = new T[arrsize_];
+        arr_ = static_cast<T*>(::operator new[](sizeof(T) * arrsize_, std::align_val_t(BOOTES_ALIGNMENT)));
+        owner_ = true;
+    }
+
+    bool same_shape(const BootesArray<T> &rhs) const {
+        return dimension_ == rhs.dimension_
+            && size1_ == rhs.size1_ && size2_ == rhs.size2_ && size3_ == rhs.size3_
+            && size4_ == rhs.size4_ && size5_ == rhs.size5_ && size6_ == rhs.size6_;
+    }
+
+    void copy_from(const BootesArray<T> &rhs){
+        if (!rhs.allocated_){
+            return;
+        }
+        size1_ = rhs.size1_;
+        size2_ = rhs.size2_;
+        size3_ = rhs.size3_;
+        size4_ = rhs.size4_;
+        size5_ = rhs.size5_;
+        size6_ = rhs.size6_;
+        Allocate();
+        for (int ii = 0; ii < arrsize_; ii++){
+            arr_[ii] = rhs.arr_[ii];
+        }
+        dimension_ = rhs.dimension_;
+        shape_ = new int[dimension_];
+        for (int ii = 0; ii < dimension_; ii++){
+            shape_[ii] = rhs.shape_[ii];
+        }
+        allocated_ = true;
+    }
+
+    void steal_from(BootesArray<T> &rhs){
+        arr_ = rhs.arr_;
+        size1_ = rhs.size1_;
+        size2_ = rhs.size2_;
+        size3_ = rhs.size3_;
+        size4_ = rhs.size4_;
+        size5_ = rhs.size5_;
+        size6_ = rhs.size6_;
+        shape_ = rhs.shape_;
+        dimension_ = rhs.dimension_;
+        arrsize_ = rhs.arrsize_;
+        allocated_ = rhs.allocated_;
+        owner_ = rhs.owner_;
+        rhs.arr_ = nullptr;
+        rhs.shape_ = nullptr;
+        rhs.dimension_ = 0;
+        rhs.arrsize_ = 0;
+        rhs.allocated_ = false;
+        rhs.owner_ = false;
     }
 
 
@@ -252,6 +364,79 @@ class BootesArray {
 };
 
 
-#endif
+/** Non-owning view of a BootesArray with the rank fixed at compile time.
+ *  Strides are computed once at construction and the innermost stride is always 1,
+ *  so ptr() returns a contiguous row that can be declared __restrict in the kernels.
+ *  The view does not keep the array alive; build it right before the loop that uses it. **/
+template<typename T, int Rank>
+class BootesView {
+    static_assert(Rank >= 1 && Rank <= 6, "BootesView rank must be 1 to 6");
 
+    public:
+    BootesView(){
+        arr_ = nullptr;
+    }
 
+    explicit BootesView(BootesArray<T> &arr){
+        if (arr.dimension() != Rank){
+            std::cout << "BootesView: rank " << Rank << " does not match array dimension " << arr.dimension() << std::endl << std::flush;
+            throw 1;
+        }
+        arr_ = arr.get_arr();
+        stride_[Rank - 1] = 1;
+        for (int rr = Rank - 2; rr >= 0; rr--){
+            stride_[rr] = stride_[rr + 1] * arr.shape()[rr + 1];
+        }
+        for (int rr = 0; rr < Rank; rr++){
+            extent_[rr] = arr.shape()[rr];
+        }
+    }
+
+    // element access, same index order as BootesArray::operator()
+    template<typename... Idx>
+    inline T &operator() (Idx... idx) const {
+        static_assert(sizeof...(Idx) == Rank, "BootesView: number of indices must equal the rank");
+        return arr_[offset(idx...)];
+    }
+
+    // pointer to the sub-block addressed by the leading indices; with Rank - 1 indices this is a contiguous row
+    template<typename... Idx>
+    inline T *ptr(Idx... idx) const {
+        static_assert(sizeof...(Idx) <= Rank, "BootesView: too many indices");
+        return arr_ + offset(idx...);
+    }
+
+    inline T *data() const {
+        return arr_;
+    }
+
+    inline int stride(int rr) const {
+        return stride_[rr];
+    }
+
+    inline int extent(int rr) const {
+        return extent_[rr];
+    }
+
+    private:
+        T *arr_;
+        int stride_[Rank];
+        int extent_[Rank];
+
+    inline int offset() const {
+        return 0;
+    }
+
+    template<typename... Idx>
+    inline int offset(Idx... idx) const {
+        const int ids[] = {static_cast<int>(idx)...};
+        int off = 0;
+        for (int rr = 0; rr < (int) sizeof...(Idx); rr++){
+            off += ids[rr] * stride_[rr];
+        }
+        return off;
+    }
+};
+
+
+#endif
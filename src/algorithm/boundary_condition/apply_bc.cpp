@@ -1,94 +1,51 @@
 #include "apply_bc.hpp"
 #include "../mesh/mesh.hpp"
 
-/*
-void apply_boundary_condition(mesh &m){
-    outflow_boundary_condition_x1i(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    outflow_boundary_condition_x1i(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    outflow_boundary_condition_x1o(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    outflow_boundary_condition_x1o(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    sph_polar_pole_boundary_condition_x2i(m.cons, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-    sph_polar_pole_boundary_condition_x2i(m.prim, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-
-    sph_polar_pole_boundary_condition_x2o(m.cons, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-    sph_polar_pole_boundary_condition_x2o(m.prim, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-
-    periodic_boundary_condition_x3i(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    periodic_boundary_condition_x3i(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    periodic_boundary_condition_x3o(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    periodic_boundary_condition_x3o(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-}
-*/
+#ifdef ENABLE_MPI
+    #include "../mpi/halo_exchange.hpp"
+#endif // ENABLE_MPI
+
+
+typedef void (*bc_function)(BootesArray<state_real> &quan, int &x1s, int &x1l, int &ng1,
+                                                           int &x2s, int &x2l, int &ng2,
+                                                           int &x3s, int &x3l, int &ng3);
+
+// boundary kernels by [BoundaryType][BoundaryFace], chosen in the input file (bc_x1i = standard, ...)
+// the pole only exists at the x2 faces; PhysicsModules::setup_modules rejects it elsewhere
+static const bc_function bc_table[NUMBCTYPES][6] = {
+    {standard_boundary_condition_x1i<state_real>,   standard_boundary_condition_x1o<state_real>,
+     standard_boundary_condition_x2i<state_real>,   standard_boundary_condition_x2o<state_real>,
+     standard_boundary_condition_x3i<state_real>,   standard_boundary_condition_x3o<state_real>},
+    {periodic_boundary_condition_x1i<state_real>,   periodic_boundary_condition_x1o<state_real>,
+     periodic_boundary_condition_x2i<state_real>,   periodic_boundary_condition_x2o<state_real>,
+     periodic_boundary_condition_x3i<state_real>,   periodic_boundary_condition_x3o<state_real>},
+    {reflective_boundary_condition_x1i<state_real>, reflective_boundary_condition_x1o<state_real>,
+     reflective_boundary_condition_x2i<state_real>, reflective_boundary_condition_x2o<state_real>,
+     reflective_boundary_condition_x3i<state_real>, reflective_boundary_condition_x3o<state_real>},
+    {outflow_boundary_condition_x1i<state_real>,    outflow_boundary_condition_x1o<state_real>,
+     outflow_boundary_condition_x2i<state_real>,    outflow_boundary_condition_x2o<state_real>,
+     outflow_boundary_condition_x3i<state_real>,    outflow_boundary_condition_x3o<state_real>},
+    {nullptr,                           nullptr,
+     sph_polar_pole_boundary_condition_x2i<state_real>, sph_polar_pole_boundary_condition_x2o<state_real>,
+     nullptr,                           nullptr},
+};
 
 
 void apply_boundary_condition(mesh &m){
-    standard_boundary_condition_x1i(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    standard_boundary_condition_x1i(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    standard_boundary_condition_x1o(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    standard_boundary_condition_x1o(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    periodic_boundary_condition_x2i(m.cons, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-    periodic_boundary_condition_x2i(m.prim, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-
-    periodic_boundary_condition_x2o(m.cons, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-    periodic_boundary_condition_x2o(m.prim, m.x1s, m.x1l, m.ng1,
-                                          m.x2s, m.x2l, m.ng2,
-                                          m.x3s, m.x3l, m.ng3);
-
-    reflective_boundary_condition_x3i(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    reflective_boundary_condition_x3i(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    standard_boundary_condition_x3o(m.prim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    standard_boundary_condition_x3o(m.cons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
+    for (int face = BX1I; face <= BX3O; face++){
+        if (!m.decomp.physical_face(face)){
+            continue;                       // ghost zones from the neighbouring block
+        }
+        bc_function bc = bc_table[m.modules.bc[face]][face];
+        bc(m.cons, m.x1s, m.x1l, m.ng1,
+                   m.x2s, m.x2l, m.ng2,
+                   m.x3s, m.x3l, m.ng3);
+        bc(m.prim, m.x1s, m.x1l, m.ng1,
+                   m.x2s, m.x2l, m.ng2,
+                   m.x3s, m.x3l, m.ng3);
+    }
+    #ifdef ENABLE_MPI
+    halo_exchange(m, m.cons);
+    halo_exchange(m, m.prim);
+    #endif // ENABLE_MPI
 }
-
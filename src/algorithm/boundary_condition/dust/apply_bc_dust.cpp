@@ -4,49 +4,60 @@
 #include "reflective_bc_dust.hpp"
 //#include "spherical_polar_pole_dust.hpp"
 #include "../../mesh/mesh.hpp"
+#include "../../dust/dust_floor.hpp"
+
+#ifdef ENABLE_MPI
+    #include "../../mpi/halo_exchange.hpp"
+#endif // ENABLE_MPI
+
+
+#ifdef ENABLE_DUSTFLUID
+template<typename T>
+using dust_bc_function = void (*)(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
+                                                        int &x2s, int &x2l, int &ng2,
+                                                        int &x3s, int &x3l, int &ng3);
+
+// dust boundary kernel of one face, for the two types dust has (dust_bc_x1i = standard or reflective, ...)
+// dcons and dprim may be stored in different precisions, hence one table per storage type
+template<typename T>
+static dust_bc_function<T> dust_bc_kernel(int type, int face){
+    static const dust_bc_function<T> dust_bc_standard[6] = {
+        dust_standard_boundary_condition_x1i<T>, dust_standard_boundary_condition_x1o<T>,
+        dust_standard_boundary_condition_x2i<T>, dust_standard_boundary_condition_x2o<T>,
+        dust_standard_boundary_condition_x3i<T>, dust_standard_boundary_condition_x3o<T>};
+    static const dust_bc_function<T> dust_bc_reflective[6] = {
+        dust_reflective_boundary_condition_x1i<T>, dust_reflective_boundary_condition_x1o<T>,
+        dust_reflective_boundary_condition_x2i<T>, dust_reflective_boundary_condition_x2o<T>,
+        dust_reflective_boundary_condition_x3i<T>, dust_reflective_boundary_condition_x3o<T>};
+    return (type == BC_REFLECTIVE) ? dust_bc_reflective[face] : dust_bc_standard[face];
+}
 
 
 void apply_boundary_condition_dust(mesh &m){
-    dust_standard_boundary_condition_x1i(m.dcons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    dust_standard_boundary_condition_x1i(m.dprim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    dust_standard_boundary_condition_x1o(m.dcons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    dust_standard_boundary_condition_x1o(m.dprim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    dust_reflective_boundary_condition_x2i(m.dcons, m.x1s, m.x1l, m.ng1,
-                                        m.x2s, m.x2l, m.ng2,
-                                        m.x3s, m.x3l, m.ng3);
-    dust_reflective_boundary_condition_x2i(m.dprim, m.x1s, m.x1l, m.ng1,
-                                        m.x2s, m.x2l, m.ng2,
-                                        m.x3s, m.x3l, m.ng3);
-
-    dust_reflective_boundary_condition_x2o(m.dcons, m.x1s, m.x1l, m.ng1,
-                                        m.x2s, m.x2l, m.ng2,
-                                        m.x3s, m.x3l, m.ng3);
-    dust_reflective_boundary_condition_x2o(m.dprim, m.x1s, m.x1l, m.ng1,
-                                        m.x2s, m.x2l, m.ng2,
-                                        m.x3s, m.x3l, m.ng3);
-
-    dust_reflective_boundary_condition_x3i(m.dcons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    dust_reflective_boundary_condition_x3i(m.dprim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-
-    dust_standard_boundary_condition_x3o(m.dcons, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
-    dust_standard_boundary_condition_x3o(m.dprim, m.x1s, m.x1l, m.ng1,
-                                           m.x2s, m.x2l, m.ng2,
-                                           m.x3s, m.x3l, m.ng3);
+    // species flagged by find_floor_species kept the floor in their ghost zones; they need them filled again
+    // only once grain growth has put mass into their active cells
+    int nspecies = 0;
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        if (!m.dust_floor(specIND) || !species_at_floor(m, specIND, false)){
+            m.dust_bc_species(nspecies ++) = specIND;
+        }
+    }
+    const int *species = m.dust_bc_species.get_arr();
+    for (int face = BX1I; face <= BX3O; face++){
+        if (!m.decomp.physical_face(face) && !m.decomp.domain_face(face)){
+            continue;                       // ghost zones from the neighbouring block
+        }
+        dust_bc_kernel<state_real>(m.modules.dust_bc[face], face)(m.dcons, species, nspecies, m.x1s, m.x1l, m.ng1,
+                                                                           m.x2s, m.x2l, m.ng2,
+                                                                           m.x3s, m.x3l, m.ng3);
+        dust_bc_kernel<dprim_real>(m.modules.dust_bc[face], face)(m.dprim, species, nspecies, m.x1s, m.x1l, m.ng1,
+                                                                           m.x2s, m.x2l, m.ng2,
+                                                                           m.x3s, m.x3l, m.ng3);
+    }
+    #ifdef ENABLE_MPI
+    halo_exchange(m, m.dcons.storage(), false);
+    halo_exchange(m, m.dprim.storage(), false);
+    #endif // ENABLE_MPI
 }
 
+#endif // ENABLE_DUSTFLUID
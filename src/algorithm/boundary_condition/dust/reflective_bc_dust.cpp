@@ -1,16 +1,18 @@
-#include "../../BootesArray.hpp"
+#include "../../dust/dust_array.hpp"
 #include "../../index_def.hpp"
 
 
-void dust_reflective_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x1i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind1 = 0; gind1 < ng1; gind1 ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int jj = x2s; jj < x2l; jj++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, kk, jj, x1s - 1 - gind1) = quan(specIND, IDN, kk, jj, x1s + gind1);
                     quan(specIND, IM1, kk, jj, x1s - 1 - gind1) = - quan(specIND, IM1, kk, jj, x1s + gind1);
                     quan(specIND, IM2, kk, jj, x1s - 1 - gind1) = quan(specIND, IM2, kk, jj, x1s + gind1);
@@ -22,15 +24,17 @@ void dust_reflective_boundary_condition_x1i(BootesArray<double> &quan, int &x1s,
 }
 
 
-void dust_reflective_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x1o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind1 = 0; gind1 < ng1; gind1 ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int jj = x2s; jj < x2l; jj++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, kk, jj, x1l + gind1)     = quan(specIND, IDN, kk, jj, x1l - (gind1 + 1));
                     quan(specIND, IM1, kk, jj, x1l + gind1)     = - quan(specIND, IM1, kk, jj, x1l - (gind1 + 1));
                     quan(specIND, IM2, kk, jj, x1l + gind1)     = quan(specIND, IM2, kk, jj, x1l - (gind1 + 1));
@@ -42,15 +46,17 @@ void dust_reflective_boundary_condition_x1o(BootesArray<double> &quan, int &x1s,
 }
 
 
-void dust_reflective_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x2i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind2 = 0; gind2 < ng2; gind2 ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int ii = x1s; ii < x1l; ii++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, kk, x2s - 1 - gind2, ii) = quan(specIND, IDN, kk, x2s + gind2, ii);
                     quan(specIND, IM1, kk, x2s - 1 - gind2, ii) = quan(specIND, IM1, kk, x2s + gind2, ii);
                     quan(specIND, IM2, kk, x2s - 1 - gind2, ii) = - quan(specIND, IM2, kk, x2s + gind2, ii);
@@ -62,15 +68,17 @@ void dust_reflective_boundary_condition_x2i(BootesArray<double> &quan, int &x1s,
 }
 
 
-void dust_reflective_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x2o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind2 = 0; gind2 < ng2; gind2 ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int ii = x1s; ii < x1l; ii++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, kk, x2l + gind2, ii)     = quan(specIND, IDN, kk, x2l - (gind2 + 1), ii);
                     quan(specIND, IM1, kk, x2l + gind2, ii)     = quan(specIND, IM1, kk, x2l - (gind2 + 1), ii);
                     quan(specIND, IM2, kk, x2l + gind2, ii)     = - quan(specIND, IM2, kk, x2l - (gind2 + 1), ii);
@@ -82,15 +90,17 @@ void dust_reflective_boundary_condition_x2o(BootesArray<double> &quan, int &x1s,
 }
 
 
-void dust_reflective_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x3i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind3 = 0; gind3 < ng3; gind3 ++){
             for (int jj = x2s; jj < x2l; jj++){
                 for (int ii = x1s; ii < x1l; ii++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, x3s - 1 - gind3, jj, ii) = quan(specIND, IDN, x3s + gind3, jj, ii);
                     quan(specIND, IM1, x3s - 1 - gind3, jj, ii) = quan(specIND, IM1, x3s + gind3, jj, ii);
                     quan(specIND, IM2, x3s - 1 - gind3, jj, ii) = quan(specIND, IM2, x3s + gind3, jj, ii);
@@ -102,15 +112,17 @@ void dust_reflective_boundary_condition_x3i(BootesArray<double> &quan, int &x1s,
 }
 
 
-void dust_reflective_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_reflective_boundary_condition_x3o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(4) schedule (static)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int gind3 = 0; gind3 < ng3; gind3 ++){
             for (int jj = x2s; jj < x2l; jj++){
                 for (int ii = x1s; ii < x1l; ii++){
+                    int specIND = species[sl];
                     quan(specIND, IDN, x3l + gind3, jj, ii) = quan(specIND, IDN, x3l - (gind3 + 1), jj, ii);
                     quan(specIND, IM1, x3l + gind3, jj, ii) = quan(specIND, IM1, x3l - (gind3 + 1), jj, ii);
                     quan(specIND, IM2, x3l + gind3, jj, ii) = quan(specIND, IM2, x3l - (gind3 + 1), jj, ii);
@@ -122,3 +134,16 @@ void dust_reflective_boundary_condition_x3o(BootesArray<double> &quan, int &x1s,
 }
 
 
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void dust_reflective_boundary_condition_x1i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x1o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x2i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x2o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x3i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x3o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x1i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x1o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x2i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x2o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x3i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_reflective_boundary_condition_x3o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
@@ -1,18 +1,20 @@
-#include "../../BootesArray.hpp"
+#include "../../dust/dust_array.hpp"
 #include "../../index_def.hpp"
 #include "standard_bc_dust.hpp"
 
 
-void dust_standard_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x1i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                      int &x2s, int &x2l, int &ng2,
                                                                      int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int jj = x2s; jj < x2l; jj++){
                     for (int gind1 = 0; gind1 < ng1; gind1 ++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, kk, jj, x1s - 1 - gind1) = quan(specIND, valIND, kk, jj, x1s + gind1);
                     }
                 }
@@ -22,16 +24,18 @@ void dust_standard_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, i
 }
 
 
-void dust_standard_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x1o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int jj = x2s; jj < x2l; jj++){
                     for (int gind1 = 0; gind1 < ng1; gind1 ++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, kk, jj, x1l + gind1)     = quan(specIND, valIND, kk, jj, x1l - (gind1 + 1));
                     }
                 }
@@ -41,16 +45,18 @@ void dust_standard_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, i
 }
 
 
-void dust_standard_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x2i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int gind2 = 0; gind2 < ng2; gind2 ++){
                     for (int ii = x1s; ii < x1l; ii++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, kk, x2s - 1 - gind2, ii) = quan(specIND, valIND, kk, x2s + gind2, ii);
                     }
                 }
@@ -59,16 +65,18 @@ void dust_standard_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, i
     }
 }
 
-void dust_standard_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x2o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                                      int &x2s, int &x2l, int &ng2,
                                                                      int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int kk = x3s; kk < x3l; kk++){
                 for (int gind2 = 0; gind2 < ng2; gind2 ++){
                     for (int ii = x1s; ii < x1l; ii++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, kk, x2l + gind2, ii)     = quan(specIND, valIND, kk, x2l - (gind2 + 1), ii);
                     }
                 }
@@ -78,16 +86,18 @@ void dust_standard_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, i
 }
 
 
-void dust_standard_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x3i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int gind3 = 0; gind3 < ng3; gind3 ++){
                 for (int jj = x2s; jj < x2l; jj++){
                     for (int ii = x1s; ii < x1l; ii++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, x3s - 1 - gind3, jj, ii) = quan(specIND, valIND, x3s + gind3, jj, ii);
                     }
                 }
@@ -97,16 +107,18 @@ void dust_standard_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, i
 }
 
 
-void dust_standard_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x3o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
     #pragma omp parallel for collapse(5)
-    for (int specIND = 0; specIND < quan.shape()[0]; specIND ++){
+    for (int sl = 0; sl < nspecies; sl ++){
         for (int valIND = 0; valIND < quan.shape()[1]; valIND ++){
             for (int gind3 = 0; gind3 < ng3; gind3 ++){
                 for (int jj = x2s; jj < x2l; jj++){
                     for (int ii = x1s; ii < x1l; ii++){
+                        int specIND = species[sl];
                         quan(specIND, valIND, x3l + gind3, jj, ii)     = quan(specIND, valIND, x3l - (gind3 + 1), jj, ii);
                     }
                 }
@@ -115,3 +127,17 @@ void dust_standard_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, i
     }
 }
 
+
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void dust_standard_boundary_condition_x1i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x1o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x2i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x2o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x3i<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x3o<double>(DustArray<double> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x1i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x1o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x2i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x2o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x3i<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void dust_standard_boundary_condition_x3o<float>(DustArray<float> &, const int *, int, int &, int &, int &, int &, int &, int &, int &, int &, int &);
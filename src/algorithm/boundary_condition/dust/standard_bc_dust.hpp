@@ -1,30 +1,36 @@
 #ifndef STANDARD_BC_DUST_HPP_
 #define STANDARD_BC_DUST_HPP_
-#include "../../BootesArray.hpp"
+#include "../../dust/dust_array.hpp"
 #include "../../index_def.hpp"
 
 
-void dust_standard_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x1i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
-void dust_standard_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x1o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
-void dust_standard_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x2i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
-void dust_standard_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x2o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
-void dust_standard_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x3i(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
-void dust_standard_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void dust_standard_boundary_condition_x3o(DustArray<T> &quan, const int *species, int nspecies, int &x1s, int &x1l, int &ng1,
                                                             int &x2s, int &x2l, int &ng2,
                                                             int &x3s, int &x3l, int &ng3);
 
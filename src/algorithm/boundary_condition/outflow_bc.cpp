@@ -3,7 +3,8 @@
 #include "outflow_bc.hpp"
 
 
-void outflow_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x1i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -22,7 +23,8 @@ void outflow_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
-void outflow_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x1o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -41,7 +43,8 @@ void outflow_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
-void outflow_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x2i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -60,7 +63,8 @@ void outflow_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
-void outflow_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x2o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -79,7 +83,8 @@ void outflow_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
-void outflow_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x3i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -98,7 +103,8 @@ void outflow_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
-void outflow_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void outflow_boundary_condition_x3o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -117,3 +123,16 @@ void outflow_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1
 }
 
 
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void outflow_boundary_condition_x1i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x1o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x2i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x2o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x3i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x3o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x1i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x1o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x2i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x2o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x3i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void outflow_boundary_condition_x3o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
@@ -2,7 +2,8 @@
 #include "../index_def.hpp"
 
 
-void periodic_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x1i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -17,7 +18,8 @@ void periodic_boundary_condition_x1i(BootesArray<double> &quan, int &x1s, int &x
     }
 }
 
-void periodic_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x1o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -33,7 +35,8 @@ void periodic_boundary_condition_x1o(BootesArray<double> &quan, int &x1s, int &x
 }
 
 
-void periodic_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x2i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -48,7 +51,8 @@ void periodic_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x
     }
 }
 
-void periodic_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x2o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -63,7 +67,8 @@ void periodic_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x
     }
 }
 
-void periodic_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x3i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -79,7 +84,8 @@ void periodic_boundary_condition_x3i(BootesArray<double> &quan, int &x1s, int &x
 }
 
 
-void periodic_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void periodic_boundary_condition_x3o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                               int &x2s, int &x2l, int &ng2,
                                                               int &x3s, int &x3l, int &ng3){
     #pragma omp parallel for collapse(4)
@@ -94,3 +100,17 @@ void periodic_boundary_condition_x3o(BootesArray<double> &quan, int &x1s, int &x
     }
 }
 
+
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void periodic_boundary_condition_x1i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x1o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x2i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x2o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x3i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x3o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x1i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x1o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x2i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x2o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x3i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void periodic_boundary_condition_x3o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
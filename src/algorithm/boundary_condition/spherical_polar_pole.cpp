@@ -2,7 +2,8 @@
 #include "../index_def.hpp"
 
 
-void sph_polar_pole_boundary_condition_x2i(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void sph_polar_pole_boundary_condition_x2i(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -21,7 +22,8 @@ void sph_polar_pole_boundary_condition_x2i(BootesArray<double> &quan, int &x1s,
 }
 
 
-void sph_polar_pole_boundary_condition_x2o(BootesArray<double> &quan, int &x1s, int &x1l, int &ng1,
+template<typename T>
+void sph_polar_pole_boundary_condition_x2o(BootesArray<T> &quan, int &x1s, int &x1l, int &ng1,
                                                                 int &x2s, int &x2l, int &ng2,
                                                                 int &x3s, int &x3l, int &ng3){
     // standard inflow/outflow boundary, simply copy the values from active zone to ghost zone.
@@ -39,3 +41,9 @@ void sph_polar_pole_boundary_condition_x2o(BootesArray<double> &quan, int &x1s,
     }
 }
 
+
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void sph_polar_pole_boundary_condition_x2i<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void sph_polar_pole_boundary_condition_x2o<double>(BootesArray<double> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void sph_polar_pole_boundary_condition_x2i<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
+template void sph_polar_pole_boundary_condition_x2o<float>(BootesArray<float> &, int &, int &, int &, int &, int &, int &, int &, int &, int &);
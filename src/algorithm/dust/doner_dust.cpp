@@ -28,3 +28,27 @@ void doner_cell_dust( double *valsL,
     }
 }
 
+
+
+void doner_dust_batch(int nface,
+                      double * const *valsL,
+                      double * const *valsR,
+                      double * const *fluxs,
+                      int IMP){
+    const double *mpL = valsL[IMP];
+    const double *mpR = valsR[IMP];
+    for (int ff = 0; ff < nface; ff ++){
+        double uL = mpL[ff] / valsL[IDN][ff];
+        double uR = mpR[ff] / valsR[IDN][ff];
+        for (int val_ind = 0; val_ind < 4; val_ind ++){
+            double flux_L = valsL[val_ind][ff] * uL;
+            double flux_R = valsR[val_ind][ff] * uR;
+            if      (uL >= 0 && uR >= 0){ fluxs[val_ind][ff] = flux_L; }
+            else if (uR <= 0 && uL <= 0){ fluxs[val_ind][ff] = flux_R; }
+            else if (uR >= 0 && uL <= 0){ fluxs[val_ind][ff] = 0; }
+            else{
+                fluxs[val_ind][ff] = flux_L + flux_R;
+            }
+        }
+    }
+}
@@ -8,4 +8,13 @@ void doner_cell_dust( double *valsL,
           int IMP,
           double &gamma);
 
+
+// Batched version: nface faces at once from structure-of-arrays states, valsL[var][ff] and valsR[var][ff]
+// (IDN, IM1..IM3), fluxes to fluxs[var][ff]. Gives the same fluxes as the single-face call.
+void doner_dust_batch(int nface,
+                      double * const *valsL,
+                      double * const *valsR,
+                      double * const *fluxs,
+                      int IMP);
+
 #endif // DONER_DUST_HPP_
@@ -0,0 +1,120 @@
+#ifndef DUST_ARRAY_HPP_
+#define DUST_ARRAY_HPP_
+#include <cstddef>
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+
+
+#ifdef ENABLE_DUST_CELL_MAJOR
+const bool DUST_CELL_MAJOR = true;
+#else
+const bool DUST_CELL_MAJOR = false;
+#endif // ENABLE_DUST_CELL_MAJOR
+
+
+/** Dust state indexed (species, var, z, y, x), as dcons and dprim were always indexed. By default it is also
+ *  stored in that order (species-major), so each species is a set of contiguous x1 rows. With
+ *  ENABLE_DUST_CELL_MAJOR (defs.hpp) it is stored (z, y, x, species, var): the NUMSPECIES * var values of one
+ *  cell are contiguous, which is what the per-cell species loops of grain_growth and the coupled drag read.
+ *  Kernels that go through operator(), shape() and stride() run unchanged on both layouts. Output and the
+ *  gather to rank 0 go through canonical(), which is species-major in both. The mesh arrays take the layout
+ *  of defs.hpp; CellMajor is a parameter so that a benchmark can hold both (make layout_bench). **/
+template<typename T, bool CellMajor = DUST_CELL_MAJOR>
+class DustArray {
+    public:
+    void NewDustArray(int ns, int nv, int nz, int ny, int nx){
+        shape_[0] = ns;
+        shape_[1] = nv;
+        shape_[2] = nz;
+        shape_[3] = ny;
+        shape_[4] = nx;
+        if (CellMajor){
+            // x1 rows of ns * nv values per zone, so halo_exchange sees (z, y, x) with a wider x axis
+            data_.NewBootesArray(nz, ny, nx * ns * nv);
+            stride_[0] = nv;
+            stride_[1] = 1;
+            stride_[2] = (size_t) ny * nx * ns * nv;
+            stride_[3] = (size_t) nx * ns * nv;
+            stride_[4] = (size_t) ns * nv;
+        }
+        else {
+            data_.NewBootesArray(ns, nv, nz, ny, nx);
+            stride_[4] = 1;
+            stride_[3] = nx;
+            stride_[2] = (size_t) ny * nx;
+            stride_[1] = (size_t) nz * ny * nx;
+            stride_[0] = (size_t) nv * nz * ny * nx;
+        }
+    }
+
+    inline T &operator() (const int s, const int v, const int k, const int j, const int i){
+        if (CellMajor){
+            return data_(k, j, (i * shape_[0] + s) * shape_[1] + v);
+        }
+        return data_(s, v, k, j, i);
+    }
+
+    // logical shape (species, var, z, y, x) in both layouts
+    int *shape(){
+        return shape_;
+    }
+
+    int dimension(){
+        return 5;
+    }
+
+    // elements between neighbours along logical axis 0 (species) .. 4 (x1)
+    size_t stride(int axis){
+        return stride_[axis];
+    }
+
+    bool checkallocated(){
+        return data_.checkallocated();
+    }
+
+    void set_uniform(double x){
+        data_.set_uniform(x);
+    }
+
+    // the storage itself, for halo_exchange
+    BootesArray<T> &storage(){
+        return data_;
+    }
+
+    /** species-major (species, var, z, y, x) array for output and gather_blocks. The storage itself by default;
+     *  cell-major a copy, refreshed on every call if this array holds data. The output mesh on rank 0 holds
+     *  none, so there it is the array gather_blocks fills and the output then writes. **/
+    BootesArray<T> &canonical(){
+        if (!CellMajor){
+            return data_;
+        }
+        if (data_.checkallocated()){
+            int *s = shape_;
+            if (!canon_.checkallocated()){
+                canon_.NewBootesArray(s[0], s[1], s[2], s[3], s[4]);
+            }
+            #pragma omp parallel for collapse(3) schedule (static)
+            for (int kk = 0; kk < s[2]; kk++){
+                for (int jj = 0; jj < s[3]; jj++){
+                    for (int ii = 0; ii < s[4]; ii++){
+                        for (int ss = 0; ss < s[0]; ss++){
+                            for (int vv = 0; vv < s[1]; vv++){
+                                canon_(ss, vv, kk, jj, ii) = (*this)(ss, vv, kk, jj, ii);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return canon_;
+    }
+
+    private:
+        BootesArray<T> data_;
+        BootesArray<T> canon_;          // species-major copy, cell-major only
+        int shape_[5] = {0, 0, 0, 0, 0};
+        size_t stride_[5] = {0, 0, 0, 0, 0};
+};
+
+
+#endif // DUST_ARRAY_HPP_
@@ -0,0 +1,53 @@
+#include "dust_floor.hpp"
+#include "../mesh/mesh.hpp"
+#include "../index_def.hpp"
+#include <cstddef>
+
+
+#ifdef ENABLE_DUSTFLUID
+// true if the density of species specIND is at the floor in the zones [k0, k1) x [j0, j1) x [i0, i1);
+// stops at the first zone above it, so that a populated species costs little
+static bool box_at_floor(mesh &m, int specIND, int k0, int k1, int j0, int j1, int i0, int i1){
+    state_real floor = (state_real) m.dminDensity;
+    size_t xstep = m.dcons.stride(4);
+    for (int kk = k0; kk < k1; kk++){
+        for (int jj = j0; jj < j1; jj++){
+            const state_real *rho = &m.dcons(specIND, IDN, kk, jj, i0);
+            for (int ii = 0; ii < i1 - i0; ii++){
+                if (rho[ii * xstep] > floor){
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+bool species_at_floor(mesh &m, int specIND, bool ghosts){
+    if (!box_at_floor(m, specIND, m.x3s, m.x3l, m.x2s, m.x2l, m.x1s, m.x1l)){
+        return false;
+    }
+    if (!ghosts){
+        return true;
+    }
+    return box_at_floor(m, specIND, m.x3s, m.x3l, m.x2s, m.x2l, m.x1s - m.ng1, m.x1s)
+        && box_at_floor(m, specIND, m.x3s, m.x3l, m.x2s, m.x2l, m.x1l, m.x1l + m.ng1)
+        && box_at_floor(m, specIND, m.x3s, m.x3l, m.x2s - m.ng2, m.x2s, m.x1s, m.x1l)
+        && box_at_floor(m, specIND, m.x3s, m.x3l, m.x2l, m.x2l + m.ng2, m.x1s, m.x1l)
+        && box_at_floor(m, specIND, m.x3s - m.ng3, m.x3s, m.x2s, m.x2l, m.x1s, m.x1l)
+        && box_at_floor(m, specIND, m.x3l, m.x3l + m.ng3, m.x2s, m.x2l, m.x1s, m.x1l);
+}
+
+
+void find_floor_species(mesh &m){
+    if (!m.dust_floor_skip){
+        return;
+    }
+    #pragma omp parallel for schedule (dynamic)
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        m.dust_floor(specIND) = species_at_floor(m, specIND, true);
+    }
+}
+
+#endif // ENABLE_DUSTFLUID
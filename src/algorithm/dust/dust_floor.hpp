@@ -0,0 +1,20 @@
+#ifndef DUST_FLOOR_HPP_
+#define DUST_FLOOR_HPP_
+
+class mesh;
+
+
+// true if species specIND is at the floor (dminDensity) in every active cell, and with ghosts also in the
+// ghost zones beyond the six faces of the block (the ones its fluxes read; the corners are not used)
+bool species_at_floor(mesh &m, int specIND, bool ghosts);
+
+
+/** dust_floor_skip = 1: flag (m.dust_floor) the species that are at the floor in the active cells of the block
+ *  and in the ghost zones its fluxes read. A flagged species takes no step: timestep, the fluxes, the advection,
+ *  the stopping time, the drag and the dust boundary conditions leave it alone until grain growth (or dust
+ *  coming in through the ghost zones) puts mass into it. Called at the start of every step; with
+ *  dust_floor_skip = 0 (default) nothing is flagged. **/
+void find_floor_species(mesh &m);
+
+
+#endif // DUST_FLOOR_HPP_
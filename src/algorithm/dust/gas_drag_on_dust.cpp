@@ -1,21 +1,30 @@
 #include <limits>
+#include <omp.h>
 #include "gas_drag_on_dust.hpp"
 #include "../mesh/mesh.hpp"
 #include "../index_def.hpp"
 #include "../eos/eos.hpp"
 
 
-double stoppingtime(double &rhodmsize, double &rho, double &pres, double &vth_coeff){
+#ifdef ENABLE_DUSTFLUID
+double stoppingtime(const double &rhodmsize, const double &rho, const double &pres, const double &vth_coeff){
     // cout << rhodmsize << '\t' << rhodmsize / (rho * thermalspeed(rho, pres, vth_coeff)) << endl << flush;
     return rhodmsize / (rho * thermalspeed(rho, pres, vth_coeff));
 }
 
 
 void calc_stoppingtimemesh(mesh &m, BootesArray<double> &stoppingtimemesh){
-    #pragma omp parallel for collapse (4)
+    // nothing drags the species at the floor (find_floor_species), but grain growth gives their floor cells the
+    // terminal velocity, so they only go without a stopping time when there is no grain growth
+    #pragma omp parallel for collapse (3)
     for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
         for (int kk = m.x3s; kk < m.x3l; kk ++){
             for (int jj = m.x2s; jj < m.x2l; jj ++){
+                #ifndef ENABLE_DUST_GRAINGROWTH
+                if (m.dust_floor(specIND)){
+                    continue;
+                }
+                #endif // ENABLE_DUST_GRAINGROWTH
                 for (int ii = m.x1s; ii < m.x1l; ii ++){
                     stoppingtimemesh(specIND, kk, jj, ii) = stoppingtime(m.GrainSizeTimesGrainDensity(specIND), m.prim(IDN, kk, jj, ii), m.prim(IPN, kk, jj, ii), m.vth_coeff);
                 }
@@ -39,3 +48,90 @@ double find_smallest_stoppingtime(mesh &m, BootesArray<double> &stoppingtimemesh
     }
     return minstoppingtime;
 }
+
+
+// dust_drag = implicit with feedback: dust_drag_implicit_row on every x1 row, with the rows of m.drag_work as its workspace
+static void dust_gas_drag_implicit(mesh &m, double &dt, BootesArray<double> &stoppingtimemesh){
+    // time step of each species in this substep, 0 for the species that are done
+    BootesArray<double> dts;
+    dts.NewBootesArray(m.NUMSPECIES);
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        dts(specIND) = (m.dust_nsub(specIND) > m.dust_substep) ? dt / m.dust_nsub(specIND) : 0.0;
+    }
+    size_t tstride = (size_t) stoppingtimemesh.shape()[1] * stoppingtimemesh.shape()[2] * stoppingtimemesh.shape()[3];
+    #pragma omp parallel for collapse (2) schedule (static)
+    for (int kk = m.x3s; kk < m.x3l; kk ++){
+        for (int jj = m.x2s; jj < m.x2l; jj ++){
+            double *work = &m.drag_work(omp_get_thread_num(), 0, 0);
+            double *accel[3] = {&m.drag_work(omp_get_thread_num(), 8, 0), &m.drag_work(omp_get_thread_num(), 9, 0), &m.drag_work(omp_get_thread_num(), 10, 0)};
+            for (int ii = m.x1s; ii < m.x1l; ii ++){
+                // gravitational acceleration, the same for every species
+                #ifdef ENABLE_GRAVITY
+                accel[0][ii - m.x1s] = (m.grav->Phi_grav_x1surface(kk, jj, ii + 1) - m.grav->Phi_grav_x1surface(kk, jj, ii)) / m.dx1p(kk, jj, ii);
+                accel[1][ii - m.x1s] = (m.grav->Phi_grav_x2surface(kk, jj + 1, ii) - m.grav->Phi_grav_x2surface(kk, jj, ii)) / m.dx2p(kk, jj, ii);
+                accel[2][ii - m.x1s] = (m.grav->Phi_grav_x3surface(kk + 1, jj, ii) - m.grav->Phi_grav_x3surface(kk, jj, ii)) / m.dx3p(kk, jj, ii);
+                #else
+                accel[0][ii - m.x1s] = accel[1][ii - m.x1s] = accel[2][ii - m.x1s] = 0;
+                #endif // ENABLE_GRAVITY
+            }
+            state_real *gas[5] = {&m.cons(IDN, kk, jj, m.x1s), &m.cons(IM1, kk, jj, m.x1s), &m.cons(IM2, kk, jj, m.x1s),
+                                  &m.cons(IM3, kk, jj, m.x1s), &m.cons(IEN, kk, jj, m.x1s)};
+            dust_drag_implicit_row(m.nx1, m.NUMSPECIES, m.dminDensity, gas, &m.dcons(0, IDN, kk, jj, m.x1s), m.dcons.stride(0), m.dcons.stride(1), m.dcons.stride(4),
+                                   &stoppingtimemesh(0, kk, jj, m.x1s), tstride, dts.get_arr(), accel, work);
+        }
+    }
+}
+
+
+void dust_gas_drag(mesh &m, double &dt, BootesArray<double> &stoppingtimemesh){
+    if (m.modules.dust_drag == DRAG_IMPLICIT){
+        dust_gas_drag_implicit(m, dt, stoppingtimemesh);
+        return;
+    }
+    #pragma omp parallel for collapse (3) schedule (static)
+    for (int kk = m.x3s; kk < m.x3l; kk ++){
+        for (int jj = m.x2s; jj < m.x2l; jj ++){
+            for (int ii = m.x1s; ii < m.x1l; ii ++){
+                // gravitational acceleration, the same for every species
+                double gradphi[3] = {0, 0, 0};
+                #ifdef ENABLE_GRAVITY
+                gradphi[0] = (m.grav->Phi_grav_x1surface(kk, jj, ii + 1) - m.grav->Phi_grav_x1surface(kk, jj, ii)) / m.dx1p(kk, jj, ii);
+                gradphi[1] = (m.grav->Phi_grav_x2surface(kk, jj + 1, ii) - m.grav->Phi_grav_x2surface(kk, jj, ii)) / m.dx2p(kk, jj, ii);
+                gradphi[2] = (m.grav->Phi_grav_x3surface(kk + 1, jj, ii) - m.grav->Phi_grav_x3surface(kk, jj, ii)) / m.dx3p(kk, jj, ii);
+                #endif // ENABLE_GRAVITY
+                double rhog = m.cons(IDN, kk, jj, ii);
+                double vg[3] = {m.cons(IM1, kk, jj, ii) / rhog, m.cons(IM2, kk, jj, ii) / rhog, m.cons(IM3, kk, jj, ii) / rhog};
+                double dmom[3] = {0, 0, 0};
+                double dkin = 0;
+                for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+                    double rhod = m.dcons(specIND, IDN, kk, jj, ii);
+                    // species done with its substeps, or at the floor (terminal velocity set in advect_cons_dust)
+                    if (m.dust_nsub(specIND) <= m.dust_substep || rhod <= m.dminDensity){
+                        continue;
+                    }
+                    double dts = dt / m.dust_nsub(specIND);
+                    double pd[3], pnodrag[3];
+                    for (int dd = 0; dd < 3; dd++){
+                        pd[dd] = m.dcons(specIND, IM1 + dd, kk, jj, ii);
+                        pnodrag[dd] = pd[dd] + rhod * gradphi[dd] * dts;
+                    }
+                    double eps = rhod / rhog;
+                    dust_drag_exponential(vg, eps, rhod, stoppingtimemesh(specIND, kk, jj, ii), dts, gradphi, pd);
+                    for (int dd = 0; dd < 3; dd++){
+                        double drag = pd[dd] - pnodrag[dd];
+                        dmom[dd] += drag;
+                        dkin += 0.5 * (pd[dd] * pd[dd] - pnodrag[dd] * pnodrag[dd]) / rhod;
+                        vg[dd] -= drag / rhog;          // the next species sees the gas this one has dragged
+                        m.dcons(specIND, IM1 + dd, kk, jj, ii) = pd[dd];
+                    }
+                }
+                m.cons(IM1, kk, jj, ii) -= dmom[0];
+                m.cons(IM2, kk, jj, ii) -= dmom[1];
+                m.cons(IM3, kk, jj, ii) -= dmom[2];
+                m.cons(IEN, kk, jj, ii) -= dkin;
+            }
+        }
+    }
+}
+
+#endif // ENABLE_DUSTFLUID
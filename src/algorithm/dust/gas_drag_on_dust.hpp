@@ -1,11 +1,12 @@
 #ifndef GAS_DRAG_ON_DUST_HPP_
 #define GAS_DRAG_ON_DUST_HPP_
 #include "../BootesArray.hpp"
+#include <cmath>
 
 class mesh;
 
 
-double stoppingtime(double &rhodmsize, double &rho, double &pres, double &vth_coeff);
+double stoppingtime(const double &rhodmsize, const double &rho, const double &pres, const double &vth_coeff);
 
 
 void calc_stoppingtimemesh(mesh &m, BootesArray<double> &stoppingtimemesh);
@@ -14,5 +15,170 @@ void calc_stoppingtimemesh(mesh &m, BootesArray<double> &stoppingtimemesh);
 double find_smallest_stoppingtime(mesh &m, BootesArray<double> &stoppingtimemesh);
 
 
+/** exact drag between one dust species and the gas over dt (dust_drag = exponential), stable for any ts / dt.
+ *  pd: dust momentum, replaced by the one at the end of dt; accel: acceleration of the dust by other forces
+ *  (gravity, constant over dt). The relative velocity decays as exp(-(1 + eps) dt / ts) towards its terminal
+ *  value and the centre of mass is accelerated by the force on the dust, where eps = rhod / rhog if the gas feels the drag and 0 if it does not (vg is then
+ *  held fixed). With eps = 0 and ts << dt this is the terminal velocity approximation. **/
+inline void dust_drag_exponential(const double vg[3], const double &eps, const double &rhod, const double &ts,
+                                  const double &dt, const double accel[3], double pd[3]){
+    double k     = (1.0 + eps) / ts;
+    double decay = std::exp(-k * dt);
+    double grow  = -std::expm1(-k * dt);        // 1 - decay, accurate for dt << ts
+    for (int dd = 0; dd < 3; dd++){
+        double vd  = pd[dd] / rhod;
+        double rel = (vd - vg[dd]) * decay + accel[dd] / k * grow;
+        double com = (vg[dd] + eps * vd) / (1.0 + eps) + eps / (1.0 + eps) * accel[dd] * dt;
+        pd[dd] = rhod * (com + rel / (1.0 + eps));
+    }
+}
+
+
+/** dust_drag = implicit without feedback: backward Euler drag of one species against the gas held fixed,
+ *  vd' = (vd + a dt + k vg) / (1 + k) with k = dt / ts. pd and accel as in dust_drag_exponential. **/
+inline void dust_drag_implicit(const double vg[3], const double &rhod, const double &ts, const double &dt,
+                               const double accel[3], double pd[3]){
+    double k = dt / ts;
+    for (int dd = 0; dd < 3; dd++){
+        pd[dd] = rhod * (pd[dd] / rhod + accel[dd] * dt + k * vg[dd]) / (1.0 + k);
+    }
+}
+
+
+/** dust_drag = implicit with feedback: backward Euler drag of every species of a row of n cells, coupled through the gas.
+ *  Each species only talks to the gas, so the NUMSPECIES + 1 system has a closed-form inverse: with
+ *  k_s = dt_s / ts_s and w_s = rhod_s k_s / (1 + k_s),
+ *      vg' = (rhog vg + sum_s w_s (vd_s + a dt_s)) / (rhog + sum_s w_s),   vd_s' = (vd_s + a dt_s + k_s vg') / (1 + k_s),
+ *  two sweeps over the species per cell. The gas takes the momentum and the
+ *  kinetic energy the drag removes from the dust, so momentum is conserved to round-off and the update is
+ *  stable for any dt / ts and dust to gas ratio.
+ *  gas[0..4]: rows of density, the three momenta and the energy; dust + s * sstride + c * cstride + i * xstride:
+ *  component c (density, momenta) of species s in cell i (the strides of DustArray, so either dust layout);
+ *  ts + s * tstride: row of its stopping time; dts[s]: its time
+ *  step, 0 if it does not move; accel[3]: rows of the acceleration by other forces; work: 8 * n doubles.
+ *  Cells where a species is at or below floor are left alone. **/
+template<typename T>
+inline void dust_drag_implicit_row(int n, int NS, double floor, T *const gas[5],
+                                   T *dust, size_t sstride, size_t cstride, size_t xstride, const double *ts, size_t tstride,
+                                   const double *dts, const double *const accel[3], double *work){
+    if (xstride != 1){
+        // cell-major dust: the species of a cell are contiguous, so go cell by cell (same sums in the same order)
+        for (int ii = 0; ii < n; ii++){
+            T *cell = dust + ii * xstride;
+            double den = gas[0][ii];
+            double vg[3] = {gas[1][ii], gas[2][ii], gas[3][ii]};
+            for (int ss = 0; ss < NS; ss++){
+                const T *sp = cell + ss * sstride;
+                if (dts[ss] <= 0 || !(sp[0] > floor)){
+                    continue;
+                }
+                double k = dts[ss] / ts[ss * tstride + ii];
+                double w = sp[0] * k / (1.0 + k);
+                den += w;
+                for (int dd = 0; dd < 3; dd++){
+                    vg[dd] += w * (sp[(1 + dd) * cstride] * (1.0 / sp[0]) + accel[dd][ii] * dts[ss]);
+                }
+            }
+            double dmom[3] = {0, 0, 0};
+            double dkin = 0;
+            for (int dd = 0; dd < 3; dd++){
+                vg[dd] /= den;
+            }
+            for (int ss = 0; ss < NS; ss++){
+                T *sp = cell + ss * sstride;
+                if (dts[ss] <= 0 || !(sp[0] > floor)){
+                    continue;
+                }
+                double rho = sp[0];
+                double k = dts[ss] / ts[ss * tstride + ii];
+                for (int dd = 0; dd < 3; dd++){
+                    double v0 = sp[(1 + dd) * cstride] / rho + accel[dd][ii] * dts[ss];
+                    double v1 = (v0 + k * vg[dd]) / (1.0 + k);
+                    dmom[dd] += rho * (v1 - v0);
+                    dkin += 0.5 * rho * (v1 * v1 - v0 * v0);
+                    sp[(1 + dd) * cstride] = rho * v1;
+                }
+            }
+            for (int dd = 0; dd < 3; dd++){
+                gas[1 + dd][ii] -= dmom[dd];
+            }
+            gas[4][ii] -= dkin;
+        }
+        return;
+    }
+    double *den  = work;            // rhog + sum_s w_s
+    double *vg   = work + n;        // (3, n) gas momentum plus the dust terms, then vg'
+    double *dmom = work + 4 * n;    // (3, n) momentum given to the dust
+    double *dkin = work + 7 * n;    // kinetic energy given to the dust
+    for (int ii = 0; ii < n; ii++){
+        den[ii] = gas[0][ii];
+        dkin[ii] = 0;
+    }
+    for (int dd = 0; dd < 3; dd++){
+        for (int ii = 0; ii < n; ii++){
+            vg[dd * n + ii] = gas[1 + dd][ii];
+            dmom[dd * n + ii] = 0;
+        }
+    }
+    for (int ss = 0; ss < NS; ss++){
+        if (dts[ss] <= 0){
+            continue;
+        }
+        const T *rhod = dust + ss * sstride;
+        const double *tss = ts + ss * tstride;
+        for (int ii = 0; ii < n; ii++){
+            bool on = rhod[ii * xstride] > floor;
+            double k = dts[ss] / tss[ii];
+            double w = on ? rhod[ii * xstride] * k / (1.0 + k) : 0.0;
+            double inv = on ? 1.0 / rhod[ii * xstride] : 0.0;
+            den[ii] += w;
+            for (int dd = 0; dd < 3; dd++){
+                vg[dd * n + ii] += w * (rhod[(1 + dd) * cstride + ii * xstride] * inv + accel[dd][ii] * dts[ss]);
+            }
+        }
+    }
+    for (int dd = 0; dd < 3; dd++){
+        for (int ii = 0; ii < n; ii++){
+            vg[dd * n + ii] /= den[ii];
+        }
+    }
+    for (int ss = 0; ss < NS; ss++){
+        if (dts[ss] <= 0){
+            continue;
+        }
+        T *rhod = dust + ss * sstride;
+        const double *tss = ts + ss * tstride;
+        for (int ii = 0; ii < n; ii++){
+            if (!(rhod[ii * xstride] > floor)){
+                continue;
+            }
+            double rho = rhod[ii * xstride];
+            double k = dts[ss] / tss[ii];
+            for (int dd = 0; dd < 3; dd++){
+                double v0 = rhod[(1 + dd) * cstride + ii * xstride] / rho + accel[dd][ii] * dts[ss];
+                double v1 = (v0 + k * vg[dd * n + ii]) / (1.0 + k);
+                dmom[dd * n + ii] += rho * (v1 - v0);
+                dkin[ii] += 0.5 * rho * (v1 * v1 - v0 * v0);
+                rhod[(1 + dd) * cstride + ii * xstride] = rho * v1;
+            }
+        }
+    }
+    for (int ii = 0; ii < n; ii++){
+        for (int dd = 0; dd < 3; dd++){
+            gas[1 + dd][ii] -= dmom[dd * n + ii];
+        }
+        gas[4][ii] -= dkin[ii];
+    }
+}
+
+
+/** dust_feedback = on: drag (and gravity) of the dust species that move in this substep, with the equal and
+ *  opposite momentum and the kinetic energy the drag takes from the dust given to the gas. dust_drag =
+ *  exponential couples the species of a cell to the gas one after the other with the exact two-fluid solution;
+ *  dust_drag = implicit couples them all at once with dust_drag_implicit_row, one x1 row at a time. Both
+ *  conserve momentum and are stable for any dust to gas ratio. **/
+void dust_gas_drag(mesh &m, double &dt, BootesArray<double> &stoppingtimemesh);
+
+
 #endif // GAS_DRAG_ON_DUST_HPP_
 
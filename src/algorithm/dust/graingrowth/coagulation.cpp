@@ -6,191 +6,356 @@
 #include "../../../defs.hpp"
 #include "../terminalvel.hpp"
 #include <cmath>
+#include <omp.h>
+#include <limits>
 
-void grain_growth_one_cell(BootesArray<double> &num,
-                           BootesArray<double> &vr, BootesArray<double> &vtheta, BootesArray<double> &vphi,
-                           BootesArray<double> &grain_size_list, BootesArray<double> &grain_mass_list, double dt){
-    int NUM_SPECIES = num.shape()[0];
-    double dt_here = dt;
-    BootesArray<double> num_here; num_here.NewBootesArray(NUM_SPECIES);
-    for (int i = 0; i < NUM_SPECIES; i++){num_here(i) = num(i);}
-    bool redo = true;
-    double dt_tot = 0;
-    while (redo || dt_tot < dt)
-    {
-        redo = false;   // set it to false first
-        BootesArray<double> Mmat; Mmat.NewBootesArray(NUM_SPECIES);         // initialize with 0s
-
-        for (int k = 0; k < NUM_SPECIES; k++){
-            Mmat(k) = 0;
-        }
-        for (int j = 0; j < NUM_SPECIES; ++ j){
-            for (int k = j; k < NUM_SPECIES; ++ k){
-                double dv_bulk = sqrt(pow((vr(j) - vr(k)), 2) + pow((vtheta(j) - vtheta(k)), 2) + pow((vphi(j) - vphi(k)), 2));
-                // double dv_vortex = dv_ormel(grain_size_list(j), grain_size_list(k), rhogas, tempgas);
-                double dv = dv_bulk;
-
-                double KL1[2];                  //K1 = KL1[0], L1 = KL1[1]
-                double KL2[2];
-                grain_growth_model_stick(grain_size_list(j), grain_size_list(k), dv, KL1);
-                grain_growth_model_stick(grain_size_list(k), grain_size_list(j), dv, KL2);
-
-                // replace the for statement here with new method, use V1.8's for if needed
-                // gain via coagulation
-                double numjtimesnumk = num_here(j) * num_here(k);
-                int cog_res = 0;        // the following loop is equivalent to searchsorted in numpy
-                while (cog_res < NUM_SPECIES){
-                    if (grain_mass_list(cog_res) >= (grain_mass_list(j) + grain_mass_list(k))){
-                        break;
-                    }
-                    cog_res += 1;
-                }
-                if (j == k){
-                    if (cog_res == NUM_SPECIES){
-                        Mmat(cog_res - 1) += 0.5 * (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res - 1) * numjtimesnumk;
-                    }
-                    else{
-                        double eps = (grain_mass_list(j) + grain_mass_list(k) - grain_mass_list(cog_res - 1)) / (grain_mass_list(cog_res) - grain_mass_list(cog_res - 1));
-                        Mmat(cog_res)     += 0.5 * (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res) * numjtimesnumk * eps;
-                        Mmat(cog_res - 1) += 0.5 * (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res - 1) * numjtimesnumk * (1.0 - eps);
-                    }
-                }
-                else{
-                    if (cog_res == NUM_SPECIES){
-                        Mmat(cog_res - 1) += (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res - 1)* numjtimesnumk;
-                    }
-                    else{
-                        double eps =  (grain_mass_list(j) + grain_mass_list(k) - grain_mass_list(cog_res - 1)) / (grain_mass_list(cog_res) - grain_mass_list(cog_res - 1));
-                        Mmat(cog_res)     += (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res)* numjtimesnumk * eps;
-                        Mmat(cog_res - 1) += (KL1[0] * grain_mass_list(k) + KL2[0] * grain_mass_list(j)) / grain_mass_list(cog_res - 1)* numjtimesnumk * (1.0 - eps);
-                    }
-                }
-                // gain via fragmentation
-                Mmat(0) += KL1[1] * grain_mass_list(k) / grain_mass_list(0) * numjtimesnumk;
-                Mmat(0) += KL2[1] * grain_mass_list(j) / grain_mass_list(0) * numjtimesnumk;
-                // lost via coagulation and fragmentation
-                Mmat(k) -= (KL1[0] + KL1[1]) * numjtimesnumk;
-                if (k != j){
-                    Mmat(j) -= (KL2[0] + KL2[1]) * numjtimesnumk;
-                }
-                // replacement complete
-                if (isnan(Mmat(0))){
-                    cout << "0 problem \n";
-                    cout << KL1[0] << '\t' << KL1[1] << '\t' << KL2[0] << '\t' << KL2[1] << '\t' << grain_size_list(j) << '\t' << grain_size_list(k) << '\t'
-                         << vr(j) << '\t' << vr(k) << '\t' <<  vtheta(j) << '\t' << vtheta(k) << '\t' <<  vphi(j) << '\t' << vphi(k) << '\n';
-                    throw 1;
-                }
-                if (isnan(Mmat(j))){
-                    cout << "j problem \n";
-                    cout << KL1[0] << '\t' << KL1[1] << '\t' << KL2[0] << '\t' << KL2[1] << '\t' << grain_size_list(j) << '\t' << grain_size_list(k) << '\t' << dv << '\n';
-                    throw 1;
-                }
-                if (isnan(Mmat(k))){
-                    cout << "k problem \n";
-                    cout << KL1[0] << '\t' << KL1[1] << '\t' << KL2[0] << '\t' << KL2[1] << '\t' << grain_size_list(j) << '\t' << grain_size_list(k) << '\t' << dv << '\n';
-                    throw 1;
-                }
+
+#if defined (ENABLE_DUSTFLUID) && defined (ENABLE_DUST_GRAINGROWTH)
+
+
+// rejected substeps in a row before grain_growth gives up on a cell
+const int COAG_MAX_REJECTED = 1000;
+// steps between two passes over all cells, dormant ones included
+const int COAG_RECHECK = 10;
+
+
+void setup_grain_growth(mesh &m){
+    // the merger of j and k (mass m_j + m_k) is shared between the two bins around it, conserving mass:
+    // eps of it goes to the first bin with m >= m_j + m_k, 1 - eps to the bin below; above the largest bin
+    // it all goes to the largest. The searchsorted scan and the divisions are done here once, not per cell.
+    int NUM_SPECIES = m.NUMSPECIES;
+    m.coag_lo.NewBootesArray(NUM_SPECIES, NUM_SPECIES);
+    m.coag_hi.NewBootesArray(NUM_SPECIES, NUM_SPECIES);
+    m.coag_wlo.NewBootesArray(NUM_SPECIES, NUM_SPECIES);
+    m.coag_whi.NewBootesArray(NUM_SPECIES, NUM_SPECIES);
+    for (int j = 0; j < NUM_SPECIES; ++ j){
+        for (int k = 0; k < NUM_SPECIES; ++ k){
+            double mass_sum = m.GrainPairMassSum(j, k);
+            double pair_weight = (j == k) ? 0.5 : 1.0;      // a pair of the same species is counted once
+            int cog_res = 0;
+            while (cog_res < NUM_SPECIES && m.GrainMassList(cog_res) < mass_sum){
+                cog_res += 1;
+            }
+            if (cog_res == NUM_SPECIES){
+                m.coag_lo(j, k)  = NUM_SPECIES - 1;
+                m.coag_hi(j, k)  = NUM_SPECIES - 1;
+                m.coag_wlo(j, k) = pair_weight / m.GrainMassList(NUM_SPECIES - 1);
+                m.coag_whi(j, k) = 0;
             }
+            else {
+                double eps = (mass_sum - m.GrainMassList(cog_res - 1)) / (m.GrainMassList(cog_res) - m.GrainMassList(cog_res - 1));
+                m.coag_lo(j, k)  = cog_res - 1;
+                m.coag_hi(j, k)  = cog_res;
+                m.coag_wlo(j, k) = pair_weight * (1.0 - eps) / m.GrainMassList(cog_res - 1);
+                m.coag_whi(j, k) = pair_weight * eps / m.GrainMassList(cog_res);
+            }
+        }
+    }
+    // number density and three velocities of one cell, and the work of grain_growth_one_cell, for each thread
+    m.coag_work.NewBootesArray(omp_get_max_threads(), 9 + 2 * NUM_SPECIES, NUM_SPECIES);
+    m.coag_substeps.NewBootesArray(m.x3v.shape()[0], m.x2v.shape()[0], m.x1v.shape()[0]);
+    m.coag_substeps.set_uniform(0.0);
+    m.coag_rate.NewBootesArray(m.x3v.shape()[0], m.x2v.shape()[0], m.x1v.shape()[0]);
+    m.coag_rate.set_uniform(0.0);
+    m.coag_active.NewBootesArray(m.nx3 * m.nx2 * m.nx1);
+    m.coag_cells.NewBootesArray(m.nx3 * m.nx2 * m.nx1);
+}
+
+
+// collision rates of every pair (j, k >= j) of one cell: K in row j of kernel, L in row j of frag. They depend
+// only on the velocities, so they are computed once per cell and reused by every substep.
+static void collision_rates(mesh &m, const double *vr, const double *vtheta, const double *vphi, double *kernel, double *frag){
+    int NUM_SPECIES = m.NUMSPECIES;
+    for (int j = 0; j < NUM_SPECIES; ++ j){
+        const double * __restrict sigma    = m.GrainPairCrossSection.get_arr() + j * NUM_SPECIES;
+        const double * __restrict mass_sum = m.GrainPairMassSum.get_arr() + j * NUM_SPECIES;
+        double * __restrict kernel_j = kernel + j * NUM_SPECIES;
+        double * __restrict frag_j   = frag + j * NUM_SPECIES;
+        #pragma omp simd
+        for (int k = j; k < NUM_SPECIES; ++ k){
+            double dv1 = vr[j] - vr[k];
+            double dv2 = vtheta[j] - vtheta[k];
+            double dv3 = vphi[j] - vphi[k];
+            double dv_bulk = sqrt(dv1 * dv1 + dv2 * dv2 + dv3 * dv3);
+            // double dv_vortex = dv_ormel(grain_size_list(j), grain_size_list(k), rhogas, tempgas);
+            double dv = dv_bulk;
+
+            double KL[2];                   // K = KL[0], L = KL[1], the same for (j, k) and (k, j)
+            grain_growth_model_stick(sigma[k], mass_sum[k], dv, KL);
+            kernel_j[k] = KL[0];
+            frag_j[k]   = KL[1];
+        }
+    }
+}
+
+
+// dn/dt of one cell for the number densities num; gain is scratch of NUMSPECIES
+static void coagulation_rates(mesh &m, const double *num, const double *kernel, const double *frag, double *rate, double *gain){
+    int NUM_SPECIES = m.NUMSPECIES;
+    const double *mass = m.GrainMassList.get_arr();
+    for (int k = 0; k < NUM_SPECIES; k++){
+        rate[k] = 0;
+    }
+    for (int j = 0; j < NUM_SPECIES; ++ j){
+        const double * __restrict mass_sum = m.GrainPairMassSum.get_arr() + j * NUM_SPECIES;
+        const double * __restrict kernel_j = kernel + j * NUM_SPECIES;
+        const double * __restrict frag_j   = frag + j * NUM_SPECIES;
+        double * __restrict rate_r = rate;
+        double * __restrict gain_r = gain;
+        double frag_mass = 0;       // mass fragmented into the smallest bin by pairs (j, k >= j)
+        double loss_j = 0;          // j grains lost to pairs (j, k > j)
+        #pragma omp simd reduction(+:frag_mass, loss_j)
+        for (int k = j; k < NUM_SPECIES; ++ k){
+            double numjtimesnumk = num[j] * num[k];
+            // gain via coagulation: merged mass, put into its bins below
+            gain_r[k] = kernel_j[k] * mass_sum[k] * numjtimesnumk;
+            // gain via fragmentation
+            frag_mass += frag_j[k] * mass_sum[k] * numjtimesnumk;
+            // lost via coagulation and fragmentation
+            rate_r[k] -= (kernel_j[k] + frag_j[k]) * numjtimesnumk;
+            loss_j    += (k != j) ? (kernel_j[k] + frag_j[k]) * numjtimesnumk : 0.0;
+        }
+        rate[j] -= loss_j;
+        rate[0] += frag_mass / mass[0];
+        const int    *lo  = m.coag_lo.get_arr()  + j * NUM_SPECIES;
+        const int    *hi  = m.coag_hi.get_arr()  + j * NUM_SPECIES;
+        const double *wlo = m.coag_wlo.get_arr() + j * NUM_SPECIES;
+        const double *whi = m.coag_whi.get_arr() + j * NUM_SPECIES;
+        for (int k = j; k < NUM_SPECIES; ++ k){
+            rate[lo[k]] += gain[k] * wlo[k];
+            rate[hi[k]] += gain[k] * whi[k];
+        }
+    }
+}
+
+
+/** integrate the coagulation equation of one cell over dt; num (number densities) is updated in place and
+ *  the number of substeps is returned. work holds (5 + 2 * NUMSPECIES) * NUMSPECIES doubles. moved_fraction:
+ *  dust mass fraction a single Euler step over dt would move, an estimate of the coagulation activity.
+ *  The rates conserve the dust mass sum(m_i n_i) exactly, so the scheme never clips a density: a substep
+ *  that would make one negative is rejected and retried shorter. First a forward Euler step over the whole
+ *  dt is tried; it is kept if it moves less than coag_tol of the dust mass, whose error is then of order
+ *  coag_tol^2 (cells with low rates, one rate evaluation). Otherwise the cell subcycles with Heun steps
+ *  (embedded Euler for the error estimate), keeping the mass moved by the difference of the two below
+ *  coag_tol of the dust mass per substep. **/
+static int grain_growth_one_cell(mesh &m, double *num, const double *vr, const double *vtheta, const double *vphi,
+                                 double *work, double dt, double &moved_fraction){
+    int NUM_SPECIES = m.NUMSPECIES;
+    const double *mass = m.GrainMassList.get_arr();
+    double *k1     = work;
+    double *k2     = work + NUM_SPECIES;
+    double *euler  = work + 2 * NUM_SPECIES;
+    double *heun   = work + 3 * NUM_SPECIES;
+    double *gain   = work + 4 * NUM_SPECIES;
+    double *kernel = work + 5 * NUM_SPECIES;
+    double *frag   = kernel + NUM_SPECIES * NUM_SPECIES;
+
+    double rho_dust = 0;
+    for (int i = 0; i < NUM_SPECIES; ++ i){
+        rho_dust += mass[i] * num[i];
+    }
+    moved_fraction = 0;
+    if (!(rho_dust > 0)){
+        return 0;
+    }
+    collision_rates(m, vr, vtheta, vphi, kernel, frag);
+    coagulation_rates(m, num, kernel, frag, k1, gain);
+
+    // cheap path: one Euler step
+    double moved = 0;
+    bool positive = true;
+    for (int i = 0; i < NUM_SPECIES; ++ i){
+        euler[i] = num[i] + dt * k1[i];
+        moved += mass[i] * fabs(dt * k1[i]);
+        positive = positive && (euler[i] >= 0);
+    }
+    moved_fraction = moved / rho_dust;
+    if (positive && moved <= m.coag_tol * rho_dust){
+        for (int i = 0; i < NUM_SPECIES; ++ i){
+            num[i] = euler[i];
+        }
+        return 1;
+    }
+
+    // adaptive Heun-Euler substeps; the first one is sized so that Euler would move coag_tol of the mass
+    double t = 0;
+    double h = m.coag_tol * rho_dust / moved * dt;
+    int substeps = 0;
+    int rejected = 0;
+    while (t < dt){
+        bool last = (h >= dt - t);
+        if (last){
+            h = dt - t;
         }
-        dt_tot += dt_here;
         for (int i = 0; i < NUM_SPECIES; ++ i){
-            num_here(i) += Mmat(i) * dt_here;
-            if (num_here(i) < 0)
-            {
-                num_here(i) = 0;
-            }
+            euler[i] = num[i] + h * k1[i];
         }
+        coagulation_rates(m, euler, kernel, frag, k2, gain);
+        double err = 0;
+        positive = true;
         for (int i = 0; i < NUM_SPECIES; ++ i){
-            if (isnan(num_here(i))){
-                for (int i = 0; i < NUM_SPECIES; ++ i){
-                    cout << num(i) << '\t';
-                }
-                cout << '\n';
+            heun[i] = num[i] + 0.5 * h * (k1[i] + k2[i]);
+            err += mass[i] * fabs(0.5 * h * (k2[i] - k1[i]));
+            positive = positive && (heun[i] >= 0);
+        }
+        err /= m.coag_tol * rho_dust;
+        if (!positive || err > 1.0){
+            // rejected, retry shorter (k1 still holds the rates at num)
+            rejected += 1;
+            if (rejected > COAG_MAX_REJECTED){
+                cout << "grain growth: " << rejected << " substeps rejected in a row at t = " << t << " of dt = " << dt << '\n';
                 for (int i = 0; i < NUM_SPECIES; ++ i){
-                    cout << Mmat(i) << '\t';
+                    cout << num[i] << '\t';
                 }
-                cout << '\n';
-                cout << "END END END" << '\n';
+                cout << '\n' << flush;
                 throw 1;
             }
+            h *= positive ? max(0.2, 0.9 / sqrt(err)) : 0.25;
+            continue;
+        }
+        for (int i = 0; i < NUM_SPECIES; ++ i){
+            num[i] = heun[i];
+        }
+        rejected = 0;
+        t = last ? dt : t + h;
+        substeps += 1;
+        h *= (err > 0) ? min(4.0, 0.9 / sqrt(err)) : 4.0;
+        if (t < dt){
+            coagulation_rates(m, num, kernel, frag, k1, gain);
         }
-        //cout << dt_tot << '\t' << min_dt << '\t' << dt << '\n' << flush;
     }
-    for (int i = 0; i < NUM_SPECIES; i++){num(i) = num_here(i);}
+    return substeps;
 }
 
 
-void grain_growth(mesh &m, BootesArray<double> &stoppingtimemesh, double &dt){
-	#pragma omp parallel for collapse (3) schedule(dynamic)
-	for (int kk = m.x3s; kk < m.x3l; kk ++){
+// dust density of a cell and the spread of its species velocities, |max - min| of each component
+static void dust_density_and_spread(mesh &m, int kk, int jj, int ii, double &rho_dust, double &dv_spread){
+    rho_dust = 0;
+    double vmin[3], vmax[3];
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        double rho = m.dcons(specIND, IDN, kk, jj, ii);
+        rho_dust += rho;
+        for (int dd = 0; dd < 3; dd ++){
+            double vel = m.dcons(specIND, IM1 + dd, kk, jj, ii) / rho;
+            vmin[dd] = (specIND == 0) ? vel : min(vmin[dd], vel);
+            vmax[dd] = (specIND == 0) ? vel : max(vmax[dd], vel);
+        }
+    }
+    dv_spread = sqrt((vmax[0] - vmin[0]) * (vmax[0] - vmin[0]) + (vmax[1] - vmin[1]) * (vmax[1] - vmin[1]) + (vmax[2] - vmin[2]) * (vmax[2] - vmin[2]));
+}
+
+
+// list the cells where coagulation can matter this step in m.coag_cells and return their number; the others keep
+// their dust as it is (coag_substeps = 0). A cell is dormant if its dust density is below coag_min_density, or if
+// the dust mass fraction coagulation moves in dt is estimated below coag_skip. The estimate scales the fraction
+// measured the last time the cell was worked on (coag_rate) with the dust density (rates go with n^2), dt and the
+// spread of the species velocities (kernels go with dv), so it costs O(NUMSPECIES) instead of the O(NUMSPECIES^2)
+// kernel. Every COAG_RECHECK steps all cells are worked on again. Both thresholds are 0 by default, which keeps
+// every cell.
+static int list_active_cells(mesh &m, double dt){
+    bool recheck = (m.coag_step % COAG_RECHECK == 0);
+    m.coag_step ++;
+    #pragma omp parallel for collapse(3) schedule (static)
+    for (int kk = m.x3s; kk < m.x3l; kk ++){
         for (int jj = m.x2s; jj < m.x2l; jj ++){
             for (int ii = m.x1s; ii < m.x1l; ii ++){
-                /*
-                if (rhomesh(j)[i] < 4e-17){         // if density is below some threshold, just skip coagulation calculations.
-                    continue;
-                }
-                */
-                BootesArray<double> grain_number_array; grain_number_array.NewBootesArray(m.NUMSPECIES);
-                BootesArray<double> grain_vr_array;     grain_vr_array.NewBootesArray(m.NUMSPECIES);
-                BootesArray<double> grain_vtheta_array; grain_vtheta_array.NewBootesArray(m.NUMSPECIES);
-                BootesArray<double> grain_vphi_array;   grain_vphi_array.NewBootesArray(m.NUMSPECIES);
-                for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
-                    double gas_rho = m.dcons(specIND, IDN, kk, jj, ii);
-                    grain_number_array(specIND) = gas_rho / m.GrainMassList(specIND);
-                    grain_vr_array(specIND)     = m.dcons(specIND, IM1, kk, jj, ii) / gas_rho;
-                    grain_vtheta_array(specIND) = m.dcons(specIND, IM2, kk, jj, ii) / gas_rho;
-                    grain_vphi_array(specIND)   = m.dcons(specIND, IM3, kk, jj, ii) / gas_rho;
-                    //cout << m.dcons(specIND, IM1, kk, jj, ii) << '\t';
-                }
-                //cout << endl << flush;
-                grain_growth_one_cell(grain_number_array,
-                                      grain_vr_array, grain_vtheta_array, grain_vphi_array,
-                                      m.GrainSizeList, m.GrainMassList, dt);
-                // copy 1-cell results from grain_number_array to m.dcons
-                for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++) {
-                    if (grain_number_array(specIND) * m.GrainMassList(specIND) < m.dminDensity) {
-                        m.dcons(specIND, IDN, kk, jj, ii) = m.dminDensity;
-                        double rhogradphix1;
-                        double rhogradphix2;
-                        double rhogradphix3;
-                        #ifdef ENABLE_GRAVITY
-                        rhogradphix1 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x1surface(kk, jj, ii + 1) - m.grav->Phi_grav_x1surface(kk, jj, ii)) / m.dx1p(kk, jj, ii);
-                        rhogradphix2 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x2surface(kk, jj + 1, ii) - m.grav->Phi_grav_x2surface(kk, jj, ii)) / m.dx2p(kk, jj, ii);
-                        rhogradphix3 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x3surface(kk + 1, jj, ii) - m.grav->Phi_grav_x3surface(kk, jj, ii)) / m.dx3p(kk, jj, ii);
-                        #else   // set gravity to zero
-                        rhogradphix1 = 0;
-                        rhogradphix2 = 0;
-                        rhogradphix3 = 0;
-                        #endif // ENABLE_GRAVITY
-                        #ifdef CARTESIAN_COORD
-                        dust_terminalvelocityapprixmation_xyz(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
-                                                              rhogradphix1, rhogradphix2, rhogradphix3,
-                                                              m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii),
-                                                              m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
-                                                              );
-                        #endif // CARTESIAN_COORD
-                        #ifdef SPHERICAL_POLAR_COORD
-                        dust_terminalvelocityapprixmation_rtp(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
-                                                              rhogradphix1, rhogradphix2, rhogradphix3,
-                                                              m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), m.x1v(ii), m.geo_cot(jj),
-                                                              m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
-                                                              );
-                        #endif // SPHERICAL_POLAR_COORD
-                        #ifdef DEBUG
-                        std::cout << "drho < 0:\t" << specIND << '\t' << kk << '\t' << jj << '\t' << ii << '\t'
-                                  << m.dcons(specIND, IDN, kk, jj, ii) << '\t' << m.dcons(specIND, IM1, kk, jj, ii) << '\t'
-                                  << m.dcons(specIND, IM2, kk, jj, ii) << '\t' << m.dcons(specIND, IM3, kk, jj, ii) << std::endl << flush;
-                        #endif // DEBUG
-                    }
-                    else {
-                        m.dcons(specIND, IDN, kk, jj, ii) = grain_number_array(specIND) * m.GrainMassList(specIND);
-                        m.dcons(specIND, IM1, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vr_array(specIND);
-                        m.dcons(specIND, IM2, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vtheta_array(specIND);
-                        m.dcons(specIND, IM3, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vphi_array(specIND);
-                    }
+                double rho_dust, dv_spread;
+                dust_density_and_spread(m, kk, jj, ii, rho_dust, dv_spread);
+                bool active = (rho_dust >= m.coag_min_density) && (recheck || m.coag_rate(kk, jj, ii) * rho_dust * dt * dv_spread >= m.coag_skip);
+                m.coag_active(((kk - m.x3s) * m.nx2 + jj - m.x2s) * m.nx1 + ii - m.x1s) = active;
+                if (!active){
+                    m.coag_substeps(kk, jj, ii) = 0;
                 }
             }
         }
     }
+    int ncells = 0;
+    for (int cell = 0; cell < m.nx3 * m.nx2 * m.nx1; cell ++){
+        if (m.coag_active(cell)){
+            m.coag_cells(ncells) = cell;
+            ncells ++;
+        }
+    }
+    return ncells;
+}
+
+
+void grain_growth(mesh &m, BootesArray<double> &stoppingtimemesh, double &dt){
+    int ncells = list_active_cells(m, dt);
+    // the cost per cell varies with the substeps it needs
+    #pragma omp parallel for schedule(dynamic)
+    for (int cell = 0; cell < ncells; cell ++){
+        int ii = m.x1s + m.coag_cells(cell) % m.nx1;
+        int jj = m.x2s + (m.coag_cells(cell) / m.nx1) % m.nx2;
+        int kk = m.x3s + m.coag_cells(cell) / (m.nx1 * m.nx2);
+        double *grain_number_array = m.coag_work.get_arr() + omp_get_thread_num() * (9 + 2 * m.NUMSPECIES) * m.NUMSPECIES;
+        double *grain_vr_array     = grain_number_array + m.NUMSPECIES;
+        double *grain_vtheta_array = grain_number_array + 2 * m.NUMSPECIES;
+        double *grain_vphi_array   = grain_number_array + 3 * m.NUMSPECIES;
+        double *work               = grain_number_array + 4 * m.NUMSPECIES;
+        for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+            double gas_rho = m.dcons(specIND, IDN, kk, jj, ii);
+            grain_number_array[specIND] = gas_rho / m.GrainMassList(specIND);
+            grain_vr_array[specIND]     = m.dcons(specIND, IM1, kk, jj, ii) / gas_rho;
+            grain_vtheta_array[specIND] = m.dcons(specIND, IM2, kk, jj, ii) / gas_rho;
+            grain_vphi_array[specIND]   = m.dcons(specIND, IM3, kk, jj, ii) / gas_rho;
+            //cout << m.dcons(specIND, IM1, kk, jj, ii) << '\t';
+        }
+        //cout << endl << flush;
+        double rho_dust, dv_spread;
+        dust_density_and_spread(m, kk, jj, ii, rho_dust, dv_spread);
+        double moved_fraction;
+        m.coag_substeps(kk, jj, ii) = grain_growth_one_cell(m, grain_number_array,
+                                                            grain_vr_array, grain_vtheta_array, grain_vphi_array,
+                                                            work, dt, moved_fraction);
+        // without a spread or a measurement nothing can be scaled: keep the cell active
+        double scale = rho_dust * dt * dv_spread;
+        m.coag_rate(kk, jj, ii) = (scale > 0) ? moved_fraction / scale : numeric_limits<double>::max();
+        // copy 1-cell results from grain_number_array to m.dcons
+        for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++) {
+            if (grain_number_array[specIND] * m.GrainMassList(specIND) < m.dminDensity) {
+                m.dcons(specIND, IDN, kk, jj, ii) = m.dminDensity;
+                double rhogradphix1;
+                double rhogradphix2;
+                double rhogradphix3;
+                #ifdef ENABLE_GRAVITY
+                rhogradphix1 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x1surface(kk, jj, ii + 1) - m.grav->Phi_grav_x1surface(kk, jj, ii)) / m.dx1p(kk, jj, ii);
+                rhogradphix2 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x2surface(kk, jj + 1, ii) - m.grav->Phi_grav_x2surface(kk, jj, ii)) / m.dx2p(kk, jj, ii);
+                rhogradphix3 = m.dcons(specIND, IDN, kk, jj, ii) * (m.grav->Phi_grav_x3surface(kk + 1, jj, ii) - m.grav->Phi_grav_x3surface(kk, jj, ii)) / m.dx3p(kk, jj, ii);
+                #else   // set gravity to zero
+                rhogradphix1 = 0;
+                rhogradphix2 = 0;
+                rhogradphix3 = 0;
+                #endif // ENABLE_GRAVITY
+                #ifdef CARTESIAN_COORD
+                dust_terminalvelocityapprixmation_xyz(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
+                                                      rhogradphix1, rhogradphix2, rhogradphix3,
+                                                      m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii),
+                                                      m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
+                                                      );
+                #endif // CARTESIAN_COORD
+                #ifdef SPHERICAL_POLAR_COORD
+                dust_terminalvelocityapprixmation_rtp(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
+                                                      rhogradphix1, rhogradphix2, rhogradphix3,
+                                                      m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), m.x1v(ii), m.geo_cot(jj),
+                                                      m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
+                                                      );
+                #endif // SPHERICAL_POLAR_COORD
+                #ifdef DEBUG
+                std::cout << "drho < 0:\t" << specIND << '\t' << kk << '\t' << jj << '\t' << ii << '\t'
+                          << m.dcons(specIND, IDN, kk, jj, ii) << '\t' << m.dcons(specIND, IM1, kk, jj, ii) << '\t'
+                          << m.dcons(specIND, IM2, kk, jj, ii) << '\t' << m.dcons(specIND, IM3, kk, jj, ii) << std::endl << flush;
+                #endif // DEBUG
+            }
+            else {
+                m.dcons(specIND, IDN, kk, jj, ii) = grain_number_array[specIND] * m.GrainMassList(specIND);
+                m.dcons(specIND, IM1, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vr_array[specIND];
+                m.dcons(specIND, IM2, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vtheta_array[specIND];
+                m.dcons(specIND, IM3, kk, jj, ii) = m.dcons(specIND, IDN, kk, jj, ii) * grain_vphi_array[specIND];
+            }
+        }
+    }
     #pragma omp barrier
 }
+
+#endif // defined (ENABLE_DUSTFLUID) && defined (ENABLE_DUST_GRAINGROWTH)
@@ -7,6 +7,8 @@
 class mesh;
 
 
+// build the pair tables and the per thread workspace of grain_growth from m.GrainMassList; call once after it is set
+void setup_grain_growth(mesh &m);
 void grain_growth(mesh &m, BootesArray<double> &stoppingtimemesh, double &dt);
 
 
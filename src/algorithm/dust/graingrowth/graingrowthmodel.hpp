@@ -2,9 +2,17 @@
 #define GRAINGROWTHMODEL_HPP_
 #include "../../BootesArray.hpp"
 #include "../../physical_constants.hpp"
+#include <cmath>
 
 
-void grain_growth_model_stick(double &s1, double &s2, double &dv, double res[2]);
+/** collision models: rates of a pair of grains per unit number density of each, res[0] for sticking (K)
+ *  and res[1] for fragmentation into the smallest bin (L). sigma = pi (s1 + s2)^2 and mass_sum = m1 + m2
+ *  come from the pair tables of mesh (GrainPairCrossSection, GrainPairMassSum); models must be symmetric
+ *  in the pair. Defined inline so that the pair loop of grain_growth_one_cell vectorizes. **/
+inline void grain_growth_model_stick(double sigma, double mass_sum, double dv, double res[2]){
+    res[0] = dv * sigma;
+    res[1] = 0.0;
+}
 
 
 #endif // GRAINGROWTHMODEL_HPP_
@@ -2,10 +2,22 @@
 #define HLL_DUST_HPP_
 
 
+// HLL flux of the pressureless dust, wave speeds sL = min(uL, uR) and sR = max(uL, uR): the upwind flux
+// where both move the same way, no mass through a diverging face, and the HLL average at a collision,
+// whose star state (rhoL + rhoR) stays positive
 void hll_dust( double *valsL,
           double *valsR,
           double *fluxs,
           int IMP,
           double &gamma);
 
+
+// Batched version: nface faces at once from structure-of-arrays states, valsL[var][ff] and valsR[var][ff]
+// (IDN, IM1..IM3), fluxes to fluxs[var][ff]. Gives the same fluxes as the single-face call.
+void hll_dust_batch(int nface,
+                    double * const *valsL,
+                    double * const *valsR,
+                    double * const *fluxs,
+                    int IMP);
+
 #endif // HLL_DUST_HPP_
@@ -3,10 +3,10 @@
 
 
 #ifdef CARTESIAN_COORD
-void dust_terminalvelocityapprixmation_xyz(double &vg1, double &vg2, double &vg3,
-                                           double &g1,  double &g2,  double &g3,
-                                           double &rhod, double &ts,
-                                           double &pd1, double &pd2, double &pd3){
+void dust_terminalvelocityapprixmation_xyz(const double &vg1, const double &vg2, const double &vg3,
+                                           const double &g1,  const double &g2,  const double &g3,
+                                           const double &rhod, const double &ts,
+                                           state_real &pd1, state_real &pd2, state_real &pd3){
     pd1 = rhod * vg1 + g1 * ts;
     pd2 = rhod * vg2 + g2 * ts;
     pd3 = rhod * vg3 + g3 * ts;
@@ -14,10 +14,10 @@ void dust_terminalvelocityapprixmation_xyz(double &vg1, double &vg2, double &vg3
 #endif // COORDINATE
 
 #ifdef SPHERICAL_POLAR_COORD
-void dust_terminalvelocityapprixmation_rtp(double &vg1, double &vg2, double &vg3,
-                                           double &g1,  double &g2,  double &g3,
-                                           double &rhod, double &ts,  double &r, double &cottheta,
-                                           double &pd1, double &pd2, double &pd3){
+void dust_terminalvelocityapprixmation_rtp(const double &vg1, const double &vg2, const double &vg3,
+                                           const double &g1,  const double &g2,  const double &g3,
+                                           const double &rhod, const double &ts,  const double &r, const double &cottheta,
+                                           state_real &pd1, state_real &pd2, state_real &pd3){
     pd1 = rhod * vg1 + (g1 + rhod * (vg2 * vg2 + vg3 * vg3) / r) * ts;
     pd2 = rhod * vg2 + (g2 - rhod * (vg1 * vg2 - vg3 * vg3 * cottheta) / r) * ts;
     pd3 = rhod * vg3 + (g3 - rhod * (vg1 * vg3 + vg2 * vg3 * cottheta) / r) * ts;
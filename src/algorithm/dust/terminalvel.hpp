@@ -1,19 +1,20 @@
 #ifndef TERMINALVEL_HPP_
 #define TERMINALVEL_HPP_
+#include "../mesh/mesh.hpp"
 
 
 #ifdef CARTESIAN_COORD
-void dust_terminalvelocityapprixmation_xyz(double &vg1, double &vg2, double &vg3,
-                                           double &g1,  double &g2,  double &g3,
-                                           double &rhod, double &ts,
-                                           double &pd1, double &pd2, double &pd3);
+void dust_terminalvelocityapprixmation_xyz(const double &vg1, const double &vg2, const double &vg3,
+                                           const double &g1,  const double &g2,  const double &g3,
+                                           const double &rhod, const double &ts,
+                                           state_real &pd1, state_real &pd2, state_real &pd3);
 #endif // COORDINATE
 
 #ifdef SPHERICAL_POLAR_COORD
-void dust_terminalvelocityapprixmation_rtp(double &vg1, double &vg2, double &vg3,
-                                           double &g1,  double &g2,  double &g3,
-                                           double &rhod, double &ts,  double &r, double &cottheta,
-                                           double &pd1, double &pd2, double &pd3);
+void dust_terminalvelocityapprixmation_rtp(const double &vg1, const double &vg2, const double &vg3,
+                                           const double &g1,  const double &g2,  const double &g3,
+                                           const double &rhod, const double &ts,  const double &r, const double &cottheta,
+                                           state_real &pd1, state_real &pd2, state_real &pd3);
 #endif // COORDINATE
 
 
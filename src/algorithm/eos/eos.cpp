@@ -3,48 +3,77 @@
 #include "../../defs.hpp"
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
+#include "../BootesArray.hpp"
 
 
-double thermalspeed(double &rho, double &p, double &vthcoeff){
+double thermalspeed(const double &rho, const double &p, const double &vthcoeff){
     return sqrt(vthcoeff * p / rho);
 }
 
 
-double soundspeed(double &rho, double &p, double &gamma){
+double soundspeed(const double &rho, const double &p, const double &gamma){
     return sqrt(gamma * p / rho);
 }
 
 
-double pres(double &dens, double &ene, double &m1, double &m2, double &m3, double &gamma){
+double pres(const double &dens, const double &ene, const double &m1, const double &m2, const double &m3, const double &gamma){
     return (ene - 0.5 * (m1 * m1 + m2 * m2 + m3 * m3) / dens) * (gamma - 1.);
 }
 
 
-double ene(double &rho, double &pres, double &v1, double &v2, double &v3, double &gamma){
+double ene(const double &rho, const double &pres, const double &v1, const double &v2, const double &v3, const double &gamma){
     return pres / (gamma - 1.) + 0.5 * rho * (v1 * v1 + v2 * v2 + v3 * v3);
 }
 
 
 void cons_to_prim(mesh &m){
-    #pragma omp parallel for collapse (3) schedule (static)
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> prim(m.prim);
+    double gamma = m.hydro_gamma;
+    #pragma omp parallel for collapse (2) schedule (static)
     for (int kk = m.x3s; kk < m.x3l ; kk++){
         for (int jj = m.x2s; jj < m.x2l; jj++){
+            state_real * __restrict rho = cons.ptr(IDN, kk, jj);
+            state_real * __restrict m1  = cons.ptr(IM1, kk, jj);
+            state_real * __restrict m2  = cons.ptr(IM2, kk, jj);
+            state_real * __restrict m3  = cons.ptr(IM3, kk, jj);
+            state_real * __restrict en  = cons.ptr(IEN, kk, jj);
+            state_real * __restrict prho = prim.ptr(IDN, kk, jj);
+            state_real * __restrict pv1  = prim.ptr(IV1, kk, jj);
+            state_real * __restrict pv2  = prim.ptr(IV2, kk, jj);
+            state_real * __restrict pv3  = prim.ptr(IV3, kk, jj);
+            state_real * __restrict ppn  = prim.ptr(IPN, kk, jj);
+            #pragma omp simd
             for (int ii = m.x1s; ii < m.x1l; ii++){
-                double v1 = m.cons(IM1, kk, jj, ii) / m.cons(IDN, kk, jj, ii);
-                double v2 = m.cons(IM2, kk, jj, ii) / m.cons(IDN, kk, jj, ii);
-                double v3 = m.cons(IM3, kk, jj, ii) / m.cons(IDN, kk, jj, ii);
-                m.prim(IDN, kk, jj, ii) = m.cons(IDN, kk, jj, ii);
-                m.prim(IV1, kk, jj, ii) = v1;
-                m.prim(IV2, kk, jj, ii) = v2;
-                m.prim(IV3, kk, jj, ii) = v3;
-                m.prim(IPN, kk, jj, ii) = pres(m.cons(IDN, kk, jj, ii), m.cons(IEN, kk, jj, ii),
-                                                 m.cons(IM1, kk, jj, ii), m.cons(IM2, kk, jj, ii), m.cons(IM3, kk, jj, ii), m.hydro_gamma);
+                prho[ii] = rho[ii];
+                pv1[ii]  = (double) m1[ii] / rho[ii];
+                pv2[ii]  = (double) m2[ii] / rho[ii];
+                pv3[ii]  = (double) m3[ii] / rho[ii];
+                ppn[ii]  = pres(rho[ii], en[ii], m1[ii], m2[ii], m3[ii], gamma);
             }
         }
     }
 }
 
-double energy_from_temperature_protection(double &dens, double &ene, double &m1, double &m2, double &m3, double &minTemp, double &gamma){
+void prim_to_soundspeed(mesh &m){
+    BootesView<state_real, 4> prim(m.prim);
+    BootesView<state_real, 3> cs(m.cs);
+    double gamma = m.hydro_gamma;
+    #pragma omp parallel for collapse (2) schedule (static)
+    for (int kk = 0; kk < m.x3v.shape()[0]; kk++){
+        for (int jj = 0; jj < m.x2v.shape()[0]; jj++){
+            state_real * __restrict rho = prim.ptr(IDN, kk, jj);
+            state_real * __restrict ppn = prim.ptr(IPN, kk, jj);
+            state_real * __restrict c   = cs.ptr(kk, jj);
+            #pragma omp simd
+            for (int ii = 0; ii < m.x1v.shape()[0]; ii++){
+                c[ii] = sqrt(gamma * ppn[ii] / rho[ii]);        // soundspeed()
+            }
+        }
+    }
+}
+
+double energy_from_temperature_protection(const double &dens, const double &ene, const double &m1, const double &m2, const double &m3, const double &minTemp, const double &gamma){
     double KE = 0.5 * (m1 * m1 + m2 * m2 + m3 * m3) / dens;
     double eint = ene - KE;
     if (std::isnan(ene)){
@@ -54,5 +83,9 @@ double energy_from_temperature_protection(double &dens, double &ene, double &m1,
 }
 
 
-
-
+double pressure_from_temperature_protection(const double &dens, const double &p, const double &minTemp){
+    if (std::isnan(p)){
+        return dens * minTemp;
+    }
+    return std::max(p, dens * minTemp);
+}
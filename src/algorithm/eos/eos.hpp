@@ -8,22 +8,31 @@
 class mesh;
 
 
-double thermalspeed(double &rho, double &p, double &vthcoeff);
+double thermalspeed(const double &rho, const double &p, const double &vthcoeff);
 
 
-double soundspeed(double &rho, double &p, double &gamma);
+double soundspeed(const double &rho, const double &p, const double &gamma);
 
 
-double pres(double &dens, double &ene, double &m1, double &m2, double &m3, double &gamma);
+double pres(const double &dens, const double &ene, const double &m1, const double &m2, const double &m3, const double &gamma);
 
 
-double ene(double &rho, double &pres, double &v1, double &v2, double &v3, double &gamma);
+double ene(const double &rho, const double &pres, const double &v1, const double &v2, const double &v3, const double &gamma);
 
 
 void cons_to_prim(mesh &m);
 
 
-double energy_from_temperature_protection(double &dens, double &ene, double &m1, double &m2, double &m3, double &minTemp, double &gamma);
+// m.cs = sound speed of m.prim in every cell, ghost zones included; once per flux evaluation when the
+// reconstruction works on primitive or characteristic variables
+void prim_to_soundspeed(mesh &m);
+
+
+double energy_from_temperature_protection(const double &dens, const double &ene, const double &m1, const double &m2, const double &m3, const double &minTemp, const double &gamma);
+
+
+// the same floor for a primitive state: p >= dens * minTemp
+double pressure_from_temperature_protection(const double &dens, const double &p, const double &minTemp);
 
 
 #endif // EOS_HPP_
@@ -1,6 +1,6 @@
 #include "momentum.hpp"
 
-double vel(double &mom, double &den){
+double vel(const double &mom, const double &den){
     return mom / den;
 }
 
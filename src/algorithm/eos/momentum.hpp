@@ -2,7 +2,7 @@
 #define MOMENMTUM_HPP_
 
 
-double vel(double &mom, double &den);
+double vel(const double &mom, const double &den);
 
 
 #endif
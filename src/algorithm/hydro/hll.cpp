@@ -2,6 +2,7 @@
 #include "../index_def.hpp"
 #include "hll.hpp"
 #include <cmath>
+#include <algorithm>
 
 
 void hll( double *valsL,
@@ -84,3 +85,137 @@ void hll_grav( double *valsL,
 }
 
 
+void hll_batch(int nface,
+               double * const *valsL,
+               double * const *valsR,
+               double * const *fluxs,
+               int IMP,
+               double gamma){
+    // same arithmetic as hll(), one lane per face; branches become selects of values that are all
+    // computed unconditionally, so that the loop can be if-converted
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict m1L  = valsL[IM1];
+    const double * __restrict m1R  = valsR[IM1];
+    const double * __restrict m2L  = valsL[IM2];
+    const double * __restrict m2R  = valsR[IM2];
+    const double * __restrict m3L  = valsL[IM3];
+    const double * __restrict m3R  = valsR[IM3];
+    const double * __restrict eL   = valsL[IEN];
+    const double * __restrict eR   = valsR[IEN];
+    const double * __restrict mpL  = valsL[IMP];
+    const double * __restrict mpR  = valsR[IMP];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double pL = (eL[ff] - 0.5 * (m1L[ff] * m1L[ff] + m2L[ff] * m2L[ff] + m3L[ff] * m3L[ff]) / rhoL[ff]) * (gamma - 1.);   // pres()
+        double pR = (eR[ff] - 0.5 * (m1R[ff] * m1R[ff] + m2R[ff] * m2R[ff] + m3R[ff] * m3R[ff]) / rhoR[ff]) * (gamma - 1.);
+        double uL = mpL[ff] / rhoL[ff];
+        double uR = mpR[ff] / rhoR[ff];
+        double aL = sqrt(gamma * pL / rhoL[ff]);                                                                            // soundspeed()
+        double aR = sqrt(gamma * pR / rhoR[ff]);
+        double sL = uL - aL;
+        double sR = uR + aR;
+        bool inL = (0 <= sL);
+        bool inR = (0 >= sR);
+
+        double flux_L, flux_R, flux_M;
+        flux_L = rhoL[ff] * uL;
+        flux_R = rhoR[ff] * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (rhoR[ff] - rhoL[ff])) / (sR - sL);
+        fd[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p1 ? m1L[ff] * uL + pL : m1L[ff] * uL;
+        flux_R = p1 ? m1R[ff] * uR + pR : m1R[ff] * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m1R[ff] - m1L[ff])) / (sR - sL);
+        fm1[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p2 ? m2L[ff] * uL + pL : m2L[ff] * uL;
+        flux_R = p2 ? m2R[ff] * uR + pR : m2R[ff] * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m2R[ff] - m2L[ff])) / (sR - sL);
+        fm2[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p3 ? m3L[ff] * uL + pL : m3L[ff] * uL;
+        flux_R = p3 ? m3R[ff] * uR + pR : m3R[ff] * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m3R[ff] - m3L[ff])) / (sR - sL);
+        fm3[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = eL[ff] * uL + pL * uL;
+        flux_R = eR[ff] * uR + pR * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (eR[ff] - eL[ff])) / (sR - sL);
+        fe[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+    }
+}
+
+
+void hll_prim_batch(int nface,
+                    double * const *valsL,
+                    double * const *valsR,
+                    double * const *fluxs,
+                    int IMP,
+                    double gamma){
+    // hll_batch() with the conserved states built from the primitive ones (ene()) instead of the pressure
+    // from the conserved ones
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict v1L  = valsL[IV1];
+    const double * __restrict v1R  = valsR[IV1];
+    const double * __restrict v2L  = valsL[IV2];
+    const double * __restrict v2R  = valsR[IV2];
+    const double * __restrict v3L  = valsL[IV3];
+    const double * __restrict v3R  = valsR[IV3];
+    const double * __restrict pnL  = valsL[IPN];
+    const double * __restrict pnR  = valsR[IPN];
+    const double * __restrict vpL  = valsL[IMP];
+    const double * __restrict vpR  = valsR[IMP];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double pL = pnL[ff];
+        double pR = pnR[ff];
+        double m1L = rhoL[ff] * v1L[ff], m2L = rhoL[ff] * v2L[ff], m3L = rhoL[ff] * v3L[ff];
+        double m1R = rhoR[ff] * v1R[ff], m2R = rhoR[ff] * v2R[ff], m3R = rhoR[ff] * v3R[ff];
+        double eL = pL / (gamma - 1.) + 0.5 * rhoL[ff] * (v1L[ff] * v1L[ff] + v2L[ff] * v2L[ff] + v3L[ff] * v3L[ff]);     // ene()
+        double eR = pR / (gamma - 1.) + 0.5 * rhoR[ff] * (v1R[ff] * v1R[ff] + v2R[ff] * v2R[ff] + v3R[ff] * v3R[ff]);
+        double uL = vpL[ff];
+        double uR = vpR[ff];
+        double aL = sqrt(gamma * pL / rhoL[ff]);                                                                            // soundspeed()
+        double aR = sqrt(gamma * pR / rhoR[ff]);
+        double sL = uL - aL;
+        double sR = uR + aR;
+        bool inL = (0 <= sL);
+        bool inR = (0 >= sR);
+
+        double flux_L, flux_R, flux_M;
+        flux_L = rhoL[ff] * uL;
+        flux_R = rhoR[ff] * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (rhoR[ff] - rhoL[ff])) / (sR - sL);
+        fd[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p1 ? m1L * uL + pL : m1L * uL;
+        flux_R = p1 ? m1R * uR + pR : m1R * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m1R - m1L)) / (sR - sL);
+        fm1[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p2 ? m2L * uL + pL : m2L * uL;
+        flux_R = p2 ? m2R * uR + pR : m2R * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m2R - m2L)) / (sR - sL);
+        fm2[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = p3 ? m3L * uL + pL : m3L * uL;
+        flux_R = p3 ? m3R * uR + pR : m3R * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (m3R - m3L)) / (sR - sL);
+        fm3[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+        flux_L = eL * uL + pL * uL;
+        flux_R = eR * uR + pR * uR;
+        flux_M = (sR * flux_L - sL * flux_R + sL * sR * (eR - eL)) / (sR - sL);
+        fe[ff] = inL ? flux_L : (inR ? flux_R : flux_M);
+    }
+}
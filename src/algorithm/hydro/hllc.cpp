@@ -4,94 +4,148 @@
 #include <cmath>
 #include <algorithm>
 
+// HLLC flux of one variable: flux_K, state uvK and star state usK of both sides, and the region of the face
+static inline double hllc_region(bool inL, bool inR, bool starL, double sL, double sR,
+                                 double flux_L, double flux_R, double uvL, double uvR, double usL, double usR){
+    double fstar = starL ? flux_L + sL * (usL - uvL) : flux_R + sR * (usR - uvR);
+    return inL ? flux_L : (inR ? flux_R : fstar);
+}
+
+
+// HLLC flux of one face from the density, momenta, velocities, pressure and energy of both sides; p1, p2, p3:
+// the momentum along the axis. Wave speeds from the pressure based estimate (Toro 10.59 - 10.61), the star
+// states are those of Toro 10.39,
+//   U*K = rhoK (sK - uK) / (sK - s*) (1, s* along the axis, the transverse velocities, EK / rhoK + (s* - uK) (s* + pK / (rhoK (sK - uK)))),
+// and the flux is FL (0 <= sL), FL + sL (U*L - UL) (sL < 0 <= s*), FR + sR (U*R - UR) (s* < 0 < sR) or FR (sR <= 0).
+// Every candidate is computed and the region only selects, so a loop over faces can be if-converted.
+static inline void hllc_face(double rhoL, double m1L, double m2L, double m3L, double v1L, double v2L, double v3L, double pL, double eL,
+                             double rhoR, double m1R, double m2R, double m3R, double v1R, double v2R, double v3R, double pR, double eR,
+                             bool p1, bool p2, bool p3, double gamma,
+                             double &fd, double &fm1, double &fm2, double &fm3, double &fe){
+    double uL = p1 ? v1L : (p2 ? v2L : v3L);
+    double uR = p1 ? v1R : (p2 ? v2R : v3R);
+    double aL = sqrt(gamma * pL / rhoL);                                                                                // soundspeed()
+    double aR = sqrt(gamma * pR / rhoR);
+    double rhobar = 0.5 * (rhoL + rhoR);
+    double abar   = 0.5 * (aL + aR);
+    double ppvrs  = 0.5 * (pL + pR) - 0.5 * (uR - uL) * rhobar * abar;
+    double pstar  = std::max(0., ppvrs);
+    double qL = sqrt(1 + (gamma + 1) / (2 * gamma) * (pstar / pL - 1));
+    double qR = sqrt(1 + (gamma + 1) / (2 * gamma) * (pstar / pR - 1));
+    qL = (pstar <= pL) ? 1. : qL;
+    qR = (pstar <= pR) ? 1. : qR;
+    double sL = uL - aL * qL;
+    double sR = uR + aR * qR;
+    double sstar = (pR - pL + rhoL * uL * (sL - uL) - rhoR * uR * (sR - uR)) / (rhoL * (sL - uL) - rhoR * (sR - uR));     // 10.70
+    double cstarL = rhoL * (sL - uL) / (sL - sstar);
+    double cstarR = rhoR * (sR - uR) / (sR - sstar);
+    bool inL   = (0 <= sL);
+    bool inR   = (sR <= 0);
+    bool starL = (0 <= sstar);
+
+    fd  = hllc_region(inL, inR, starL, sL, sR, rhoL * uL, rhoR * uR, rhoL, rhoR, cstarL, cstarR);
+    fm1 = hllc_region(inL, inR, starL, sL, sR, p1 ? m1L * uL + pL : m1L * uL, p1 ? m1R * uR + pR : m1R * uR, m1L, m1R,
+                      cstarL * (p1 ? sstar : v1L), cstarR * (p1 ? sstar : v1R));
+    fm2 = hllc_region(inL, inR, starL, sL, sR, p2 ? m2L * uL + pL : m2L * uL, p2 ? m2R * uR + pR : m2R * uR, m2L, m2R,
+                      cstarL * (p2 ? sstar : v2L), cstarR * (p2 ? sstar : v2R));
+    fm3 = hllc_region(inL, inR, starL, sL, sR, p3 ? m3L * uL + pL : m3L * uL, p3 ? m3R * uR + pR : m3R * uR, m3L, m3R,
+                      cstarL * (p3 ? sstar : v3L), cstarR * (p3 ? sstar : v3R));
+    fe  = hllc_region(inL, inR, starL, sL, sR, eL * uL + pL * uL, eR * uR + pR * uR, eL, eR,
+                      cstarL * (eL / rhoL + (sstar - uL) * (sstar + pL / (rhoL * (sL - uL)))),
+                      cstarR * (eR / rhoR + (sstar - uR) * (sstar + pR / (rhoR * (sR - uR)))));
+}
+
+
 void hllc( double *valsL,
           double *valsR,
           double *fluxs,
           int IMP,
           double &gamma){
     /**
-        rhoL, rhoR: density
-        pL, pR:     pressure
-        uL, uR:     speed
-        valsL:      array of double storing the values on left. Quantities are <rho, rho*v1, rho*v2, rho*v3, E> (may not in this order)
-        gamma:      hydro gamma
-        INDRHO:     the ordering of variables in valsL and valsR (density)
-        INDV1:      the ordering of variables in valsL and valsR (v1)
-        INDV2:      the ordering of variables in valsL and valsR (v2)
-        INDV3:      the ordering of variables in valsL and valsR (v3)
-        INDE :      the ordering of variables in valsL and valsR (E)
+        valsL, valsR: conserved states <rho, rho*v1, rho*v2, rho*v3, E> on the left and right of the face
+        fluxs:        HLLC flux, same ordering
+        IMP:          the momentum along the axis (IM1, IM2 or IM3)
+        gamma:        hydro gamma
     **/
-    // step 1: wave speed estimates, Toro 10.6
-    double rhoL = valsL[IDN];
-    double rhoR = valsR[IDN];
-    double EL = valsL[IEN];
-    double ER = valsR[IEN];
     double pL = pres(valsL[IDN], valsL[IEN], valsL[IM1], valsL[IM2], valsL[IM3], gamma);
     double pR = pres(valsR[IDN], valsR[IEN], valsR[IM1], valsR[IM2], valsR[IM3], gamma);
-    double uL = valsL[IMP] / rhoL;
-    double uR = valsR[IMP] / rhoR;
-    double aL = soundspeed(rhoL, pL, gamma);
-    double aR = soundspeed(rhoR, pR, gamma);
-    double rhobar = 0.5 * (rhoL + rhoR);
-    double abar   = 0.5 * (aL + aR);
-    double ppvrs  = 0.5 * (pL + pR) - 0.5 * (uR - uL) * rhobar * abar;
-    double pstar  = std::max(0., ppvrs);
-    // step 2: wave speed estimates
-    double qL, qR;
-    if (pstar <= pL){
-        qL = 1;
-    }
-    else{
-        qL = sqrt(1 + (gamma + 1) / (2 * gamma) * (pstar / pL - 1));
-    }
+    hllc_face(valsL[IDN], valsL[IM1], valsL[IM2], valsL[IM3],
+              valsL[IM1] / valsL[IDN], valsL[IM2] / valsL[IDN], valsL[IM3] / valsL[IDN], pL, valsL[IEN],
+              valsR[IDN], valsR[IM1], valsR[IM2], valsR[IM3],
+              valsR[IM1] / valsR[IDN], valsR[IM2] / valsR[IDN], valsR[IM3] / valsR[IDN], pR, valsR[IEN],
+              IMP == IM1, IMP == IM2, IMP == IM3, gamma,
+              fluxs[IDN], fluxs[IM1], fluxs[IM2], fluxs[IM3], fluxs[IEN]);
+}
 
-    if (pstar <= pR){
-        qR = 1;
-    }
-    else{
-        qR = sqrt(1 + (gamma + 1) / (2 * gamma) * (pstar / pR - 1));
+
+void hllc_batch(int nface,
+                double * const *valsL,
+                double * const *valsR,
+                double * const *fluxs,
+                int IMP,
+                double gamma){
+    // hllc() one lane per face
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict m1L  = valsL[IM1];
+    const double * __restrict m1R  = valsR[IM1];
+    const double * __restrict m2L  = valsL[IM2];
+    const double * __restrict m2R  = valsR[IM2];
+    const double * __restrict m3L  = valsL[IM3];
+    const double * __restrict m3R  = valsR[IM3];
+    const double * __restrict eL   = valsL[IEN];
+    const double * __restrict eR   = valsR[IEN];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double pL = (eL[ff] - 0.5 * (m1L[ff] * m1L[ff] + m2L[ff] * m2L[ff] + m3L[ff] * m3L[ff]) / rhoL[ff]) * (gamma - 1.);   // pres()
+        double pR = (eR[ff] - 0.5 * (m1R[ff] * m1R[ff] + m2R[ff] * m2R[ff] + m3R[ff] * m3R[ff]) / rhoR[ff]) * (gamma - 1.);
+        hllc_face(rhoL[ff], m1L[ff], m2L[ff], m3L[ff], m1L[ff] / rhoL[ff], m2L[ff] / rhoL[ff], m3L[ff] / rhoL[ff], pL, eL[ff],
+                  rhoR[ff], m1R[ff], m2R[ff], m3R[ff], m1R[ff] / rhoR[ff], m2R[ff] / rhoR[ff], m3R[ff] / rhoR[ff], pR, eR[ff],
+                  p1, p2, p3, gamma, fd[ff], fm1[ff], fm2[ff], fm3[ff], fe[ff]);
     }
+}
 
-    double sL = uL - aL * qL;
-    double sR = uR + aR * qR;
 
-    double sstar = (pR - pL + rhoL * uL * (sL - uL) - rhoR * uR * (sR - uR)) / (rhoL * (sL - uL) - rhoR * (sR - uR));     // 10.70
-    // step 3: HLLC flux
-    for (int val_ind = 0; val_ind < 5; val_ind ++){
-        double flux_L = valsL[val_ind] * uL;
-        double flux_R = valsR[val_ind] * uR;
-        if (val_ind == IMP){
-            flux_L += pL;
-            flux_R += pR;
-        }
-        if (val_ind == IEN){
-            flux_L += pL * uL;
-            flux_R += pR * uR;
-        }
-        //cout << "flux: " << flux_L << '\t' << flux_R << endl;
-        if      (0 <= sL){
-            fluxs[val_ind] = flux_L;
-        }
-        else if (sL <= 0 <= sstar){
-            double UsKM;
-            if (val_ind == IDN)     { UsKM = 1; }
-            else if (val_ind == IEN){ UsKM = EL / rhoL + (sstar - uL) * (sstar + pL / (rhoL * (sL - uL))); }
-            else if (val_ind == IMP){ UsKM = sstar; }
-            else                    { UsKM = valsL[val_ind] / valsL[IDN]; }
-            double ustarL = rhoL * (sL - uL) / (sL - sstar);
-            fluxs[val_ind] = flux_L + sL * (ustarL - uL);
-        }
-        else if (sstar <= 0 <= sR){
-            double UsKM;
-            if (val_ind == IDN)     { UsKM = 1; }
-            else if (val_ind == IEN){ UsKM = ER / rhoR + (sstar - uR) * (sstar + pR / (rhoR * (sR - uR))); }
-            else if (val_ind == IMP){ UsKM = sstar; }
-            else                    { UsKM = valsR[val_ind] / valsR[IDN]; }
-            double ustarR = rhoR * (sR - uR) / (sR - sstar);
-            fluxs[val_ind] = flux_R + sR * (ustarR - uR);
-        }
-        else {     //  if (0 >= sR )
-            fluxs[val_ind] = flux_R;
-        }
+void hllc_prim_batch(int nface,
+                     double * const *valsL,
+                     double * const *valsR,
+                     double * const *fluxs,
+                     int IMP,
+                     double gamma){
+    // hllc_batch() with the conserved states built from the primitive ones (ene()) instead of the pressure
+    // from the conserved ones
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict v1L  = valsL[IV1];
+    const double * __restrict v1R  = valsR[IV1];
+    const double * __restrict v2L  = valsL[IV2];
+    const double * __restrict v2R  = valsR[IV2];
+    const double * __restrict v3L  = valsL[IV3];
+    const double * __restrict v3R  = valsR[IV3];
+    const double * __restrict pnL  = valsL[IPN];
+    const double * __restrict pnR  = valsR[IPN];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double eL = pnL[ff] / (gamma - 1.) + 0.5 * rhoL[ff] * (v1L[ff] * v1L[ff] + v2L[ff] * v2L[ff] + v3L[ff] * v3L[ff]);     // ene()
+        double eR = pnR[ff] / (gamma - 1.) + 0.5 * rhoR[ff] * (v1R[ff] * v1R[ff] + v2R[ff] * v2R[ff] + v3R[ff] * v3R[ff]);
+        hllc_face(rhoL[ff], rhoL[ff] * v1L[ff], rhoL[ff] * v2L[ff], rhoL[ff] * v3L[ff], v1L[ff], v2L[ff], v3L[ff], pnL[ff], eL,
+                  rhoR[ff], rhoR[ff] * v1R[ff], rhoR[ff] * v2R[ff], rhoR[ff] * v3R[ff], v1R[ff], v2R[ff], v3R[ff], pnR[ff], eR,
+                  p1, p2, p3, gamma, fd[ff], fm1[ff], fm2[ff], fm3[ff], fe[ff]);
     }
 }
@@ -2,6 +2,8 @@
 #define HLLC_HPP_
 
 
+// HLLC (Toro 10.4) with the pressure based wave speed estimates; the contact and shear waves are resolved, so
+// it is far less diffusive than hlle on shear layers.
 void hllc( double *valsL,
           double *valsR,
           double *fluxs,
@@ -9,4 +11,23 @@ void hllc( double *valsL,
           double &gamma);
 
 
+// Batched version: nface faces at once from structure-of-arrays states, valsL[var][ff] and valsR[var][ff],
+// fluxes to fluxs[var][ff]. Gives the same fluxes as the single-face call.
+void hllc_batch(int nface,
+                double * const *valsL,
+                double * const *valsR,
+                double * const *fluxs,
+                int IMP,
+                double gamma);
+
+
+// The same from primitive face states, valsL[var][ff] with var = IDN, IV1, IV2, IV3, IPN (reconstruction_variables =
+// primitive or characteristic): the pressure comes with the state, only the sound speed is computed per face.
+void hllc_prim_batch(int nface,
+                     double * const *valsL,
+                     double * const *valsR,
+                     double * const *fluxs,
+                     int IMP,
+                     double gamma);
+
 #endif // HLLC_HPP_
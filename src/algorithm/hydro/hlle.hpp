@@ -7,4 +7,24 @@ void hlle( double *valsL,
           int IMP,
           double &gamma);
 
+
+// Batched version: nface faces at once from structure-of-arrays states, valsL[var][ff] and valsR[var][ff],
+// fluxes to fluxs[var][ff]. Gives the same fluxes as the single-face call.
+void hlle_batch(int nface,
+                double * const *valsL,
+                double * const *valsR,
+                double * const *fluxs,
+                int IMP,
+                double gamma);
+
+
+// The same from primitive face states, valsL[var][ff] with var = IDN, IV1, IV2, IV3, IPN (reconstruction_variables =
+// primitive or characteristic): the pressure comes with the state, only the sound speed is computed per face.
+void hlle_prim_batch(int nface,
+                     double * const *valsL,
+                     double * const *valsR,
+                     double * const *fluxs,
+                     int IMP,
+                     double gamma);
+
 #endif // HLLE_HPP_
@@ -0,0 +1,180 @@
+#include "../eos/eos.hpp"
+#include "../index_def.hpp"
+#include "roe.hpp"
+#include <cmath>
+#include <algorithm>
+
+
+// Harten's entropy fix: |l| smoothed to (l^2 + d^2) / (2 d) within d of zero
+static inline double harten_abs(double l, double d){
+    double al = std::abs(l);
+    return (al < d) ? (l * l + d * d) / (2 * d) : al;
+}
+
+
+// Roe flux of one face from the density, momenta, velocities, pressure and energy of both sides; p1, p2, p3: the
+// momentum along the axis. F = (FL + FR) / 2 - sum_k |lk| ak Kk / 2 over the u - a, entropy, two shear and u + a
+// waves of the Roe averaged state (Toro 11.3.3); the wave strengths come from the primitive jumps,
+//   a1,5 = (dp -+ rho~ a~ du) / (2 a~^2), a2 = drho - dp / a~^2, a3,4 = rho~ dv (transverse), rho~ = sqrt(rhoL rhoR).
+// The width of Harten's fix is that of Harten & Hyman (1983), the spread of the eigenvalue between the two sides,
+// so it only acts in transonic rarefactions. Every candidate is computed and the fallback to HLLE only selects,
+// so a loop over faces can be if-converted.
+static inline void roe_face(double rhoL, double m1L, double m2L, double m3L, double v1L, double v2L, double v3L, double pL, double eL,
+                            double rhoR, double m1R, double m2R, double m3R, double v1R, double v2R, double v3R, double pR, double eR,
+                            bool p1, bool p2, bool p3, double gamma,
+                            double &fd, double &fm1, double &fm2, double &fm3, double &fe){
+    double uL = p1 ? v1L : (p2 ? v2L : v3L);
+    double uR = p1 ? v1R : (p2 ? v2R : v3R);
+    double cL = sqrt(gamma * pL / rhoL);                                                                                // soundspeed()
+    double cR = sqrt(gamma * pR / rhoR);
+
+    // Roe averages
+    double sqL = sqrt(rhoL);
+    double sqR = sqrt(rhoR);
+    double wL  = sqL / (sqL + sqR);
+    double wR  = sqR / (sqL + sqR);
+    double ub1 = wL * v1L + wR * v1R;
+    double ub2 = wL * v2L + wR * v2R;
+    double ub3 = wL * v3L + wR * v3R;
+    double ub  = p1 ? ub1 : (p2 ? ub2 : ub3);
+    double hb  = wL * (eL + pL) / rhoL + wR * (eR + pR) / rhoR;
+    double q2  = ub1 * ub1 + ub2 * ub2 + ub3 * ub3;
+    double ab2 = (gamma - 1.) * (hb - 0.5 * q2);
+    bool real  = (ab2 > 0);
+    ab2 = real ? ab2 : 1.;
+    double ab   = sqrt(ab2);
+    double rhob = sqL * sqR;
+
+    // wave strengths and speeds
+    double du  = uR - uL;
+    double dp  = pR - pL;
+    double dv1 = v1R - v1L;
+    double dv2 = v2R - v2L;
+    double dv3 = v3R - v3L;
+    double a1  = (dp - rhob * ab * du) / (2 * ab2);
+    double a2  = (rhoR - rhoL) - dp / ab2;
+    double a5  = (dp + rhob * ab * du) / (2 * ab2);
+    double l1  = ub - ab;
+    double l5  = ub + ab;
+    double d1  = std::max(0., std::max(l1 - (uL - cL), (uR - cR) - l1));
+    double d5  = std::max(0., std::max(l5 - (uL + cL), (uR + cR) - l5));
+    double w1  = harten_abs(l1, d1) * a1;
+    double w2  = std::abs(ub) * a2;
+    double w5  = harten_abs(l5, d5) * a5;
+    double wt  = std::abs(ub) * rhob;
+    double w   = w1 + w2 + w5;
+
+    // physical fluxes of both sides
+    double fdL  = rhoL * uL,                    fdR  = rhoR * uR;
+    double fm1L = p1 ? m1L * uL + pL : m1L * uL, fm1R = p1 ? m1R * uR + pR : m1R * uR;
+    double fm2L = p2 ? m2L * uL + pL : m2L * uL, fm2R = p2 ? m2R * uR + pR : m2R * uR;
+    double fm3L = p3 ? m3L * uL + pL : m3L * uL, fm3R = p3 ? m3R * uR + pR : m3R * uR;
+    double feL  = (eL + pL) * uL,               feR  = (eR + pR) * uR;
+
+    double roe_d  = 0.5 * (fdL + fdR) - 0.5 * w;
+    double roe_m1 = 0.5 * (fm1L + fm1R) - 0.5 * (w * ub1 + (p1 ? (w5 - w1) * ab : wt * dv1));
+    double roe_m2 = 0.5 * (fm2L + fm2R) - 0.5 * (w * ub2 + (p2 ? (w5 - w1) * ab : wt * dv2));
+    double roe_m3 = 0.5 * (fm3L + fm3R) - 0.5 * (w * ub3 + (p3 ? (w5 - w1) * ab : wt * dv3));
+    double roe_e  = 0.5 * (feL + feR) - 0.5 * (w1 * (hb - ub * ab) + w2 * 0.5 * q2 + w5 * (hb + ub * ab)
+                                               + wt * (ub1 * dv1 + ub2 * dv2 + ub3 * dv3 - ub * du));
+
+    // HLLE with the wave speeds of hlle()
+    double bm = std::min(0., std::min(uL - cL, uR - cR));
+    double bp = std::max(0., std::max(uL + cL, uR + cR));
+    double ib = 1. / (bp - bm);
+    bool roe_ok = real && (rhoL + a1 > 0) && (rhoR - a5 > 0);
+    fd  = roe_ok ? roe_d  : (bp * fdL  - bm * fdR  + bp * bm * (rhoR - rhoL)) * ib;
+    fm1 = roe_ok ? roe_m1 : (bp * fm1L - bm * fm1R + bp * bm * (m1R - m1L)) * ib;
+    fm2 = roe_ok ? roe_m2 : (bp * fm2L - bm * fm2R + bp * bm * (m2R - m2L)) * ib;
+    fm3 = roe_ok ? roe_m3 : (bp * fm3L - bm * fm3R + bp * bm * (m3R - m3L)) * ib;
+    fe  = roe_ok ? roe_e  : (bp * feL  - bm * feR  + bp * bm * (eR - eL)) * ib;
+}
+
+
+void roe( double *valsL,
+          double *valsR,
+          double *fluxs,
+          int IMP,
+          double &gamma){
+    double pL = pres(valsL[IDN], valsL[IEN], valsL[IM1], valsL[IM2], valsL[IM3], gamma);
+    double pR = pres(valsR[IDN], valsR[IEN], valsR[IM1], valsR[IM2], valsR[IM3], gamma);
+    roe_face(valsL[IDN], valsL[IM1], valsL[IM2], valsL[IM3],
+             valsL[IM1] / valsL[IDN], valsL[IM2] / valsL[IDN], valsL[IM3] / valsL[IDN], pL, valsL[IEN],
+             valsR[IDN], valsR[IM1], valsR[IM2], valsR[IM3],
+             valsR[IM1] / valsR[IDN], valsR[IM2] / valsR[IDN], valsR[IM3] / valsR[IDN], pR, valsR[IEN],
+             IMP == IM1, IMP == IM2, IMP == IM3, gamma,
+             fluxs[IDN], fluxs[IM1], fluxs[IM2], fluxs[IM3], fluxs[IEN]);
+}
+
+
+void roe_batch(int nface,
+               double * const *valsL,
+               double * const *valsR,
+               double * const *fluxs,
+               int IMP,
+               double gamma){
+    // roe() one lane per face
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict m1L  = valsL[IM1];
+    const double * __restrict m1R  = valsR[IM1];
+    const double * __restrict m2L  = valsL[IM2];
+    const double * __restrict m2R  = valsR[IM2];
+    const double * __restrict m3L  = valsL[IM3];
+    const double * __restrict m3R  = valsR[IM3];
+    const double * __restrict eL   = valsL[IEN];
+    const double * __restrict eR   = valsR[IEN];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double pL = (eL[ff] - 0.5 * (m1L[ff] * m1L[ff] + m2L[ff] * m2L[ff] + m3L[ff] * m3L[ff]) / rhoL[ff]) * (gamma - 1.);   // pres()
+        double pR = (eR[ff] - 0.5 * (m1R[ff] * m1R[ff] + m2R[ff] * m2R[ff] + m3R[ff] * m3R[ff]) / rhoR[ff]) * (gamma - 1.);
+        roe_face(rhoL[ff], m1L[ff], m2L[ff], m3L[ff], m1L[ff] / rhoL[ff], m2L[ff] / rhoL[ff], m3L[ff] / rhoL[ff], pL, eL[ff],
+                 rhoR[ff], m1R[ff], m2R[ff], m3R[ff], m1R[ff] / rhoR[ff], m2R[ff] / rhoR[ff], m3R[ff] / rhoR[ff], pR, eR[ff],
+                 p1, p2, p3, gamma, fd[ff], fm1[ff], fm2[ff], fm3[ff], fe[ff]);
+    }
+}
+
+
+void roe_prim_batch(int nface,
+                    double * const *valsL,
+                    double * const *valsR,
+                    double * const *fluxs,
+                    int IMP,
+                    double gamma){
+    // roe_batch() with the conserved states built from the primitive ones (ene()) instead of the pressure
+    // from the conserved ones
+    const double * __restrict rhoL = valsL[IDN];
+    const double * __restrict rhoR = valsR[IDN];
+    const double * __restrict v1L  = valsL[IV1];
+    const double * __restrict v1R  = valsR[IV1];
+    const double * __restrict v2L  = valsL[IV2];
+    const double * __restrict v2R  = valsR[IV2];
+    const double * __restrict v3L  = valsL[IV3];
+    const double * __restrict v3R  = valsR[IV3];
+    const double * __restrict pnL  = valsL[IPN];
+    const double * __restrict pnR  = valsR[IPN];
+    double * __restrict fd  = fluxs[IDN];
+    double * __restrict fm1 = fluxs[IM1];
+    double * __restrict fm2 = fluxs[IM2];
+    double * __restrict fm3 = fluxs[IM3];
+    double * __restrict fe  = fluxs[IEN];
+    bool p1 = (IMP == IM1);
+    bool p2 = (IMP == IM2);
+    bool p3 = (IMP == IM3);
+    #pragma omp simd
+    for (int ff = 0; ff < nface; ff ++){
+        double eL = pnL[ff] / (gamma - 1.) + 0.5 * rhoL[ff] * (v1L[ff] * v1L[ff] + v2L[ff] * v2L[ff] + v3L[ff] * v3L[ff]);     // ene()
+        double eR = pnR[ff] / (gamma - 1.) + 0.5 * rhoR[ff] * (v1R[ff] * v1R[ff] + v2R[ff] * v2R[ff] + v3R[ff] * v3R[ff]);
+        roe_face(rhoL[ff], rhoL[ff] * v1L[ff], rhoL[ff] * v2L[ff], rhoL[ff] * v3L[ff], v1L[ff], v2L[ff], v3L[ff], pnL[ff], eL,
+                 rhoR[ff], rhoR[ff] * v1R[ff], rhoR[ff] * v2R[ff], rhoR[ff] * v3R[ff], v1R[ff], v2R[ff], v3R[ff], pnR[ff], eR,
+                 p1, p2, p3, gamma, fd[ff], fm1[ff], fm2[ff], fm3[ff], fe[ff]);
+    }
+}
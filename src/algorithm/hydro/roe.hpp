@@ -0,0 +1,33 @@
+#ifndef ROE_HPP_
+#define ROE_HPP_
+
+// Roe's linearized solver (Toro 11.3) with Harten's entropy fix on the acoustic waves. Where the linearized star
+// densities are <= 0 or the Roe averaged sound speed is not real (strong rarefactions, Einfeldt et al. 1991) the
+// face takes the HLLE flux instead.
+void roe( double *valsL,
+          double *valsR,
+          double *fluxs,
+          int IMP,
+          double &gamma);
+
+
+// Batched version: nface faces at once from structure-of-arrays states, valsL[var][ff] and valsR[var][ff],
+// fluxes to fluxs[var][ff]. Gives the same fluxes as the single-face call.
+void roe_batch(int nface,
+               double * const *valsL,
+               double * const *valsR,
+               double * const *fluxs,
+               int IMP,
+               double gamma);
+
+
+// The same from primitive face states, valsL[var][ff] with var = IDN, IV1, IV2, IV3, IPN (reconstruction_variables =
+// primitive or characteristic).
+void roe_prim_batch(int nface,
+                    double * const *valsL,
+                    double * const *valsR,
+                    double * const *fluxs,
+                    int IMP,
+                    double gamma);
+
+#endif // ROE_HPP_
@@ -0,0 +1,268 @@
+#ifndef ASYNC_OUTPUT_HPP_
+#define ASYNC_OUTPUT_HPP_
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstring>
+#include <type_traits>
+#include "output.hpp"
+#include "../BootesArray.hpp"
+
+using namespace std;
+using namespace H5;
+
+
+/** One output file, filled by the solver with the same calls as Output and written later by
+ *  AsyncOutput's writer thread. Datasets are copied into buffers owned by the frame, which are
+ *  kept from one frame to the next, so a snapshot costs one memory copy of the state and no
+ *  allocation once the frames are warm. **/
+class OutputFrame{
+    public:
+    template<typename T>
+    void writeattribute(T *attr, string name, PredType hdf5_type, unsigned int FSPACE_ATT){
+        attributes_.push_back({name, hdf5_type, FSPACE_ATT, string((const char *) attr, sizeof(T) * FSPACE_ATT)});
+    }
+
+    void writeStringdataset(string &str, string dsetname){
+        strings_.push_back({dsetname, str});
+    }
+
+    // arrays stored in float (ENABLE_FLOAT_STATE) are widened to double, so the files do not depend on the build
+    template<typename T>
+    void write1Ddataset(BootesArray<T> &datain, string name, PredType hdf5_type){ copy_dataset(datain, name, hdf5_type, 1); }
+    template<typename T>
+    void write2Ddataset(BootesArray<T> &datain, string name, PredType hdf5_type){ copy_dataset(datain, name, hdf5_type, 2); }
+    template<typename T>
+    void write3Ddataset(BootesArray<T> &datain, string name, PredType hdf5_type){ copy_dataset(datain, name, hdf5_type, 3); }
+    template<typename T>
+    void write4Ddataset(BootesArray<T> &datain, string name, PredType hdf5_type){ copy_dataset(datain, name, hdf5_type, 4); }
+    template<typename T>
+    void write5Ddataset(BootesArray<T> &datain, string name, PredType hdf5_type){ copy_dataset(datain, name, hdf5_type, 5); }
+
+    // filters of the datasets written after this call, see Output::set_filters
+    void set_filters(int deflate, bool shuffle, bool szip, int lossy_digits){
+        filters_.push_back({ndatasets_, deflate, shuffle, szip, lossy_digits});
+    }
+
+    // the actual HDF5 output, on the writer thread
+    void write(){
+        Output output(fn_, 'w');
+        unsigned int nfilter = 0;
+        for (auto &att : attributes_){
+            output.writeattribute<const char>(att.bytes.data(), att.name, att.type, att.n);
+        }
+        for (auto &str : strings_){
+            output.writeStringdataset(str.value, str.name);
+        }
+        for (int ii = 0; ii < ndatasets_; ii++){
+            for (; nfilter < filters_.size() && filters_[nfilter].first_dataset == ii; nfilter++){
+                FilterEntry &filter = filters_[nfilter];
+                output.set_filters(filter.deflate, filter.shuffle, filter.szip, filter.lossy_digits);
+            }
+            DatasetEntry &dset = datasets_[ii];
+            if      (dset.dimension == 1){ output.write1Ddataset(dset.data, dset.name, dset.type); }
+            else if (dset.dimension == 2){ output.write2Ddataset(dset.data, dset.name, dset.type); }
+            else if (dset.dimension == 3){ output.write3Ddataset(dset.data, dset.name, dset.type); }
+            else if (dset.dimension == 4){ output.write4Ddataset(dset.data, dset.name, dset.type); }
+            else                         { output.write5Ddataset(dset.data, dset.name, dset.type); }
+        }
+        output.close();
+    }
+
+    private:
+    friend class AsyncOutput;
+
+    struct AttributeEntry{
+        string name;
+        PredType type;
+        unsigned int n;
+        string bytes;               // raw copy of the n values
+    };
+    struct StringEntry{
+        string name;
+        string value;
+    };
+    struct FilterEntry{
+        int first_dataset;          // applies from this dataset on
+        int deflate;
+        bool shuffle;
+        bool szip;
+        int lossy_digits;
+    };
+    struct DatasetEntry{
+        string name;
+        PredType type;
+        int dimension;
+        BootesArray<double> data;   // snapshot, reused by the next frame
+    };
+
+    string fn_;
+    vector<AttributeEntry> attributes_;
+    vector<StringEntry> strings_;
+    vector<FilterEntry> filters_;
+    vector<DatasetEntry> datasets_;
+    int ndatasets_ = 0;             // entries of datasets_ in use; the rest keep their buffers
+
+    template<typename T>
+    void copy_dataset(BootesArray<T> &datain, string &name, PredType &hdf5_type, int dimension){
+        if (datain.dimension() != dimension){
+            throw 1;
+        }
+        if (ndatasets_ == (int) datasets_.size()){
+            datasets_.push_back({name, hdf5_type, dimension, BootesArray<double>()});
+        }
+        DatasetEntry &dset = datasets_[ndatasets_];
+        dset.name = name;
+        dset.type = hdf5_type;
+        dset.dimension = dimension;
+        if constexpr (is_same<T, double>::value){
+            dset.data = datain;     // copies into the existing buffer when the shape is unchanged
+        }
+        else {
+            widen(datain, dset.data);
+        }
+        ndatasets_ ++;
+    }
+
+    // out = (double) in, reusing the buffer of out when the shape is unchanged
+    template<typename T>
+    static void widen(BootesArray<T> &in, BootesArray<double> &out){
+        bool same = out.checkallocated() && out.dimension() == in.dimension();
+        for (int dd = 0; same && dd < in.dimension(); dd++){
+            same = (out.shape()[dd] == in.shape()[dd]);
+        }
+        if (!same){
+            int *s = in.shape();
+            if      (in.dimension() == 1){ out.NewBootesArray(s[0]); }
+            else if (in.dimension() == 2){ out.NewBootesArray(s[0], s[1]); }
+            else if (in.dimension() == 3){ out.NewBootesArray(s[0], s[1], s[2]); }
+            else if (in.dimension() == 4){ out.NewBootesArray(s[0], s[1], s[2], s[3]); }
+            else                         { out.NewBootesArray(s[0], s[1], s[2], s[3], s[4]); }
+        }
+        T *src = in.get_arr();
+        double *dst = out.get_arr();
+        for (int ii = 0; ii < in.arrsize(); ii++){
+            dst[ii] = src[ii];
+        }
+    }
+
+    void reset(string fn){
+        fn_ = fn;
+        attributes_.clear();
+        strings_.clear();
+        filters_.clear();
+        ndatasets_ = 0;
+    }
+};
+
+
+/** Writes OutputFrames on a background thread, so the time integration goes on while the previous
+ *  frame is flushed. There are nbuffer frames: acquire() blocks when all of them are still queued for
+ *  the disk, which bounds the memory and makes the solver wait if the disk falls behind. The HDF5
+ *  library is not thread safe, so once an AsyncOutput exists all HDF5 output should go through it. **/
+class AsyncOutput{
+    public:
+    AsyncOutput(int nbuffer = 2) : frames_(nbuffer){
+        for (auto &frame : frames_){
+            free_.push_back(&frame);
+        }
+        writer_ = thread(&AsyncOutput::writer_loop, this);
+    }
+
+    ~AsyncOutput(){
+        try {
+            finish();
+        }
+        catch (...) {
+            ;
+        }
+    }
+
+    // an empty frame for file fn; waits while all frames are queued
+    OutputFrame &acquire(string fn){
+        unique_lock<mutex> lock(mtx_);
+        cv_.wait(lock, [this]{ return !free_.empty() || error_; });
+        rethrow_error();
+        OutputFrame *frame = free_.front();
+        free_.pop_front();
+        frame->reset(fn);
+        return *frame;
+    }
+
+    // hand a filled frame to the writer thread
+    void submit(OutputFrame &frame){
+        {
+            lock_guard<mutex> lock(mtx_);
+            pending_.push_back(&frame);
+        }
+        cv_.notify_all();
+    }
+
+    // block until every submitted frame is on disk and stop the writer
+    void finish(){
+        {
+            lock_guard<mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (writer_.joinable()){
+            writer_.join();
+        }
+        rethrow_error();
+    }
+
+    private:
+    vector<OutputFrame> frames_;
+    deque<OutputFrame*> free_;
+    deque<OutputFrame*> pending_;
+    mutex mtx_;
+    condition_variable cv_;
+    bool stop_ = false;
+    exception_ptr error_;
+    thread writer_;
+
+    void writer_loop(){
+        while (true){
+            OutputFrame *frame;
+            {
+                unique_lock<mutex> lock(mtx_);
+                cv_.wait(lock, [this]{ return !pending_.empty() || stop_; });
+                if (pending_.empty()){
+                    return;
+                }
+                frame = pending_.front();
+                pending_.pop_front();
+            }
+            try {
+                frame->write();
+            }
+            catch (...) {
+                lock_guard<mutex> lock(mtx_);
+                error_ = current_exception();
+                cout << "output of " << frame->fn_ << " failed" << endl << flush;
+            }
+            {
+                lock_guard<mutex> lock(mtx_);
+                free_.push_back(frame);
+            }
+            cv_.notify_all();
+        }
+    }
+
+    // called with mtx_ held or after the writer stopped
+    void rethrow_error(){
+        if (error_){
+            exception_ptr error = error_;
+            error_ = nullptr;
+            rethrow_exception(error);
+        }
+    }
+};
+
+
+#endif // ASYNC_OUTPUT_HPP_
@@ -6,11 +6,15 @@
 #include <H5Cpp.h>
 #include <iostream>
 #include <string>
+#include <algorithm>
 #include "../BootesArray.hpp"
 
 using namespace std;
 using namespace H5;
 
+// upper bound of the chunk size of filtered datasets
+const hsize_t OUTPUT_CHUNK_BYTES = 1 << 20;
+
 class Output{
     public:
         Output(string fn, char mode){
@@ -58,7 +62,7 @@ class Output{
         hsize_t fdim[] = {FSPACE_DIM1}; // dim sizes of ds (on disk)
         DataSpace fspace( FSPACE_RANK, fdim );
 
-        DataSet* dataset = new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        DataSet* dataset = create_dataset(name, hdf5_type, fspace, FSPACE_RANK, fdim);
         /*
          * Select hyperslab for the dataset in the file, using 3x2 blocks,
          * (4,3) stride and (2,4) count starting at the position (0,1).
@@ -86,28 +90,12 @@ class Output{
     }
 
     void writeStringdataset(string &str, string dsetname){
-        const unsigned int FSPACE_DIM1 = str.size();
-        hsize_t         str_dimsf[1] {FSPACE_DIM1};
-        H5::DataSpace   dataspace(1, str_dimsf);
-
-        DataSpace fspace( 1, str_dimsf );
-        DataSpace mspace( 1, str_dimsf );
-
-        hsize_t start[1];  // Start of hyperslab
-        hsize_t stride[1]; // Stride of hyperslab
-        hsize_t count[1];  // Block count
-        hsize_t block[1];  // Block sizes
-        start[0]  = 0;
-        stride[0] = FSPACE_DIM1;
-        count[0]  = 1;
-        block[0]  = FSPACE_DIM1;
-        fspace.selectHyperslab( H5S_SELECT_SET, count, start, stride, block);
-        mspace.selectHyperslab( H5S_SELECT_SET, count, start, stride, block);
-
-        H5::StrType datatype(H5::PredType::C_S1, FSPACE_DIM1);
+        // one fixed-length string in a scalar dataspace
+        H5::StrType datatype(H5::PredType::C_S1, std::max((size_t) 1, str.size()));
+        H5::DataSpace dataspace(H5S_SCALAR);
         H5::DataSet *str_dataset = new DataSet(file_->createDataSet(dsetname, datatype, dataspace));
 
-        str_dataset->write(str, datatype, fspace, mspace);
+        str_dataset->write(str, datatype, dataspace, dataspace);
         delete str_dataset;
     }
 
@@ -124,7 +112,7 @@ class Output{
         hsize_t fdim[] = {FSPACE_DIM1, FSPACE_DIM2}; // dim sizes of ds (on disk)
         DataSpace fspace( FSPACE_RANK, fdim );
 
-        DataSet* dataset = new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        DataSet* dataset = create_dataset(name, hdf5_type, fspace, FSPACE_RANK, fdim);
         /*
          * Select hyperslab for the dataset in the file, using 3x2 blocks,
          * (4,3) stride and (2,4) count starting at the position (0,1).
@@ -170,7 +158,7 @@ class Output{
         hsize_t fdim[] = {FSPACE_DIM1, FSPACE_DIM2, FSPACE_DIM3}; // dim sizes of ds (on disk)
         DataSpace fspace( FSPACE_RANK, fdim );
 
-        DataSet* dataset = new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        DataSet* dataset = create_dataset(name, hdf5_type, fspace, FSPACE_RANK, fdim);
         /*
          * Select hyperslab for the dataset in the file, using 3x2 blocks,
          * (4,3) stride and (2,4) count starting at the position (0,1).
@@ -217,7 +205,7 @@ class Output{
         hsize_t fdim[] = {FSPACE_DIM1, FSPACE_DIM2, FSPACE_DIM3, FSPACE_DIM4}; // dim sizes of ds (on disk)
         DataSpace fspace( FSPACE_RANK, fdim );
 
-        DataSet* dataset = new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        DataSet* dataset = create_dataset(name, hdf5_type, fspace, FSPACE_RANK, fdim);
         /*
          * Select hyperslab for the dataset in the file, using 3x2 blocks,
          * (4,3) stride and (2,4) count starting at the position (0,1).
@@ -265,7 +253,7 @@ class Output{
         hsize_t fdim[] = {FSPACE_DIM1, FSPACE_DIM2, FSPACE_DIM3, FSPACE_DIM4, FSPACE_DIM5}; // dim sizes of ds (on disk)
         DataSpace fspace( FSPACE_RANK, fdim );
 
-        DataSet* dataset = new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        DataSet* dataset = create_dataset(name, hdf5_type, fspace, FSPACE_RANK, fdim);
         /*
          * Select hyperslab for the dataset in the file, using 3x2 blocks,
          * (4,3) stride and (2,4) count starting at the position (0,1).
@@ -297,6 +285,17 @@ class Output{
         delete dataset;
     }
 
+    /** Datasets created after this call are chunked and filtered.
+     *  deflate: gzip level 1-9 (0 off), shuffle: byte shuffle before deflate/szip, szip: szip instead of deflate,
+     *  lossy_digits: >= 0 keeps that many decimal digits with the scale-offset filter (lossy), applied to the
+     *  3D-5D datasets only so that the coordinates stay exact **/
+    void set_filters(int deflate, bool shuffle, bool szip, int lossy_digits){
+        deflate_ = deflate;
+        shuffle_ = shuffle;
+        szip_ = szip;
+        lossy_digits_ = lossy_digits;
+    }
+
     void close(){
         file_->close();
     }
@@ -309,6 +308,44 @@ class Output{
         string fn_;
         char mode_;
         H5File* file_;
+        int deflate_ = 0;
+        bool shuffle_ = false;
+        bool szip_ = false;
+        int lossy_digits_ = -1;
+
+    DataSet *create_dataset(string &name, PredType &hdf5_type, DataSpace &fspace, unsigned int rank, hsize_t *fdim){
+        bool lossy = (lossy_digits_ >= 0 && rank >= 3);
+        if (deflate_ <= 0 && !shuffle_ && !szip_ && !lossy){
+            return new DataSet(file_->createDataSet(name, hdf5_type, fspace));
+        }
+        // chunks of at most OUTPUT_CHUNK_BYTES, whole rows in x1: drop the leading dimensions first
+        hsize_t chunk[5];
+        hsize_t nbyte = hdf5_type.getSize();
+        for (unsigned int dd = 0; dd < rank; dd++){
+            chunk[dd] = std::max(fdim[dd], (hsize_t) 1);
+            nbyte *= chunk[dd];
+        }
+        for (unsigned int dd = 0; dd + 1 < rank && nbyte > OUTPUT_CHUNK_BYTES; dd++){
+            hsize_t rest = nbyte / chunk[dd];
+            chunk[dd] = std::max((hsize_t) 1, OUTPUT_CHUNK_BYTES / rest);
+            nbyte = rest * chunk[dd];
+        }
+        DSetCreatPropList plist;
+        plist.setChunk(rank, chunk);
+        if (lossy){
+            H5Pset_scaleoffset(plist.getId(), H5Z_SO_FLOAT_DSCALE, lossy_digits_);     // no C++ wrapper in HDF5 1.10
+        }
+        if (shuffle_){
+            plist.setShuffle();
+        }
+        if (szip_){
+            plist.setSzip(H5_SZIP_NN_OPTION_MASK, 32);
+        }
+        else if (deflate_ > 0){
+            plist.setDeflate(deflate_);
+        }
+        return new DataSet(file_->createDataSet(name, hdf5_type, fspace, plist));
+    }
 };
 
 
@@ -356,7 +393,7 @@ class ReadOutput{
     }
 
     template <typename T>
-    void get4Ddata(string DataSetName, unsigned int hdf5Start[4], unsigned int hdf5Select[4], unsigned int outputshape[4], BootesArray<double> &data_out){
+    void get4Ddata(string DataSetName, unsigned int hdf5Start[4], unsigned int hdf5Select[4], unsigned int outputshape[4], BootesArray<T> &data_out){
 
         DataSet dataset = file->openDataSet(DataSetName);
         H5T_class_t type_class = dataset.getTypeClass();
@@ -0,0 +1,122 @@
+#ifndef OUTPUT_OPTIONS_HPP_
+#define OUTPUT_OPTIONS_HPP_
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <set>
+#include <map>
+
+using namespace std;
+
+
+/** What goes into the output files and how it is stored, from the input file:
+ *    output_fields  = prim cons dprim dcons grav   fields of the frames written every output_dt
+ *    restart_dt     = 0                            > 0: also write restart frames (<pre>.rst.NNNNN.<aft>)
+ *    restart_fields = prim cons dprim dcons        fields of the restart frames
+ *    output_compression = none                     none, deflate or szip (lossless)
+ *    output_deflate_level = 4
+ *    output_shuffle = 1
+ *    output_lossy_digits = -1                      >= 0: scale-offset filter keeping that many decimal
+ *                                                  digits, analysis frames only (never restart frames)
+ *  Fields: prim, cons, dprim, dcons (dust), grav (potential and accelerations), coag (coagulation substeps
+ *  of each cell in the last step). The grid, the attributes and UserScalers are always written. **/
+class OutputOptions{
+    public:
+    set<string> output_fields  = {"prim", "cons", "dprim", "dcons", "grav"};
+    set<string> restart_fields = {"prim", "cons", "dprim", "dcons"};
+    double restart_dt = 0;
+    string compression = "none";
+    int deflate_level = 4;
+    bool shuffle = true;
+    int lossy_digits = -1;
+
+    // keys that are missing or empty keep the default
+    void setup_options(map<string, string> &choices){
+        if (!value(choices, "output_fields").empty()){
+            output_fields = parse_fields(value(choices, "output_fields"));
+        }
+        if (!value(choices, "restart_fields").empty()){
+            restart_fields = parse_fields(value(choices, "restart_fields"));
+        }
+        if (!value(choices, "restart_dt").empty()){
+            restart_dt = stod(value(choices, "restart_dt"));
+        }
+        if (restart_fields.count("cons") == 0){
+            cout << "restart_fields must contain cons" << endl << flush;
+            throw 1;
+        }
+        if (!value(choices, "output_compression").empty()){
+            compression = value(choices, "output_compression");
+            if (compression != "none" && compression != "deflate" && compression != "szip"){
+                cout << "\"output_compression = " << compression << "\" is not recognized, options are: none deflate szip" << endl << flush;
+                throw 1;
+            }
+        }
+        if (!value(choices, "output_deflate_level").empty()){
+            deflate_level = stoi(value(choices, "output_deflate_level"));
+        }
+        if (!value(choices, "output_shuffle").empty()){
+            shuffle = (stoi(value(choices, "output_shuffle")) != 0);
+        }
+        if (!value(choices, "output_lossy_digits").empty()){
+            lossy_digits = stoi(value(choices, "output_lossy_digits"));
+        }
+    }
+
+    // key -> value of every option, written to the output and read back on restart
+    map<string, string> names(){
+        map<string, string> out;
+        out["output_fields"] = join_fields(output_fields);
+        out["restart_fields"] = join_fields(restart_fields);
+        ostringstream dt;
+        dt.precision(17);
+        dt << restart_dt;
+        out["restart_dt"] = dt.str();
+        out["output_compression"] = compression;
+        out["output_deflate_level"] = to_string(deflate_level);
+        out["output_shuffle"] = to_string((int) shuffle);
+        out["output_lossy_digits"] = to_string(lossy_digits);
+        return out;
+    }
+
+    // filters for an analysis (restart = false) or restart frame
+    template<typename OUTPUT>
+    void apply_filters(OUTPUT &output, bool restart){
+        bool filtered = (compression != "none");
+        output.set_filters(compression == "deflate" ? deflate_level : 0,
+                           filtered && shuffle,
+                           compression == "szip",
+                           restart ? -1 : lossy_digits);
+    }
+
+    private:
+    static string value(map<string, string> &choices, string key){
+        auto it = choices.find(key);
+        return (it == choices.end()) ? "" : it->second;
+    }
+
+    static set<string> parse_fields(string list){
+        set<string> fields;
+        istringstream words(list);
+        for (string field; words >> field; ){
+            if (field != "prim" && field != "cons" && field != "dprim" && field != "dcons" && field != "grav" && field != "coag"){
+                cout << "output field \"" << field << "\" is not recognized, options are: prim cons dprim dcons grav coag" << endl << flush;
+                throw 1;
+            }
+            fields.insert(field);
+        }
+        return fields;
+    }
+
+    static string join_fields(set<string> &fields){
+        string out;
+        for (auto &field : fields){
+            out += (out.empty() ? "" : " ") + field;
+        }
+        return out;
+    }
+};
+
+
+#endif // OUTPUT_OPTIONS_HPP_
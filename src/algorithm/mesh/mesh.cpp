@@ -4,6 +4,55 @@
 #include "../gravity/gravity.hpp"
 #include "../../defs.hpp"
 #include <cmath>
+#include <omp.h>
+#include "../timeadvance/adv_hydro.hpp"
+
+#ifdef ENABLE_DUST_GRAINGROWTH
+    #include "../dust/graingrowth/coagulation.hpp"
+#endif // ENABLE_DUST_GRAINGROWTH
+
+
+static void first_touch(BootesArray<double> &arr){
+    // Zero the array with the same static schedule the flux kernels use over the trailing (z, y, x) block,
+    // so every page is first touched (and placed) by the thread that works on it later.
+    int dimension = arr.dimension();
+    int ncell = arr.shape()[dimension - 3] * arr.shape()[dimension - 2] * arr.shape()[dimension - 1];
+    int nouter = arr.arrsize() / ncell;
+    double *data = arr.get_arr();
+    for (int outer = 0; outer < nouter; outer ++){
+        #pragma omp parallel for schedule (static)
+        for (int cell = 0; cell < ncell; cell ++){
+            data[outer * ncell + cell] = 0.0;
+        }
+    }
+}
+
+// Keep the part of the whole-domain faces x1f, x2f and x3f that belongs to this rank's block (see
+// Decomposition) and set the zone counts and active ranges of the block. Slicing the global faces keeps the
+// grid bit-identical to a single-rank run.
+void mesh::setup_block(int numx1, int numx2, int numx3){
+    int start1, start2, start3;
+    decomp.block(0, numx1, nx1, start1);
+    decomp.block(1, numx2, nx2, start2);
+    decomp.block(2, numx3, nx3, start3);
+    x1s = ng1; x1l = nx1 + ng1;
+    x2s = ng2; x2l = nx2 + ng2;
+    x3s = ng3; x3l = nx3 + ng3;
+    BootesArray<double> *faces[3] = {&x1f, &x2f, &x3f};
+    int starts[3] = {start1, start2, start3};
+    int nfaces[3] = {nx1 + 2 * ng1 + 1, nx2 + 2 * ng2 + 1, nx3 + 2 * ng3 + 1};
+    for (int axis = 0; axis < 3; axis++){
+        if (nfaces[axis] == faces[axis]->shape()[0]){
+            continue;
+        }
+        BootesArray<double> whole = *faces[axis];
+        faces[axis]->NewBootesArray(nfaces[axis]);
+        for (int ii = 0; ii < nfaces[axis]; ii++){
+            (*faces[axis])(ii) = whole(starts[axis] + ii);
+        }
+    }
+}
+
 
 void mesh::SetupCartesian(int dimension,
                           double x1min, double x1max, int numx1, int ngh1,
@@ -18,10 +67,6 @@ void mesh::SetupCartesian(int dimension,
 
     dim = dimension;
     ng1 = ngh1;  ng2 = ngh2;  ng3 = ngh3;
-    nx1 = numx1; nx2 = numx2; nx3 = numx3;
-    x1s = ng1; x1l = numx1 + ng1;
-    x2s = ng2; x2l = numx2 + ng2;
-    x3s = ng3; x3l = numx3 + ng3;
     double dx1_num = (x1max - x1min) / numx1;
     double dx2_num = (x2max - x2min) / numx2;
     double dx3_num = (x3max - x3min) / numx3;
@@ -29,6 +74,7 @@ void mesh::SetupCartesian(int dimension,
     x1f = linspace(x1min - ng1 * dx1_num, x1max + ng1 * dx1_num, numx1 + 2 * ng1 + 1, true);
     x2f = linspace(x2min - ng2 * dx2_num, x2max + ng2 * dx2_num, numx2 + 2 * ng2 + 1, true);
     x3f = linspace(x3min - ng3 * dx3_num, x3max + ng3 * dx3_num, numx3 + 2 * ng3 + 1, true);
+    setup_block(numx1, numx2, numx3);
 
     x1v.NewBootesArray(x1f.shape()[0] - 1);
     x2v.NewBootesArray(x2f.shape()[0] - 1);
@@ -83,16 +129,12 @@ void mesh::SetupSphericalPolar(int dimension,
     // 1 - r; 2 - theta; 3 - phi
     dim = dimension;
     ng1 = ngh1;  ng2 = ngh2;  ng3 = ngh3;
-    nx1 = numx1; nx2 = numx2; nx3 = numx3;
-    x1s = ng1; x1l = numx1 + ng1;
-    x2s = ng2; x2l = numx2 + ng2;
-    x3s = ng3; x3l = numx3 + ng3;
     double dx2_num = (x2max - x2min) / numx2;
     double dx3_num = (x3max - x3min) / numx3;
     double mx1 = (x1max - x1min) * (1 - ratio1) / (1 - pow(ratio1, numx1 + 1));
 
     // step 1: setup boundary locations
-    x1f.NewBootesArray(nx1 + 2 * ng1 + 1);
+    x1f.NewBootesArray(numx1 + 2 * ng1 + 1);
     x1f(ng1) = x1min;
     for (int ng_ii = 1; ng_ii < ng1 + 1; ng_ii ++){
         x1f(ng1 - ng_ii) = x1f(ng1 - (ng_ii - 1)) - mx1 * pow(ratio1, ng_ii);
@@ -102,6 +144,7 @@ void mesh::SetupSphericalPolar(int dimension,
     }
     x2f = linspace(x2min - ng2 * dx2_num, x2max + ng2 * dx2_num, numx2 + 2 * ng2 + 1, true);
     x3f = linspace(x3min - ng3 * dx3_num, x3max + ng3 * dx3_num, numx3 + 2 * ng3 + 1, true);
+    setup_block(numx1, numx2, numx3);
 
     // step 2: setup cell center locations
     x1v.NewBootesArray(x1f.shape()[0] - 1);
@@ -216,7 +259,90 @@ void mesh::SetupSphericalPolar(int dimension,
 #if defined (ENABLE_DUSTFLUID)
 void mesh::setupDustFluidMesh(int NS){
     NUMSPECIES = NS;
-    dcons.NewBootesArray(NS, NUMCONS, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
-    dprim.NewBootesArray(NS, NUMPRIM, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+    dcons.NewDustArray(NS, NUMCONS, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+    dprim.NewDustArray(NS, NUMPRIM, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+
+    // scratch buffers for dust flux and drag
+    dvalsL.NewBootesArray(NS, 3, NUMCONS - 1, nx3 + 1, nx2 + 1, nx1 + 1);
+    dvalsR.NewBootesArray(NS, 3, NUMCONS - 1, nx3 + 1, nx2 + 1, nx1 + 1);
+    fdcons.NewBootesArray(NS, NUMCONS - 1, 3, nx3 + 1, nx2 + 1, nx1 + 1);
+    stoppingtime_mesh.NewBootesArray(NS, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+    first_touch(dvalsL);
+    first_touch(dvalsR);
+    first_touch(fdcons);
+    first_touch(stoppingtime_mesh);
+    if (modules.integrator != INTEGRATOR_EULER){
+        dcons_stage.NewDustArray(NS, NUMCONS, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+        dcons_stage.set_uniform(0.0);
+    }
+    dust_dt.NewBootesArray(NS);
+    dust_nsub.NewBootesArray(NS);
+    dust_dt.set_uniform(0.0);
+    dust_floor.NewBootesArray(NS);
+    dust_bc_species.NewBootesArray(NS);
+    for (int specIND = 0; specIND < NS; specIND ++){
+        dust_nsub(specIND) = 1;
+        dust_floor(specIND) = 0;
+    }
+    drag_work.NewBootesArray(omp_get_max_threads(), 11, nx1);
+
+    // grain properties from GrainSizeList and rhodm (set by setup_dust); the pair tables depend only on the
+    // sizes, so the collision kernels need not recompute them in every cell
+    GrainSizeTimesGrainDensity.NewBootesArray(NS);
+    GrainMassList.NewBootesArray(NS);
+    for (int specIND = 0; specIND < NS; specIND ++){
+        GrainSizeTimesGrainDensity(specIND) = GrainSizeList(specIND) * rhodm;
+        GrainMassList(specIND) = 4. / 3. * M_PI * pow(GrainSizeList(specIND), 3) * rhodm;
+    }
+    GrainPairCrossSection.NewBootesArray(NS, NS);
+    GrainPairMassSum.NewBootesArray(NS, NS);
+    for (int j = 0; j < NS; j ++){
+        for (int k = 0; k < NS; k ++){
+            GrainPairCrossSection(j, k) = M_PI * (GrainSizeList(j) + GrainSizeList(k)) * (GrainSizeList(j) + GrainSizeList(k));
+            GrainPairMassSum(j, k) = GrainMassList(j) + GrainMassList(k);
+        }
+    }
+    #ifdef ENABLE_DUST_GRAINGROWTH
+        setup_grain_growth(*this);
+    #endif // ENABLE_DUST_GRAINGROWTH
 }
 #endif
+
+
+void mesh::setupScratchArrays(){
+    // buffers used by first_order() every cycle; allocated here once instead of on every call
+    if (modules.flux_pass == FLUX_PASS_AXIS){
+        valsL.NewBootesArray(3, NUMCONS, nx3 + 1, nx2 + 1, nx1 + 1);
+        valsR.NewBootesArray(3, NUMCONS, nx3 + 1, nx2 + 1, nx1 + 1);
+        first_touch(valsL);
+        first_touch(valsR);
+        // PPM, WENO5 and the primitive variables only reconstruct rows, calc_flux_axis scatters them from one
+        // pair of rows per thread
+        if (modules.reconstruction == RECON_PPM || modules.reconstruction == RECON_WENO5 || modules.recon_variables != RECON_VARS_CONSERVED){
+            flux_tile.NewBootesArray(omp_get_max_threads(), 2, NUMCONS, nx1 + 2);
+            flux_tile.set_uniform(0.0);
+        }
+    }
+    else {
+        flux_tile.NewBootesArray(omp_get_max_threads(), FLUX_TILE_ROWS, NUMCONS, FLUX_X1_BLOCK + 2);
+        flux_tile.set_uniform(0.0);
+    }
+    if (modules.recon_variables != RECON_VARS_CONSERVED){
+        cs.NewBootesArray(x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+        cs.set_uniform(0.0);
+    }
+    // calc_flux never writes the fluxes of unused axes, they keep the zeros of first_touch
+    fcons.NewBootesArray(NUMCONS, 3, nx3 + 1, nx2 + 1, nx1 + 1);
+    first_touch(fcons);
+    if (modules.integrator != INTEGRATOR_EULER){
+        cons_stage.NewBootesArray(NUMCONS, x3v.shape()[0], x2v.shape()[0], x1v.shape()[0]);
+        cons_stage.set_uniform(0.0);
+    }
+    #ifdef ENABLE_FUSED_HYDRO
+        du.NewBootesArray(NUMCONS, nx3, nx2, nx1);
+        first_touch(du);
+        // rows of unused axes are never written and must stay zero
+        pencil.NewBootesArray(omp_get_max_threads(), FUSED_PENCIL_ROWS, NUMCONS, FUSED_X1_BLOCK + 2);
+        pencil.set_uniform(0.0);
+    #endif // ENABLE_FUSED_HYDRO
+}
@@ -3,12 +3,34 @@
 #include "../BootesArray.hpp"
 #include "../gravity/gravity.hpp"
 #include "../physical_constants.hpp"
+#include "../modules.hpp"
+#include "../mpi/decomposition.hpp"
+#include "../dust/dust_array.hpp"
+#include "../../defs.hpp"
+
+
+/** storage type of the state arrays (see STORAGE PRECISION in defs.hpp). Values are read into double
+ *  before any arithmetic, so only the bytes moved to and from memory change. **/
+#ifdef ENABLE_FLOAT_STATE
+typedef float state_real;
+#else
+typedef double state_real;
+#endif // ENABLE_FLOAT_STATE
+#if defined (ENABLE_FLOAT_STATE) || defined (ENABLE_FLOAT_DUST_PRIM)
+typedef float dprim_real;
+#else
+typedef double dprim_real;
+#endif // defined (ENABLE_FLOAT_STATE) || defined (ENABLE_FLOAT_DUST_PRIM)
 
 
 class mesh{
     public:
         /** consts **/
         PhysicalConst pconst;
+        /** Riemann solver, reconstruction and boundaries chosen in the input file **/
+        PhysicsModules modules;
+        /** block of the domain held by this MPI rank (the whole domain without ENABLE_MPI) **/
+        Decomposition decomp;
         /** grid **/
         int dim;
         BootesArray<double> x1v;       // cell center (1D array)
@@ -36,10 +58,10 @@ class mesh{
         BootesArray<double> geo_sp;         // sin(tp)
         BootesArray<double> rsq;            // r^2
 
-        double minx1, maxx1, minx2, maxx2, minx3, maxx3, ratio_dim1;
+        double minx1, maxx1, minx2, maxx2, minx3, maxx3, ratio_dim1;   // whole domain
         int x1s, x2s, x3s;                     // start index of active domain
         int x1l, x2l, x3l;                     // end index of active domain
-        int nx1, nx2, nx3;                     // number of active zones in each direction
+        int nx1, nx2, nx3;                     // number of active zones in each direction (of this rank's block)
         int ng1, ng2, ng3;                     // number of ghost zones in each direction, implement for 2D and 1D simulation
 
         double hydro_gamma;
@@ -53,10 +75,10 @@ class mesh{
         double dminDensity = 0;              // dust min density, default set to 0
 
         /** cons **/
-        BootesArray<double> cons;            // 4D (5, z, y, x)
+        BootesArray<state_real> cons;        // 4D (5, z, y, x)
 
         /** prim **/
-        BootesArray<double> prim;            // 4D (5, z, y, x)
+        BootesArray<state_real> prim;        // 4D (5, z, y, x)
 
         /** multi-fluid for dust **/
         int NUMSPECIES;
@@ -65,8 +87,10 @@ class mesh{
         BootesArray<double> GrainSizeList;              // size of dust grains. (1D array)
         BootesArray<double> GrainMassList;              // mass of dust grains. (1D array)
         BootesArray<double> GrainSizeTimesGrainDensity; // rhodm * s
-        BootesArray<double> dcons;
-        BootesArray<double> dprim;
+        BootesArray<double> GrainPairCrossSection;      // pi * (s_j + s_k)^2 of each pair of species. (2D array)
+        BootesArray<double> GrainPairMassSum;           // m_j + m_k of each pair of species. (2D array)
+        DustArray<state_real> dcons;                    // 5D (NUMSPECIES, 5, z, y, x), stored as set by ENABLE_DUST_CELL_MAJOR
+        DustArray<dprim_real> dprim;                    // 5D (NUMSPECIES, 5, z, y, x)
 
         /** grav **/
         #if defined (ENABLE_GRAVITY)
@@ -77,6 +101,48 @@ class mesh{
             BootesArray<double> nu_vis;
         #endif // ENABLE_VISCOSITY
 
+        /** scratch buffers for the time integration, sized once at setup and reused every cycle **/
+        BootesArray<double> valsL;              // 5D (axis, 5, nx3 + 1, nx2 + 1, nx1 + 1), left state of each face (flux_pass = axis only)
+        BootesArray<double> valsR;              // 5D (axis, 5, nx3 + 1, nx2 + 1, nx1 + 1), right state of each face (flux_pass = axis only)
+        BootesArray<double> flux_tile;          // 4D (thread, FLUX_TILE_ROWS, 5, FLUX_X1_BLOCK + 2), per thread face states (flux_pass = tiled; (thread, 2, 5, nx1 + 2) for axis with row reconstruction)
+        BootesArray<state_real> cs;             // 3D (z, y, x), sound speed of prim, ghost zones included (reconstruction_variables = primitive, characteristic only)
+        BootesArray<double> fcons;              // 5D (5, axis, nx3 + 1, nx2 + 1, nx1 + 1), flux of conservative variables
+        BootesArray<state_real> cons_stage;     // 4D (5, z, y, x), cons at the start of the step (integrator = rk2, rk3 only)
+        #ifdef ENABLE_FUSED_HYDRO
+            BootesArray<double> du;                 // 4D (5, nx3, nx2, nx1), cons update of the fused kernel
+            BootesArray<double> pencil;             // 4D (thread, FUSED_PENCIL_ROWS, 5, FUSED_X1_BLOCK + 2), per thread pencil rows
+        #endif // ENABLE_FUSED_HYDRO
+        #if defined (ENABLE_DUSTFLUID)
+            BootesArray<double> dvalsL;             // 6D (NUMSPECIES, axis, 4, nx3 + 1, nx2 + 1, nx1 + 1)
+            BootesArray<double> dvalsR;             // 6D (NUMSPECIES, axis, 4, nx3 + 1, nx2 + 1, nx1 + 1)
+            BootesArray<double> fdcons;             // 6D (NUMSPECIES, 4, axis, nx3 + 1, nx2 + 1, nx1 + 1)
+            BootesArray<double> stoppingtime_mesh;  // 4D (NUMSPECIES, z, y, x)
+            DustArray<state_real> dcons_stage;      // 5D (NUMSPECIES, 5, z, y, x), dcons at the start of the step (integrator = rk2, rk3 only)
+            int dust_max_subcycles = 1;             // most substeps a species may take in one gas step ("dust_max_subcycles")
+            BootesArray<double> dust_dt;            // 1D (NUMSPECIES), CFL time step of each species, set by timestep()
+            BootesArray<int> dust_nsub;             // 1D (NUMSPECIES), substeps of each species in this step
+            int dust_substep = 0;                   // substep being taken; species with dust_nsub <= dust_substep are done
+            int dust_floor_skip = 0;                // leave out the species at the floor ("dust_floor_skip", see find_floor_species)
+            BootesArray<int> dust_floor;            // 1D (NUMSPECIES), 1 if the species is at the floor and takes no step
+            BootesArray<int> dust_bc_species;       // 1D (NUMSPECIES), species the dust boundary conditions are applied to
+            BootesArray<double> drag_work;          // 3D (thread, 11, nx1), per thread rows of dust_gas_drag with dust_drag = implicit
+            #ifdef ENABLE_DUST_GRAINGROWTH
+                BootesArray<int> coag_lo;           // 2D (NUMSPECIES, NUMSPECIES), the merger of species j and k goes to bins coag_lo and coag_hi
+                BootesArray<int> coag_hi;           // 2D (NUMSPECIES, NUMSPECIES)
+                BootesArray<double> coag_wlo;       // 2D (NUMSPECIES, NUMSPECIES), coag_lo grains per unit merged mass (eps and pair weight included)
+                BootesArray<double> coag_whi;       // 2D (NUMSPECIES, NUMSPECIES), the same for coag_hi
+                BootesArray<double> coag_work;      // 3D (thread, 9 + 2 * NUMSPECIES, NUMSPECIES), per thread workspace of grain_growth
+                BootesArray<double> coag_substeps;  // 3D (z, y, x), coagulation substeps of each cell in the last step
+                double coag_tol = 1e-3;             // dust mass fraction a coagulation substep may get wrong ("coagulation_tol")
+                BootesArray<int> coag_active;       // 1D (nx3 * nx2 * nx1), 1 where grain_growth works this step
+                BootesArray<int> coag_cells;        // 1D (nx3 * nx2 * nx1), flat active index of those cells, in order
+                double coag_min_density = 0;        // dust density below which a cell is dormant ("coagulation_min_density")
+                double coag_skip = 0;               // dormant if coagulation is estimated to move less of the dust mass in dt ("coagulation_skip")
+                BootesArray<double> coag_rate;      // 3D (z, y, x), last measured dust mass fraction moved per unit dust density, time and velocity spread
+                int coag_step = 0;                  // calls of grain_growth so far
+            #endif // ENABLE_DUST_GRAINGROWTH
+        #endif // defined (ENABLE_DUSTFLUID)
+
         /** setup grid functions **/
         void SetupCartesian(int dimension,
                             double x1min, double x1max, int numx1, int ngh1,
@@ -86,9 +152,11 @@ class mesh{
                                  double x1min, double x1max, int numx1, double ratio1, int ngh1,
                                  double x2min, double x2max, int numx2,                int ngh2,
                                  double x3min, double x3max, int numx3,                int ngh3);
+        void setup_block(int numx1, int numx2, int numx3);
         #if defined (ENABLE_DUSTFLUID)
-            void setupDustFluidMesh(int NS);
+            void setupDustFluidMesh(int NS);    // needs GrainSizeList and rhodm
         #endif
+        void setupScratchArrays();              // called once after the grid setup
 
         /** user-defined miscellous quantities **/
         BootesArray<double> UserScalers;
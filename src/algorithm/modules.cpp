@@ -0,0 +1,138 @@
+#include "modules.hpp"
+#include "../defs.hpp"
+#include <iostream>
+
+
+using namespace std;
+
+static const char *riemann_names[] = {"hll", "hlle", "hllc", "roe"};
+static const char *recon_names[]   = {"const", "minmod", "MUSCL_Hancock", "PPM", "WENO5"};
+// the states of the first ghost zone reach as far as the stencil, one zone more than its radius; at least 2,
+// which the dust reconstruction and the other kernels assume
+static const int recon_ghost_zones[] = {2, 2, 2, 3, 3};
+static const char *recon_vars_names[] = {"conserved", "primitive", "characteristic"};
+static const char *integrator_names[] = {"euler", "rk2", "rk3"};
+static const char *flux_pass_names[]  = {"axis", "tiled"};
+static const char *bc_names[]      = {"standard", "periodic", "reflective", "outflow", "polar"};
+static const char *face_names[]    = {"x1i", "x1o", "x2i", "x2o", "x3i", "x3o"};
+static const char *dust_riemann_names[] = {"donor", "hll"};
+static const char *drag_names[]    = {"explicit", "exponential", "implicit"};
+static const char *switch_names[]  = {"off", "on"};
+
+
+// index of name in list, or throw if it is not one of the n options
+static int lookup(map<string, string> &choices, string key, const char **list, int n, int current){
+    auto it = choices.find(key);
+    if (it == choices.end() || it->second.empty()){
+        return current;
+    }
+    for (int ii = 0; ii < n; ii++){
+        if (it->second == list[ii]){
+            return ii;
+        }
+    }
+    cout << "\"" << key << " = " << it->second << "\" is not recognized, options are:";
+    for (int ii = 0; ii < n; ii++){
+        cout << " " << list[ii];
+    }
+    cout << endl << flush;
+    throw 1;
+}
+
+
+void PhysicsModules::setup_modules(map<string, string> &choices){
+    riemann_solver = lookup(choices, "riemann_solver", riemann_names, 4, riemann_solver);
+    reconstruction = lookup(choices, "reconstruction", recon_names, 5, reconstruction);
+    recon_variables = lookup(choices, "reconstruction_variables", recon_vars_names, 3, recon_variables);
+    integrator     = lookup(choices, "integrator", integrator_names, 3, integrator);
+    flux_pass      = lookup(choices, "flux_pass", flux_pass_names, 2, flux_pass);
+    for (int face = 0; face < 6; face++){
+        bc[face]      = lookup(choices, string("bc_") + face_names[face], bc_names, NUMBCTYPES, bc[face]);
+        dust_bc[face] = lookup(choices, string("dust_bc_") + face_names[face], bc_names, NUMBCTYPES, dust_bc[face]);
+        // the pole only exists in x2; dust has standard and reflective boundaries only
+        if (bc[face] == BC_POLAR && face != BX2I && face != BX2O){
+            cout << "polar boundary is only available for x2 faces" << endl << flush;
+            throw 1;
+        }
+        if (dust_bc[face] != BC_STANDARD && dust_bc[face] != BC_REFLECTIVE){
+            cout << "dust_bc_" << face_names[face] << " must be standard or reflective" << endl << flush;
+            throw 1;
+        }
+    }
+    // dust has no MUSCL_Hancock, the first two reconstructions only
+    dust_reconstruction = lookup(choices, "dust_reconstruction", recon_names, 2, dust_reconstruction);
+    dust_riemann_solver = lookup(choices, "dust_riemann_solver", dust_riemann_names, 2, dust_riemann_solver);
+    dust_drag     = lookup(choices, "dust_drag", drag_names, 3, dust_drag);
+    dust_feedback = lookup(choices, "dust_feedback", switch_names, 2, dust_feedback);
+    // the explicit drag is unstable once the gas feels dense dust
+    if (dust_feedback && dust_drag == DRAG_EXPLICIT){
+        cout << "dust_feedback = on needs dust_drag = exponential or implicit" << endl << flush;
+        throw 1;
+    }
+    // PPM and WENO5 give the states at the start of the step, the Runge-Kutta stages do the time integration
+    if ((reconstruction == RECON_PPM || reconstruction == RECON_WENO5) && integrator == INTEGRATOR_EULER){
+        cout << "reconstruction = " << recon_names[reconstruction] << " needs integrator = rk2 or rk3" << endl << flush;
+        throw 1;
+    }
+    // the Hancock half step of MUSCL_Hancock advances the conserved face states
+    if (reconstruction == RECON_MHM && recon_variables != RECON_VARS_CONSERVED){
+        cout << "reconstruction = MUSCL_Hancock needs reconstruction_variables = conserved" << endl << flush;
+        throw 1;
+    }
+    #ifdef ENABLE_FUSED_HYDRO
+    if (riemann_solver != RIEMANN_HLLE || reconstruction != RECON_MINMOD || recon_variables != RECON_VARS_CONSERVED){
+        cout << "ENABLE_FUSED_HYDRO only supports reconstruction = minmod, reconstruction_variables = conserved and riemann_solver = hlle" << endl << flush;
+        throw 1;
+    }
+    // the fused kernel traces the face states over the step, which the Runge-Kutta stages must not do
+    if (integrator != INTEGRATOR_EULER){
+        cout << "ENABLE_FUSED_HYDRO only supports integrator = euler" << endl << flush;
+        throw 1;
+    }
+    #endif // ENABLE_FUSED_HYDRO
+}
+
+
+int PhysicsModules::ghost_zones(){
+    return recon_ghost_zones[reconstruction];
+}
+
+
+map<string, string> PhysicsModules::names(){
+    map<string, string> out;
+    out["riemann_solver"] = riemann_names[riemann_solver];
+    out["reconstruction"] = recon_names[reconstruction];
+    out["reconstruction_variables"] = recon_vars_names[recon_variables];
+    out["integrator"]     = integrator_names[integrator];
+    out["flux_pass"]      = flux_pass_names[flux_pass];
+    for (int face = 0; face < 6; face++){
+        out[string("bc_") + face_names[face]]      = bc_names[bc[face]];
+        out[string("dust_bc_") + face_names[face]] = bc_names[dust_bc[face]];
+    }
+    out["dust_reconstruction"] = recon_names[dust_reconstruction];
+    out["dust_riemann_solver"] = dust_riemann_names[dust_riemann_solver];
+    out["dust_drag"]     = drag_names[dust_drag];
+    out["dust_feedback"] = switch_names[dust_feedback];
+    return out;
+}
+
+
+void PhysicsModules::print(){
+    cout << "riemann solver: " << riemann_names[riemann_solver] << ", reconstruction: " << recon_names[reconstruction]
+         << " (" << recon_vars_names[recon_variables] << " variables), integrator: " << integrator_names[integrator] << ", flux pass: " << flux_pass_names[flux_pass] << endl;
+    cout << "boundaries:";
+    for (int face = 0; face < 6; face++){
+        cout << " " << face_names[face] << "=" << bc_names[bc[face]];
+    }
+    cout << endl;
+    #ifdef ENABLE_DUSTFLUID
+    cout << "dust boundaries:";
+    for (int face = 0; face < 6; face++){
+        cout << " " << face_names[face] << "=" << bc_names[dust_bc[face]];
+    }
+    cout << endl;
+    cout << "dust riemann solver: " << dust_riemann_names[dust_riemann_solver] << ", dust reconstruction: " << recon_names[dust_reconstruction] << endl;
+    cout << "dust drag: " << drag_names[dust_drag] << ", feedback on the gas: " << switch_names[dust_feedback] << endl;
+    #endif // ENABLE_DUSTFLUID
+    cout << flush;
+}
@@ -0,0 +1,48 @@
+#ifndef MODULES_HPP_
+#define MODULES_HPP_
+#include <map>
+#include <string>
+
+
+/** Physics modules chosen from the input file at startup. The kernels are instantiated for every choice,
+ *  so the selection costs one switch per kernel call, not per cell. Coordinates and the problem
+ *  generator are still chosen at compile time (defs.hpp and main.cpp). **/
+
+enum RiemannSolver:int{RIEMANN_HLL=0, RIEMANN_HLLE=1, RIEMANN_HLLC=2, RIEMANN_ROE=3};
+enum Reconstruction:int{RECON_CONST=0, RECON_MINMOD=1, RECON_MHM=2, RECON_PPM=3, RECON_WENO5=4};
+enum ReconVariables:int{RECON_VARS_CONSERVED=0, RECON_VARS_PRIMITIVE=1, RECON_VARS_CHARACTERISTIC=2};
+enum DustRiemannSolver:int{DUST_RIEMANN_DONOR=0, DUST_RIEMANN_HLL=1};
+enum Integrator:int{INTEGRATOR_EULER=0, INTEGRATOR_RK2=1, INTEGRATOR_RK3=2};
+enum FluxPass:int{FLUX_PASS_AXIS=0, FLUX_PASS_TILED=1};
+enum DustDrag:int{DRAG_EXPLICIT=0, DRAG_EXPONENTIAL=1, DRAG_IMPLICIT=2};
+enum BoundaryType:int{BC_STANDARD=0, BC_PERIODIC=1, BC_REFLECTIVE=2, BC_OUTFLOW=3, BC_POLAR=4};
+const int NUMBCTYPES = 5;
+enum BoundaryFace:int{BX1I=0, BX1O=1, BX2I=2, BX2O=3, BX3I=4, BX3O=5};
+
+
+class PhysicsModules{
+public:
+    // defaults are the modules that used to be hard-coded
+    int riemann_solver = RIEMANN_HLLE;
+    int reconstruction = RECON_MINMOD;
+    int recon_variables = RECON_VARS_CONSERVED;    // what the reconstruction limits: conserved, primitive or characteristic variables
+    int integrator = INTEGRATOR_EULER;             // time_integrate: one Euler stage or SSP Runge-Kutta stages
+    int flux_pass  = FLUX_PASS_TILED;              // calc_flux: all axes in one sweep over cache tiles, or one sweep per axis
+    int bc[6]      = {BC_STANDARD, BC_STANDARD, BC_PERIODIC,   BC_PERIODIC,   BC_REFLECTIVE, BC_STANDARD};
+    int dust_bc[6] = {BC_STANDARD, BC_STANDARD, BC_REFLECTIVE, BC_REFLECTIVE, BC_REFLECTIVE, BC_STANDARD};
+    int dust_reconstruction = RECON_CONST;          // RECON_CONST or RECON_MINMOD
+    int dust_riemann_solver = DUST_RIEMANN_DONOR;
+    int dust_drag = DRAG_EXPLICIT;
+    int dust_feedback = 0;          // 1: the drag also acts on the gas
+
+    // choices: key -> name, e.g. "riemann_solver" -> "hllc"; keys that are missing or empty keep the default
+    void setup_modules(std::map<std::string, std::string> &choices);
+    // ghost zones the reconstruction needs along every active axis, see main.cpp
+    int ghost_zones();
+    // key -> name of every current choice, to be written to the output and read back on restart
+    std::map<std::string, std::string> names();
+    void print();
+};
+
+
+#endif // MODULES_HPP_
@@ -0,0 +1,93 @@
+#include "decomposition.hpp"
+#include "../modules.hpp"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+
+using namespace std;
+
+
+void Decomposition::block(int axis, int n, int &nlocal, int &start){
+    // the first n % dims blocks get one zone more
+    int base = n / dims[axis];
+    int rem  = n % dims[axis];
+    nlocal = base + (coords[axis] < rem ? 1 : 0);
+    start  = coords[axis] * base + min(coords[axis], rem);
+}
+
+
+void Decomposition::setup(int dimension, int numx1, int numx2, int numx3, int ng[3], int bc[6]){
+    int n[3] = {numx1, numx2, numx3};
+    for (int axis = 0; axis < 3; axis++){
+        nx_global[axis] = n[axis];
+    }
+    #ifdef ENABLE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    // layout with the smallest halo area; every block needs at least ng active zones along a split axis,
+    // since its ghost zones are copied from the active zones of one neighbour
+    double best = numeric_limits<double>::max();
+    for (int p1 = 1; p1 <= nranks; p1++){
+        for (int p2 = 1; p1 * p2 <= nranks; p2++){
+            if (nranks % (p1 * p2) != 0){
+                continue;
+            }
+            int p[3] = {p1, p2, nranks / (p1 * p2)};
+            bool valid = true;
+            double area = 0;
+            for (int axis = 0; axis < 3; axis++){
+                if (p[axis] == 1){
+                    continue;
+                }
+                valid = valid && axis < dimension && n[axis] / p[axis] >= max(ng[axis], 1);
+                area += (double) p[axis] * n[(axis + 1) % 3] * n[(axis + 2) % 3];
+            }
+            if (valid && area < best){
+                best = area;
+                for (int axis = 0; axis < 3; axis++){
+                    dims[axis] = p[axis];
+                }
+            }
+        }
+    }
+    if (best == numeric_limits<double>::max()){
+        if (rank == 0){
+            cout << "cannot split " << numx1 << " x " << numx2 << " x " << numx3 << " zones over " << nranks << " ranks" << endl << flush;
+        }
+        throw 1;
+    }
+
+    int periods[3];
+    for (int axis = 0; axis < 3; axis++){
+        bool periodic_i = (bc[2 * axis] == BC_PERIODIC);
+        bool periodic_o = (bc[2 * axis + 1] == BC_PERIODIC);
+        if (dims[axis] > 1 && periodic_i != periodic_o){
+            if (rank == 0){
+                cout << "a split axis must be periodic at both faces or at neither" << endl << flush;
+            }
+            throw 1;
+        }
+        periods[axis] = periodic_i && periodic_o;
+    }
+    MPI_Cart_create(MPI_COMM_WORLD, 3, dims, periods, 0, &comm);
+    MPI_Cart_coords(comm, rank, 3, coords);
+    for (int axis = 0; axis < 3; axis++){
+        MPI_Cart_shift(comm, axis, 1, &neighbour[2 * axis], &neighbour[2 * axis + 1]);
+        // one block along a periodic axis wraps onto itself: the periodic boundary condition does that locally
+        for (int face = 2 * axis; face < 2 * axis + 2; face++){
+            if (neighbour[face] == MPI_PROC_NULL || dims[axis] == 1){
+                neighbour[face] = -1;
+            }
+        }
+    }
+    if (rank == 0){
+        cout << "MPI: " << nranks << " ranks as " << dims[0] << " x " << dims[1] << " x " << dims[2] << " blocks" << endl << flush;
+    }
+    #endif // ENABLE_MPI
+    for (int axis = 0; axis < 3; axis++){
+        int nlocal;
+        block(axis, n[axis], nlocal, offset[axis]);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef DECOMPOSITION_HPP_
+#define DECOMPOSITION_HPP_
+
+#include <vector>
+#include "../../defs.hpp"
+
+#ifdef ENABLE_MPI
+    #include <mpi.h>
+#endif // ENABLE_MPI
+
+
+/** Cartesian block decomposition of the active domain over the MPI ranks. Each rank owns a block of
+ *  nx[axis] active zones with its own ghost zones; local index l of the mesh arrays is global index
+ *  l + offset[axis] (ghost zones included), so a block is a window of the whole-domain arrays. Ghost zones
+ *  at faces with a neighbour are filled by halo_exchange, the others by the boundary conditions.
+ *  Without ENABLE_MPI, and until setup() is called, there is one block covering the whole domain. **/
+class Decomposition{
+    public:
+        int rank = 0;
+        int nranks = 1;
+        int dims[3]      = {1, 1, 1};               // number of blocks along x1, x2, x3
+        int coords[3]    = {0, 0, 0};               // position of this block
+        int nx_global[3] = {0, 0, 0};               // active zones of the whole domain
+        int offset[3]    = {0, 0, 0};               // global active index of the first active zone of this block
+        int neighbour[6] = {-1, -1, -1, -1, -1, -1};// rank across each face (BoundaryFace order), -1 at the domain boundary
+        #ifdef ENABLE_MPI
+            MPI_Comm comm = MPI_COMM_WORLD;
+            std::vector<char> sendbuf[6];           // halo buffers, grown on demand and reused
+            std::vector<char> recvbuf[6];
+            std::vector<char> gatherbuf;
+        #endif // ENABLE_MPI
+
+        // choose the block layout for the ranks of MPI_COMM_WORLD; bc: boundary type of each face (PhysicsModules::bc)
+        void setup(int dimension, int numx1, int numx2, int numx3, int ng[3], int bc[6]);
+        // active zones and offset of this block along axis for n zones in the whole domain
+        void block(int axis, int n, int &nlocal, int &start);
+
+        bool is_root(){ return rank == 0; }
+        // true if the ghost zones of this face are set by the boundary condition, false if they come from a neighbour
+        bool physical_face(int face){ return neighbour[face] < 0; }
+        // true if this face lies on the boundary of the whole domain (its neighbour, if any, is across a periodic wrap)
+        bool domain_face(int face){ return coords[face / 2] == ((face % 2 == 0) ? 0 : dims[face / 2] - 1); }
+};
+
+
+#endif // DECOMPOSITION_HPP_
@@ -0,0 +1,189 @@
+#include "halo_exchange.hpp"
+#include "../mesh/mesh.hpp"
+#include <type_traits>
+
+
+#ifdef ENABLE_MPI
+
+template<typename T>
+static MPI_Datatype mpi_type(){
+    return std::is_same<T, float>::value ? MPI_FLOAT : MPI_DOUBLE;
+}
+
+
+// copy the box [lo, hi) (x1, x2, x3 order) of the trailing three axes of quan, for every leading index,
+// to (to_buffer) or from a contiguous buffer
+template<typename T>
+static void copy_box(BootesArray<T> &quan, int lo[3], int hi[3], T *buf, bool to_buffer){
+    int dimension = quan.dimension();
+    int Nx = quan.shape()[dimension - 1];
+    int Ny = quan.shape()[dimension - 2];
+    int Nz = quan.shape()[dimension - 3];
+    int nouter = quan.arrsize() / (Nx * Ny * Nz);
+    int nx = hi[0] - lo[0];
+    int ny = hi[1] - lo[1];
+    int nz = hi[2] - lo[2];
+    T *data = quan.get_arr();
+    #pragma omp parallel for collapse(3) schedule (static)
+    for (int outer = 0; outer < nouter; outer++){
+        for (int kk = 0; kk < nz; kk++){
+            for (int jj = 0; jj < ny; jj++){
+                T *row = data + (((size_t) outer * Nz + kk + lo[2]) * Ny + jj + lo[1]) * Nx + lo[0];
+                T *brow = buf + (((size_t) outer * nz + kk) * ny + jj) * nx;
+                if (to_buffer){
+                    for (int ii = 0; ii < nx; ii++){ brow[ii] = row[ii]; }
+                }
+                else {
+                    for (int ii = 0; ii < nx; ii++){ row[ii] = brow[ii]; }
+                }
+            }
+        }
+    }
+}
+
+
+template<typename T>
+void halo_exchange(mesh &m, BootesArray<T> &quan, bool periodic){
+    Decomposition &dc = m.decomp;
+    bool exchange[6];
+    for (int face = 0; face < 6; face++){
+        exchange[face] = !dc.physical_face(face) && (periodic || !dc.domain_face(face));
+    }
+    int xs[3] = {m.x1s, m.x2s, m.x3s};
+    int xl[3] = {m.x1l, m.x2l, m.x3l};
+    int ng[3] = {m.ng1, m.ng2, m.ng3};
+    int nouter = quan.arrsize() / (quan.shape()[quan.dimension() - 1] * quan.shape()[quan.dimension() - 2] * quan.shape()[quan.dimension() - 3]);
+    // several values per x1 zone (dust stored cell-major): the x1 ranges are that many times longer
+    int inner = quan.shape()[quan.dimension() - 1] / (m.nx1 + 2 * m.ng1);
+    xs[0] *= inner;
+    xl[0] *= inner;
+    ng[0] *= inner;
+
+    // face f: the ghost layers of f are received from neighbour[f], the active layers next to f are sent to it,
+    // where they fill the ghost layers of its face f ^ 1 (the tag is the face of the receiver)
+    int send_lo[6][3], send_hi[6][3], recv_lo[6][3], recv_hi[6][3];
+    size_t count[6];
+    MPI_Request requests[12];
+    int nrequest = 0;
+    for (int face = 0; face < 6; face++){
+        if (!exchange[face]){
+            continue;
+        }
+        int axis = face / 2;
+        count[face] = nouter;
+        for (int ax = 0; ax < 3; ax++){
+            send_lo[face][ax] = recv_lo[face][ax] = xs[ax];
+            send_hi[face][ax] = recv_hi[face][ax] = xl[ax];
+            if (ax != axis){
+                count[face] *= xl[ax] - xs[ax];
+            }
+        }
+        count[face] *= ng[axis];
+        if (face % 2 == 0){
+            recv_lo[face][axis] = xs[axis] - ng[axis];  recv_hi[face][axis] = xs[axis];
+            send_lo[face][axis] = xs[axis];             send_hi[face][axis] = xs[axis] + ng[axis];
+        }
+        else {
+            recv_lo[face][axis] = xl[axis];             recv_hi[face][axis] = xl[axis] + ng[axis];
+            send_lo[face][axis] = xl[axis] - ng[axis];  send_hi[face][axis] = xl[axis];
+        }
+        dc.sendbuf[face].resize(count[face] * sizeof(T));
+        dc.recvbuf[face].resize(count[face] * sizeof(T));
+        MPI_Irecv(dc.recvbuf[face].data(), count[face], mpi_type<T>(), dc.neighbour[face], face, dc.comm, &requests[nrequest++]);
+    }
+    for (int face = 0; face < 6; face++){
+        if (!exchange[face]){
+            continue;
+        }
+        copy_box(quan, send_lo[face], send_hi[face], (T *) dc.sendbuf[face].data(), true);
+        MPI_Isend(dc.sendbuf[face].data(), count[face], mpi_type<T>(), dc.neighbour[face], face ^ 1, dc.comm, &requests[nrequest++]);
+    }
+    MPI_Waitall(nrequest, requests, MPI_STATUSES_IGNORE);
+    for (int face = 0; face < 6; face++){
+        if (exchange[face]){
+            copy_box(quan, recv_lo[face], recv_hi[face], (T *) dc.recvbuf[face].data(), false);
+        }
+    }
+}
+
+
+template<typename T>
+void gather_blocks(mesh &m, BootesArray<T> &quan, BootesArray<T> &global){
+    Decomposition &dc = m.decomp;
+    int dimension = quan.dimension();
+    int ncell[3] = {m.nx1, m.nx2, m.nx3};
+    int ng[3]    = {m.ng1, m.ng2, m.ng3};
+
+    // box of this block in local (lo, hi) and whole-domain (box[0..2], box[3..5]) indices; face-centred
+    // axes have one point more than the zones, the last block keeps it
+    int lo[3], hi[3], box[6], gshape[3];
+    for (int axis = 0; axis < 3; axis++){
+        int extent = quan.shape()[dimension - 1 - axis];
+        int face_centred = extent - (ncell[axis] + 2 * ng[axis]);
+        lo[axis] = (dc.coords[axis] == 0) ? 0 : ng[axis];
+        hi[axis] = (dc.coords[axis] == dc.dims[axis] - 1) ? extent : ng[axis] + ncell[axis];
+        box[axis]     = lo[axis] + dc.offset[axis];
+        box[axis + 3] = hi[axis] + dc.offset[axis];
+        gshape[axis] = dc.nx_global[axis] + 2 * ng[axis] + face_centred;
+    }
+    int nouter = quan.arrsize() / (quan.shape()[dimension - 1] * quan.shape()[dimension - 2] * quan.shape()[dimension - 3]);
+
+    if (!dc.is_root()){
+        size_t boxsize = (size_t) (hi[0] - lo[0]) * (hi[1] - lo[1]) * (hi[2] - lo[2]);
+        dc.gatherbuf.resize(boxsize * nouter * sizeof(T));
+        T *buf = (T *) dc.gatherbuf.data();
+        copy_box(quan, lo, hi, buf, true);
+        MPI_Send(box, 6, MPI_INT, 0, 0, dc.comm);
+        // one message per leading index keeps the counts within int for large blocks
+        for (int outer = 0; outer < nouter; outer++){
+            MPI_Send(buf + outer * boxsize, boxsize, mpi_type<T>(), 0, 1, dc.comm);
+        }
+        return;
+    }
+
+    // rank 0: whole-domain array with the leading axes of quan
+    int *s = quan.shape();
+    bool same = global.checkallocated() && global.dimension() == dimension;
+    for (int axis = 0; same && axis < 3; axis++){
+        same = (global.shape()[dimension - 1 - axis] == gshape[axis]);
+    }
+    for (int dd = 0; same && dd < dimension - 3; dd++){
+        same = (global.shape()[dd] == s[dd]);
+    }
+    if (!same){
+        if      (dimension == 3){ global.NewBootesArray(gshape[2], gshape[1], gshape[0]); }
+        else if (dimension == 4){ global.NewBootesArray(s[0], gshape[2], gshape[1], gshape[0]); }
+        else                    { global.NewBootesArray(s[0], s[1], gshape[2], gshape[1], gshape[0]); }
+    }
+
+    for (int rank = 0; rank < dc.nranks; rank++){
+        int rbox[6];
+        if (rank == 0){
+            for (int ii = 0; ii < 6; ii++){ rbox[ii] = box[ii]; }
+        }
+        else {
+            MPI_Recv(rbox, 6, MPI_INT, rank, 0, dc.comm, MPI_STATUS_IGNORE);
+        }
+        size_t boxsize = (size_t) (rbox[3] - rbox[0]) * (rbox[4] - rbox[1]) * (rbox[5] - rbox[2]);
+        dc.gatherbuf.resize(boxsize * nouter * sizeof(T));
+        T *buf = (T *) dc.gatherbuf.data();
+        if (rank == 0){
+            copy_box(quan, lo, hi, buf, true);
+        }
+        else {
+            for (int outer = 0; outer < nouter; outer++){
+                MPI_Recv(buf + outer * boxsize, boxsize, mpi_type<T>(), rank, 1, dc.comm, MPI_STATUS_IGNORE);
+            }
+        }
+        copy_box(global, rbox, rbox + 3, buf, false);
+    }
+}
+
+
+// the state arrays are stored in double or float (ENABLE_FLOAT_STATE / ENABLE_FLOAT_DUST_PRIM)
+template void halo_exchange<double>(mesh &, BootesArray<double> &, bool);
+template void halo_exchange<float>(mesh &, BootesArray<float> &, bool);
+template void gather_blocks<double>(mesh &, BootesArray<double> &, BootesArray<double> &);
+template void gather_blocks<float>(mesh &, BootesArray<float> &, BootesArray<float> &);
+
+#endif // ENABLE_MPI
@@ -0,0 +1,26 @@
+#ifndef HALO_EXCHANGE_HPP_
+#define HALO_EXCHANGE_HPP_
+
+#include "../BootesArray.hpp"
+
+
+class mesh;
+
+
+/** fill the ghost zones of quan (trailing axes (z, y, x), any leading axes) at the faces that have a
+ *  neighbouring block with the neighbour's active zones. Like the boundary kernels, only the face ghost
+ *  zones are set (the active range of the other two axes), all six faces in one round of messages.
+ *  periodic = false leaves the faces on the domain boundary to the boundary condition even where the
+ *  hydro boundary is periodic (dust has no periodic boundary). The last axis may hold several values per x1 zone
+ *  in a row, as the cell-major dust storage (DustArray::storage()) does. **/
+template<typename T>
+void halo_exchange(mesh &m, BootesArray<T> &quan, bool periodic = true);
+
+/** copy the block of every rank into global, the whole-domain array on rank 0. Each block contributes its
+ *  active zones and the ghost zones at the domain boundary. Face-centred arrays (one more point along an
+ *  axis) are handled too. global is allocated on rank 0 if its shape is wrong and not touched elsewhere. **/
+template<typename T>
+void gather_blocks(mesh &m, BootesArray<T> &quan, BootesArray<T> &global);
+
+
+#endif // HALO_EXCHANGE_HPP_
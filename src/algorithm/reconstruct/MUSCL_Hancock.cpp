@@ -7,7 +7,7 @@
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
 
-void MHM(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR){
+void MHM(const double &quanp1, const double &quan, const double &quanm1, const double &dx_axis, const double &dt, const double &Vui, const double &acs, double &BquanL, double &BquanR){
     double w = 0.0;
     double Dim = quan - quanm1; // Toro 13.28
     double Dip = quanp1 - quan;
@@ -131,3 +131,41 @@ void reconstruct_MHM(mesh &m,
     }
 }
 
+
+
+void reconstruct_MHM_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> prim(m.prim);
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    int IMP = IM1 + axis;
+    int shift = x1excess + x2excess * cons.stride(2) + x3excess * cons.stride(1);
+
+    const state_real *q[NUMCONS];
+    for (int var = 0; var < NUMCONS; var++){
+        q[var] = cons.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+    }
+    const state_real *pres  = prim.ptr(IPN, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *vaxis = prim.ptr(IV1 + axis, m.x3s + kk, m.x2s + jj) + m.x1s;
+    for (int ii = is; ii < ie; ii++){
+        double dx_axis;
+        #if defined(CARTESIAN_COORD)
+            if      (axis == 0) { dx_axis = m.dx1(ii + x1excess); }
+            else if (axis == 1) { dx_axis = m.dx2(jj + x2excess); }
+            else                { dx_axis = m.dx3(kk + x3excess); }
+        #elif defined(SPHERICAL_POLAR_COORD)
+            if      (axis == 0) { dx_axis = m.dx1p(kk + x3excess, jj + x2excess, ii + x1excess); }
+            else if (axis == 1) { dx_axis = m.dx2p(kk + x3excess, jj + x2excess, ii + x1excess); }
+            else                { dx_axis = m.dx3p(kk + x3excess, jj + x2excess, ii + x1excess); }
+        #else
+            # error need coordinate defined
+        #endif
+        double cs  = soundspeed(q[IDN][ii], pres[ii], m.hydro_gamma);
+        double a   = std::max(cs + vaxis[ii], cs - vaxis[ii]);
+        double Vui = vel(q[IMP][ii], q[IDN][ii]);
+        for (int var = 0; var < NUMCONS; var++){
+            MHM(q[var][ii + shift], q[var][ii], q[var][ii - shift], dx_axis, dt, Vui, a, BL[var][ii - is], BR[var][ii - is]);
+        }
+    }
+}
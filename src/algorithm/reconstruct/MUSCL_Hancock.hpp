@@ -17,4 +17,9 @@ void reconstruct_MHM(mesh &m,
                    );
 
 
+// Left (BL) and right (BR) MUSCL-Hancock states of the cells ii in [is, ie) of the row (kk, jj) along axis,
+// written to BL[var][ii - is] as in reconstruct_minmod_row. Gives the same values as reconstruct_MHM.
+void reconstruct_MHM_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
 #endif
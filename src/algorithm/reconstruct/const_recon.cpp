@@ -7,7 +7,7 @@
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
 
-void const_recon(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR){
+void const_recon(const double &quanp1, const double &quan, const double &quanm1, const double &dx_axis, const double &dt, const double &Vui, const double &acs, double &BquanL, double &BquanR){
     BquanL = quan;
     BquanR = quan;
 }
@@ -123,3 +123,15 @@ void reconstruct_const(mesh &m,
     }
 }
 
+
+
+void reconstruct_const_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    BootesView<state_real, 4> cons(m.cons);
+    for (int var = 0; var < NUMCONS; var++){
+        const state_real *q = cons.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+        for (int ii = is; ii < ie; ii++){
+            BL[var][ii - is] = q[ii];
+            BR[var][ii - is] = q[ii];
+        }
+    }
+}
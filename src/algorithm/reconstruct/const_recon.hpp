@@ -19,4 +19,8 @@ void reconstruct_const(mesh &m,
                        );
 
 
+// States of the cells ii in [is, ie) of the row (kk, jj), written to BL[var][ii - is] as in reconstruct_minmod_row
+void reconstruct_const_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
 #endif
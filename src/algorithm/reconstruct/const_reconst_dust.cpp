@@ -6,6 +6,7 @@
 #include "../mesh/mesh.hpp"
 
 
+#ifdef ENABLE_DUSTFLUID
 void reconstruct_dust_const(mesh &m,
                             BootesArray<double> &valsL,
                             BootesArray<double> &valsR,
@@ -20,6 +21,9 @@ void reconstruct_dust_const(mesh &m,
         for (int kk = -x3excess; kk < m.nx3 + x3excess; kk++){
             for (int jj = -x2excess; jj < m.nx2 + x2excess; jj++){
                 for (int ii = -x1excess; ii < m.nx1 + x1excess; ii++){
+                    if (m.dust_nsub(specIND) <= m.dust_substep){
+                        continue;               // species done with its substeps (see first_order)
+                    }
                     // Left of a cell is the right of an edge.
                     if (kk == -1 || jj == -1 || ii == -1){
                         ;
@@ -46,3 +50,4 @@ void reconstruct_dust_const(mesh &m,
     }
 }
 
+#endif // ENABLE_DUSTFLUID
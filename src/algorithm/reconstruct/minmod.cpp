@@ -6,8 +6,9 @@
 #include "../../defs.hpp"
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
+#include <cmath>
 
-void minmod(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR){
+void minmod(const double &quanp1, const double &quan, const double &quanm1, const double &dx_axis, const double &dt, const double &Vui, const double &acs, double &BquanL, double &BquanR){
     double w = 0.0;
     double Dim = quan - quanm1; // Toro 13.28
     double Dip = quanp1 - quan;
@@ -29,7 +30,7 @@ void minmod(double &quanp1, double &quan, double &quanm1, double &dx_axis, doubl
 }
 
 
-void minmodc0(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR){
+void minmodc0(const double &quanp1, const double &quan, const double &quanm1, const double &dx_axis, const double &dt, const double &Vui, const double &acs, double &BquanL, double &BquanR){
     double w = 0.0;
     double Dim = quan - quanm1;                                                // Toro 13.28
     double Dip = quanp1 - quan;
@@ -48,6 +49,53 @@ void minmodc0(double &quanp1, double &quan, double &quanm1, double &dx_axis, dou
 }
 
 
+// minmod reconstruction of all conserved variables of cell ii in the rows q (one row per variable).
+// mom is the momentum row along the axis, shift the distance to the neighbouring cell along the axis.
+static void minmod_cell(state_real * const *q, state_real *mom, state_real *pres, state_real *vaxis,
+                        int ii, int shift,
+                        double dx_axis, double dt, double gamma,
+                        double *BL, double *BR){
+    double cs  = sqrt(gamma * pres[ii] / q[IDN][ii]);                  // soundspeed()
+    double a   = std::max(cs + vaxis[ii], cs - vaxis[ii]);
+    double Vui = (double) mom[ii] / q[IDN][ii];                        // vel()
+    minmod(q[IDN][ii + shift], q[IDN][ii], q[IDN][ii - shift], dx_axis, dt, Vui, a, BL[IDN], BR[IDN]);
+    minmod(q[IM1][ii + shift], q[IM1][ii], q[IM1][ii - shift], dx_axis, dt, Vui, a, BL[IM1], BR[IM1]);
+    minmod(q[IM2][ii + shift], q[IM2][ii], q[IM2][ii - shift], dx_axis, dt, Vui, a, BL[IM2], BR[IM2]);
+    minmod(q[IM3][ii + shift], q[IM3][ii], q[IM3][ii - shift], dx_axis, dt, Vui, a, BL[IM3], BR[IM3]);
+    minmod(q[IEN][ii + shift], q[IEN][ii], q[IEN][ii - shift], dx_axis, dt, Vui, a, BL[IEN], BR[IEN]);
+}
+
+
+// Row pointers of the cell row (kk, jj) (relative to the first active cell) used by minmod_cell,
+// and the cell width along the axis, dxrow[dxstep * ii].
+static void minmod_row_setup(mesh &m, BootesView<state_real, 4> &cons, BootesView<state_real, 4> &prim,
+                             int axis, int IMP, int kk, int jj,
+                             int x1excess, int x2excess, int x3excess,
+                             state_real **q, state_real *&mom, state_real *&pres, state_real *&vaxis,
+                             const double *&dxrow, int &dxstep){
+    for (int var = 0; var < NUMCONS; var++){
+        q[var] = cons.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+    }
+    mom   = q[IMP];
+    pres  = prim.ptr(IPN, m.x3s + kk, m.x2s + jj) + m.x1s;
+    vaxis = prim.ptr(IV1 + axis, m.x3s + kk, m.x2s + jj) + m.x1s;
+    #if defined(CARTESIAN_COORD)
+        if      (axis == 0) { dxrow = m.dx1.get_arr() + x1excess; dxstep = 1; }
+        else if (axis == 1) { dxrow = &m.dx2(jj + x2excess);      dxstep = 0; }
+        else                { dxrow = &m.dx3(kk + x3excess);      dxstep = 0; }
+    #elif defined(SPHERICAL_POLAR_COORD)
+        BootesView<double, 3> dxp;
+        if      (axis == 0) { dxp = BootesView<double, 3>(m.dx1p); }
+        else if (axis == 1) { dxp = BootesView<double, 3>(m.dx2p); }
+        else                { dxp = BootesView<double, 3>(m.dx3p); }
+        dxrow = dxp.ptr(kk + x3excess, jj + x2excess) + x1excess;
+        dxstep = 1;
+    #else
+        # error need coordinate defined
+    #endif
+}
+
+
 void reconstruct_minmod(mesh &m,
                    BootesArray<double> &valsL,
                    BootesArray<double> &valsR,
@@ -56,105 +104,76 @@ void reconstruct_minmod(mesh &m,
                    int &IMP,
                    double &dt
                    ){
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> prim(m.prim);
+    BootesView<double, 5> vL(valsL);
+    BootesView<double, 5> vR(valsR);
+    int shift = x1excess + x2excess * cons.stride(2) + x3excess * cons.stride(1);
+    double gamma = m.hydro_gamma;
+
     // Computation starts in first ghost zone, for first active cell left boundary flux
-    double zero = 0;
-    #pragma omp parallel for collapse (3) schedule (static)
+    #pragma omp parallel for collapse (2) schedule (static)
     for (int kk = -x3excess; kk < m.nx3 + x3excess; kk++){
         for (int jj = -x2excess; jj < m.nx2 + x2excess; jj++){
-            for (int ii = -x1excess; ii < m.nx1 + x1excess; ii++){
-                double dx_axis, a;
-                double cs = soundspeed(m.cons(IDN, m.x3s + kk, m.x2s + jj, m.x1s + ii), m.prim(IPN, m.x3s + kk, m.x2s + jj, m.x1s + ii), m.hydro_gamma);
-                #if defined(CARTESIAN_COORD)
-                    if      (axis == 0) { dx_axis = m.dx1(ii+x1excess); a = std::max(cs + m.prim(IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                    else if (axis == 1) { dx_axis = m.dx2(jj+x2excess); a = std::max(cs + m.prim(IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                    else                { dx_axis = m.dx3(kk+x3excess); a = std::max(cs + m.prim(IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                #elif defined(SPHERICAL_POLAR_COORD)
-                    if      (axis == 0) {
-                        dx_axis = m.dx1p(kk + x3excess, jj + x2excess, ii+x1excess);
-                        a = std::max(cs + m.prim(IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                    }
-                    else if (axis == 1) {
-                        dx_axis = m.dx2p(kk + x3excess, jj + x2excess, ii+x1excess);
-                        a = std::max(cs + m.prim(IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                    }
-                    else                {
-                        dx_axis = m.dx3p(kk + x3excess, jj + x2excess, ii+x1excess);
-                        a = std::max(cs + m.prim(IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii), cs - m.prim(IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                    }
-                #else
-                    # error need coordinate defined
-                #endif
-
-                /** speeds **/
-                double Vui   = vel(m.cons(IMP, m.x3s + kk, m.x2s + jj, m.x1s + ii),
-                                  m.cons(IDN, m.x3s + kk, m.x2s + jj, m.x1s + ii)
-                                  );
-                /** conservatives **/
-                double BrhoL, BrhoR;
-                minmod(m.cons(IDN, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                       m.cons(IDN, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                       m.cons(IDN, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                       dx_axis, dt,
-                       Vui, a,
-                       BrhoL,
-                       BrhoR);
-                double Bm1L, Bm1R;
-                minmod(m.cons(IM1, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                       m.cons(IM1, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                       m.cons(IM1, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                       dx_axis, dt,
-                       Vui, a,
-                       Bm1L,
-                       Bm1R);
-                double Bm2L, Bm2R;
-                minmod(m.cons(IM2, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                       m.cons(IM2, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                       m.cons(IM2, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                       dx_axis, dt,
-                       Vui, a,
-                       Bm2L,
-                       Bm2R);
-                double Bm3L, Bm3R;
-                minmod(m.cons(IM3, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                       m.cons(IM3, m.x3s + kk, m.x2s + jj, m.x1s + ii),
-                       m.cons(IM3, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                       dx_axis, dt,
-                       Vui, a,
-                       Bm3L,
-                       Bm3R);
-                double BeneL, BeneR;
-                minmod(m.cons(IEN, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                       m.cons(IEN, m.x3s + kk, m.x2s + jj, m.x1s + ii),
-                       m.cons(IEN, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                       dx_axis, dt,
-                       Vui, a,
-                       BeneL,
-                       BeneR);
-
-                // Left of a cell is the right of an edge.
-                if (kk == -1 || jj == -1 || ii == -1){
-                    ;
-                }
-                else {
-                    valsR(axis, IDN, kk, jj, ii) = BrhoL;
-                    valsR(axis, IM1, kk, jj, ii) = Bm1L;
-                    valsR(axis, IM2, kk, jj, ii) = Bm2L;
-                    valsR(axis, IM3, kk, jj, ii) = Bm3L;
-                    valsR(axis, IEN, kk, jj, ii) = BeneL;
-                }
-
-                if (kk == m.nx3 || jj == m.nx2 || ii == m.nx1){
-                    ;
-                }
-                else{
-                    valsL(axis, IDN, kk + x3excess, jj + x2excess, ii + x1excess) = BrhoR;
-                    valsL(axis, IM1, kk + x3excess, jj + x2excess, ii + x1excess) = Bm1R;
-                    valsL(axis, IM2, kk + x3excess, jj + x2excess, ii + x1excess) = Bm2R;
-                    valsL(axis, IM3, kk + x3excess, jj + x2excess, ii + x1excess) = Bm3R;
-                    valsL(axis, IEN, kk + x3excess, jj + x2excess, ii + x1excess) = BeneR;
-                }
+            state_real *q[NUMCONS];
+            double *fR[NUMCONS];
+            double *fL[NUMCONS];
+            state_real *mom, *pres, *vaxis;
+            const double *dxrow;        // dx along the axis: dxrow[dxstep * ii]
+            int dxstep;
+            minmod_row_setup(m, cons, prim, axis, IMP, kk, jj, x1excess, x2excess, x3excess,
+                             q, mom, pres, vaxis, dxrow, dxstep);
+
+            // Left of a cell is the right of an edge.
+            bool storeR = !(kk == -1 || jj == -1);
+            bool storeL = !(kk == m.nx3 || jj == m.nx2);
+            for (int var = 0; var < NUMCONS; var++){
+                fR[var] = storeR ? vR.ptr(axis, var, kk, jj) : nullptr;
+                fL[var] = storeL ? vL.ptr(axis, var, kk + x3excess, jj + x2excess) + x1excess : nullptr;
+            }
+
+            double BL[NUMCONS], BR[NUMCONS];
+            // ghost cells at both ends of the row only contribute one side of a face
+            if (x1excess){
+                int ii = -1;
+                minmod_cell(q, mom, pres, vaxis, ii, shift, dxrow[dxstep * ii], dt, gamma, BL, BR);
+                if (storeL){ for (int var = 0; var < NUMCONS; var++){ fL[var][ii] = BR[var]; } }
+                ii = m.nx1;
+                minmod_cell(q, mom, pres, vaxis, ii, shift, dxrow[dxstep * ii], dt, gamma, BL, BR);
+                if (storeR){ for (int var = 0; var < NUMCONS; var++){ fR[var][ii] = BL[var]; } }
+            }
+            for (int ii = 0; ii < m.nx1; ii++){
+                minmod_cell(q, mom, pres, vaxis, ii, shift, dxrow[dxstep * ii], dt, gamma, BL, BR);
+                if (storeR){ for (int var = 0; var < NUMCONS; var++){ fR[var][ii] = BL[var]; } }
+                if (storeL){ for (int var = 0; var < NUMCONS; var++){ fL[var][ii] = BR[var]; } }
             }
         }
     }
 }
 
+
+void reconstruct_minmod_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> prim(m.prim);
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    int IMP = IM1 + axis;
+    int shift = x1excess + x2excess * cons.stride(2) + x3excess * cons.stride(1);
+
+    state_real *q[NUMCONS];
+    state_real *mom, *pres, *vaxis;
+    const double *dxrow;
+    int dxstep;
+    minmod_row_setup(m, cons, prim, axis, IMP, kk, jj, x1excess, x2excess, x3excess,
+                     q, mom, pres, vaxis, dxrow, dxstep);
+
+    double cBL[NUMCONS], cBR[NUMCONS];
+    for (int ii = is; ii < ie; ii++){
+        minmod_cell(q, mom, pres, vaxis, ii, shift, dxrow[dxstep * ii], dt, m.hydro_gamma, cBL, cBR);
+        for (int var = 0; var < NUMCONS; var++){
+            BL[var][ii - is] = cBL[var];
+            BR[var][ii - is] = cBR[var];
+        }
+    }
+}
@@ -9,7 +9,7 @@
 class mesh;
 
 
-void minmod(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR);
+void minmod(const double &quanp1, const double &quan, const double &quanm1, const double &dx_axis, const double &dt, const double &Vui, const double &acs, double &BquanL, double &BquanR);
 
 
 void reconstruct_minmod(mesh &m,
@@ -22,4 +22,10 @@ void reconstruct_minmod(mesh &m,
                    );
 
 
+// Left (BL) and right (BR) minmod states of the cells ii in [is, ie) of the row (kk, jj) along axis,
+// written to BL[var][ii - is]; indices are relative to the first active cell, as in reconstruct_minmod.
+// Gives the same values as reconstruct_minmod, for the fused hydro kernel.
+void reconstruct_minmod_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
 #endif
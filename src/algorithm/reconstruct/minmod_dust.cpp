@@ -1,135 +1,121 @@
-#ifndef MINMOD_RECONSTRUCT_DUST_HPP_
-#define MINMOD_RECONSTRUCT_DUST_HPP_
-
 #include "minmod_dust.hpp"
+#include "minmod.hpp"
+
 #include "../BootesArray.hpp"
-#include "../eos/momentum.hpp"
 #include "../../defs.hpp"
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
+#include <cstddef>
+#include <cmath>
+
 
-void minmod_dust(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR){
-    double w = 0.0;
-    double Dim = quan - quanm1; // Toro 13.28
-    double Dip = quanp1 - quan;
-    double Di = 0.5 * (1. + w) * Dim + 0.5 * (1. - w) * Dip;                   // Toro 13.27, 14.37
-    double Dib; // 14.44
-    double beta = 1.;
-    if (Dip > 0.){
-        Dib = std::max(std::max((double) 0., std::min(beta * Dim, Dip)), std::min(Dim, beta * Dip));
+#ifdef ENABLE_DUSTFLUID
+// minmod states of cell ii of the density row rho and the velocity rows vel (IV1..IV3); xstep is the distance
+// to the next cell of the row, shift the distance to the neighbouring cell along the axis (IVP: its velocity).
+// Pressureless MUSCL-Hancock: the slopes are traced over half a step with the velocity of the cell
+// (Toro 13.33, as in reconstruct_minmod), and the density also gets the compression term -dt/2 rho dv,
+// unless that would make a face density negative. The traced densities lie between the densities of the
+// neighbouring cells as long as the species CFL number is below 1, so they are positive.
+static void minmod_dust_cell(const state_real *rho, const dprim_real * const *vel, int IVP,
+                             int ii, size_t xstep, size_t shift,
+                             double dx_axis, double dts,
+                             double *BL, double *BR){
+    ptrdiff_t at = (ptrdiff_t) ii * xstep;
+    ptrdiff_t sh = shift;
+    double Vui = vel[IVP][at];
+    double acs = std::abs(Vui);
+    double rhoL, rhoR, vL[3], vR[3];
+    minmod(rho[at + sh], rho[at], rho[at - sh], dx_axis, dts, Vui, acs, rhoL, rhoR);
+    for (int dd = 0; dd < 3; dd++){
+        minmod(vel[dd][at + sh], vel[dd][at], vel[dd][at - sh], dx_axis, dts, Vui, acs, vL[dd], vR[dd]);
     }
-    else{
-        Dib = std::min(std::min((double) 0., std::max(beta * Dim, Dip)), std::max(Dim, beta * Dip));
+    double drho = - 0.5 * dts / dx_axis * rho[at] * (vR[IVP] - vL[IVP]);
+    if (rhoL + drho > 0 && rhoR + drho > 0){
+        rhoL += drho;
+        rhoR += drho;
+    }
+    BL[IDN] = rhoL;
+    BR[IDN] = rhoR;
+    for (int dd = 0; dd < 3; dd++){
+        BL[IM1 + dd] = rhoL * vL[dd];
+        BR[IM1 + dd] = rhoR * vR[dd];
     }
-    double c = acs * dt / dx_axis;
-    if (Vui > 0)     { ; }
-    else if (Vui < 0){ c = -c; }
-    else             { c = 0; }           // Vui = 0;
-    BquanL = quan - 0.5 * (1 + c) * Dib;                // Toro 13.33
-    BquanR = quan + 0.5 * (1 - c) * Dib;                // Toro 13.33
 }
 
 
-void reconstruct_dust(mesh &m,
-                   BootesArray<double> &valsL,
-                   BootesArray<double> &valsR,
-                   int &x1excess, int &x2excess, int &x3excess,
-                   int &axis,
-                   int &IMP,
-                   double &dt
-                   ){
+void reconstruct_dust_minmod(mesh &m,
+                             BootesArray<double> &valsL,
+                             BootesArray<double> &valsR,
+                             int &x1excess, int &x2excess, int &x3excess,
+                             int &axis,
+                             int &IMP,
+                             double &dt
+                             ){
+    BootesView<double, 6> vL(valsL);
+    BootesView<double, 6> vR(valsR);
+    // dcons and dprim have the same shape, hence the same strides in either layout (dust_array.hpp)
+    size_t xstep = m.dcons.stride(4);
+    size_t shift = x1excess * m.dcons.stride(4) + x2excess * m.dcons.stride(3) + x3excess * m.dcons.stride(2);
+    int IVP = IMP - IM1;
+
     // Computation starts in first ghost zone, for first active cell left boundary flux
-    double zero = 0;
     #pragma omp parallel for collapse (3) schedule (static)
     for (int specIND = 0; specIND < m.NUMSPECIES; specIND++){
         for (int kk = -x3excess; kk < m.nx3 + x3excess; kk++){
             for (int jj = -x2excess; jj < m.nx2 + x2excess; jj++){
-                for (int ii = -x1excess; ii < m.nx1 + x1excess; ii++){
-                    double dx_axis, a;
-                    #if defined(CARTESIAN_COORD)
-                        if      (axis == 0) { dx_axis = m.dx1(ii+x1excess); a = std::max(m.dprim(specIND, IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                        else if (axis == 1) { dx_axis = m.dx2(jj+x2excess); a = std::max(m.dprim(specIND, IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                        else                { dx_axis = m.dx3(kk+x3excess); a = std::max(m.dprim(specIND, IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii));}
-                    #elif defined(SPHERICAL_POLAR_COORD)
-                        if      (axis == 0) {
-                            dx_axis = m.dx1p(kk + x3excess, jj + x2excess, ii+x1excess);
-                            a = std::max(m.dprim(specIND, IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV1, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                        }
-                        else if (axis == 1) {
-                            dx_axis = m.dx2p(kk + x3excess, jj + x2excess, ii+x1excess);
-                            a = std::max(m.dprim(specIND, IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV2, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                        }
-                        else                {
-                            dx_axis = m.dx3p(kk + x3excess, jj + x2excess, ii+x1excess);
-                            a = std::max(m.dprim(specIND, IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii), - m.dprim(specIND, IV3, m.x3s + kk, m.x2s + jj, m.x1s + ii));
-                        }
-                    #else
-                        # error need coordinate defined
-                    #endif
-
-                    /** speeds **/
-                    double Vui   = vel(m.dcons(specIND, IMP, m.x3s + kk, m.x2s + jj, m.x1s),
-                                       m.dcons(specIND, IDN, m.x3s + kk, m.x2s + jj, m.x1s)
-                                       );
-                    /** dconservatives **/
-                    double BrhoL, BrhoR;
-                    minmod_dust(m.dcons(specIND, IDN, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                                m.dcons(specIND, IDN, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                                m.dcons(specIND, IDN, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                                dx_axis, dt,
-                                Vui, a,
-                                BrhoL,
-                                BrhoR);
-                    double Bm1L, Bm1R;
-                    minmod_dust(m.dcons(specIND, IM1, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                                m.dcons(specIND, IM1, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                                m.dcons(specIND, IM1, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                                dx_axis, dt,
-                                Vui, a,
-                                Bm1L,
-                                Bm1R);
-                    double Bm2L, Bm2R;
-                    minmod_dust(m.dcons(specIND, IM2, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                                m.dcons(specIND, IM2, m.x3s + kk,            m.x2s + jj,            m.x1s + ii),
-                                m.dcons(specIND, IM2, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                                dx_axis, dt,
-                                Vui, a,
-                                Bm2L,
-                                Bm2R);
-                    double Bm3L, Bm3R;
-                    minmod_dust(m.dcons(specIND, IM3, m.x3s + kk + x3excess, m.x2s + jj + x2excess, m.x1s + ii + x1excess),
-                                m.dcons(specIND, IM3, m.x3s + kk, m.x2s + jj, m.x1s + ii),
-                                m.dcons(specIND, IM3, m.x3s + kk - x3excess, m.x2s + jj - x2excess, m.x1s + ii - x1excess),
-                                dx_axis, dt,
-                                Vui, a,
-                                Bm3L,
-                                Bm3R);
+                if (m.dust_nsub(specIND) <= m.dust_substep){
+                    continue;               // species done with its substeps (see first_order)
+                }
+                // the species advances dt / dust_nsub at a time
+                double dts = dt / m.dust_nsub(specIND);
+                const state_real *rho = &m.dcons(specIND, IDN, m.x3s + kk, m.x2s + jj, m.x1s);
+                const dprim_real *vel[3] = {&m.dprim(specIND, IV1, m.x3s + kk, m.x2s + jj, m.x1s),
+                                            &m.dprim(specIND, IV2, m.x3s + kk, m.x2s + jj, m.x1s),
+                                            &m.dprim(specIND, IV3, m.x3s + kk, m.x2s + jj, m.x1s)};
+                const double *dxrow;        // dx along the axis: dxrow[dxstep * ii]
+                int dxstep;
+                #if defined(CARTESIAN_COORD)
+                    if      (axis == 0) { dxrow = m.dx1.get_arr() + m.x1s; dxstep = 1; }
+                    else if (axis == 1) { dxrow = &m.dx2(m.x2s + jj);      dxstep = 0; }
+                    else                { dxrow = &m.dx3(m.x3s + kk);      dxstep = 0; }
+                #elif defined(SPHERICAL_POLAR_COORD)
+                    BootesView<double, 3> dxp;
+                    if      (axis == 0) { dxp = BootesView<double, 3>(m.dx1p); }
+                    else if (axis == 1) { dxp = BootesView<double, 3>(m.dx2p); }
+                    else                { dxp = BootesView<double, 3>(m.dx3p); }
+                    dxrow = dxp.ptr(m.x3s + kk, m.x2s + jj) + m.x1s;
+                    dxstep = 1;
+                #else
+                    # error need coordinate defined
+                #endif
 
-                    // Left of a cell is the right of an edge.
-                    if (kk == -1 || jj == -1 || ii == -1){
-                        ;
-                    }
-                    else {
-                        valsR(specIND, axis, IDN, kk, jj, ii) = BrhoL;
-                        valsR(specIND, axis, IM1, kk, jj, ii) = Bm1L;
-                        valsR(specIND, axis, IM2, kk, jj, ii) = Bm2L;
-                        valsR(specIND, axis, IM3, kk, jj, ii) = Bm3L;
-                    }
+                // Left of a cell is the right of an edge.
+                bool storeR = !(kk == -1 || jj == -1);
+                bool storeL = !(kk == m.nx3 || jj == m.nx2);
+                double *fR[4], *fL[4];
+                for (int var = 0; var < 4; var++){
+                    fR[var] = storeR ? vR.ptr(specIND, axis, var, kk, jj) : nullptr;
+                    fL[var] = storeL ? vL.ptr(specIND, axis, var, kk + x3excess, jj + x2excess) + x1excess : nullptr;
+                }
 
-                    if (kk == m.nx3 || jj == m.nx2 || ii == m.nx1){
-                        ;
-                    }
-                    else{
-                        valsL(specIND, axis, IDN, kk + x3excess, jj + x2excess, ii + x1excess) = BrhoR;
-                        valsL(specIND, axis, IM1, kk + x3excess, jj + x2excess, ii + x1excess) = Bm1R;
-                        valsL(specIND, axis, IM2, kk + x3excess, jj + x2excess, ii + x1excess) = Bm2R;
-                        valsL(specIND, axis, IM3, kk + x3excess, jj + x2excess, ii + x1excess) = Bm3R;
-                    }
+                double BL[4], BR[4];
+                // ghost cells at both ends of the row only contribute one side of a face
+                if (x1excess){
+                    int ii = -1;
+                    minmod_dust_cell(rho, vel, IVP, ii, xstep, shift, dxrow[dxstep * ii], dts, BL, BR);
+                    if (storeL){ for (int var = 0; var < 4; var++){ fL[var][ii] = BR[var]; } }
+                    ii = m.nx1;
+                    minmod_dust_cell(rho, vel, IVP, ii, xstep, shift, dxrow[dxstep * ii], dts, BL, BR);
+                    if (storeR){ for (int var = 0; var < 4; var++){ fR[var][ii] = BL[var]; } }
+                }
+                for (int ii = 0; ii < m.nx1; ii++){
+                    minmod_dust_cell(rho, vel, IVP, ii, xstep, shift, dxrow[dxstep * ii], dts, BL, BR);
+                    if (storeR){ for (int var = 0; var < 4; var++){ fR[var][ii] = BL[var]; } }
+                    if (storeL){ for (int var = 0; var < 4; var++){ fL[var][ii] = BR[var]; } }
                 }
             }
         }
     }
 }
 
-
-#endif
+#endif // ENABLE_DUSTFLUID
@@ -2,24 +2,22 @@
 #define MINMOD_RECONSTRUCT_DUST_HPP_
 
 #include "../BootesArray.hpp"
-#include "../eos/momentum.hpp"
 #include "../../defs.hpp"
 
 
 class mesh;
 
 
-void minmod_dust(double &quanp1, double &quan, double &quanm1, double &dx_axis, double &dt, double &Vui, double &acs, double &BquanL, double &BquanR);
+// Second order (minmod limited, MUSCL-Hancock) face states of the dust, same arguments and output as
+// reconstruct_dust_const. Density and velocities are reconstructed, so the face densities stay positive.
+void reconstruct_dust_minmod(mesh &m,
+                             BootesArray<double> &valsL,
+                             BootesArray<double> &valsR,
+                             int &x1excess, int &x2excess, int &x3excess,
+                             int &axis,
+                             int &IMP,
+                             double &dt
+                             );
 
 
-void reconstruct_dust(mesh &m,
-                   BootesArray<double> &valsL,
-                   BootesArray<double> &valsR,
-                   int &x1excess, int &x2excess, int &x3excess,
-                   int &axis,
-                   int &IMP,
-                   double &dt
-                   );
-
-
-#endif
+#endif  // MINMOD_RECONSTRUCT_DUST_HPP_
@@ -0,0 +1,52 @@
+#ifndef PPM_RECONSTRUCT_HPP_
+#define PPM_RECONSTRUCT_HPP_
+
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+#include <cmath>
+#include <algorithm>
+
+
+class mesh;
+
+
+// monotonized central slope of the cell with the neighbours qm1 and qp1
+inline double mc_slope(double qm1, double q, double qp1){
+    double dqm = q - qm1;
+    double dqp = qp1 - q;
+    double dqc = 0.5 * (qp1 - qm1);
+    double lim = 2 * std::min(std::abs(dqm), std::abs(dqp));
+    double slope = std::copysign(std::min(std::abs(dqc), lim), dqc);
+    return (dqm * dqp > 0) ? slope : 0.;
+}
+
+
+// face value between q and qp1, CW84 eq. 1.6 with the slopes of the two cells
+inline double ppm_face(double qm1, double q, double qp1, double qp2){
+    return 0.5 * (q + qp1) - (mc_slope(q, qp1, qp2) - mc_slope(qm1, q, qp1)) / 6.;
+}
+
+
+// left (qL) and right (qR) values of the parabola of cell q, from the cells qm2 .. qp2 along the axis
+inline void ppm_cell(double qm2, double qm1, double q, double qp1, double qp2, double &qL, double &qR){
+    double fL = ppm_face(qm2, qm1, q, qp1);
+    double fR = ppm_face(qm1, q, qp1, qp2);
+    // CW84 eq. 1.10: flatten at an extremum, pull the far face in where the parabola overshoots
+    double dq  = fR - fL;
+    double q6  = 6. * (q - 0.5 * (fL + fR));
+    bool extremum = (fR - q) * (q - fL) <= 0;
+    double fLn = (dq * q6 > dq * dq)  ? 3. * q - 2. * fR : fL;
+    double fRn = (dq * q6 < -dq * dq) ? 3. * q - 2. * fL : fR;
+    qL = extremum ? q : fLn;
+    qR = extremum ? q : fRn;
+}
+
+
+// Left (BL) and right (BR) PPM states of the cells ii in [is, ie) of the row (kk, jj) along axis, written to
+// BL[var][ii - is] as in reconstruct_minmod_row. Fourth order face values from monotonized central slopes and
+// the parabola limited as in Colella & Woodward (1984); the stencil reaches two cells on either side, so the
+// first ghost cell needs three ghost zones. Spatial only, dt is not used (integrator = rk2 or rk3).
+void reconstruct_PPM_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
+#endif
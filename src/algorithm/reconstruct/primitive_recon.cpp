@@ -0,0 +1,211 @@
+#include "primitive_recon.hpp"
+#include "minmod.hpp"
+#include "ppm.hpp"
+#include "weno5.hpp"
+
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+#include "../index_def.hpp"
+#include "../modules.hpp"
+#include "../mesh/mesh.hpp"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+
+// cell width along the axis in the row (kk, jj), dxrow[dxstep * ii], as in minmod_row_setup
+static void prim_row_dx(mesh &m, int axis, int kk, int jj, const double *&dxrow, int &dxstep){
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    #if defined(CARTESIAN_COORD)
+        if      (axis == 0) { dxrow = m.dx1.get_arr() + x1excess; dxstep = 1; }
+        else if (axis == 1) { dxrow = &m.dx2(jj + x2excess);      dxstep = 0; }
+        else                { dxrow = &m.dx3(kk + x3excess);      dxstep = 0; }
+    #elif defined(SPHERICAL_POLAR_COORD)
+        BootesView<double, 3> dxp;
+        if      (axis == 0) { dxp = BootesView<double, 3>(m.dx1p); }
+        else if (axis == 1) { dxp = BootesView<double, 3>(m.dx2p); }
+        else                { dxp = BootesView<double, 3>(m.dx3p); }
+        dxrow = dxp.ptr(kk + x3excess, jj + x2excess) + x1excess;
+        dxstep = 1;
+    #else
+        # error need coordinate defined
+    #endif
+}
+
+
+// a cell with a face density or pressure <= 0 falls back to its cell value
+static void prim_row_positivity(const state_real * const *q, int is, int ie, double **BL, double **BR){
+    for (int ii = is; ii < ie; ii++){
+        bool positive = BL[IDN][ii - is] > 0 && BR[IDN][ii - is] > 0 && BL[IPN][ii - is] > 0 && BR[IPN][ii - is] > 0;
+        if (positive) continue;
+        for (int var = 0; var < NUMPRIM; var++){
+            BL[var][ii - is] = q[var][ii];
+            BR[var][ii - is] = q[var][ii];
+        }
+    }
+}
+
+
+// the primitive variable var limited along the row (kk, jj), one loop as in reconstruct_PPM_row
+template <int RECON>
+static void prim_row_var(mesh &m, int axis, int var, int kk, int jj, int is, int ie, double &dt, double *bl, double *br){
+    BootesView<state_real, 4> prim(m.prim);
+    BootesView<state_real, 3> cs(m.cs);
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    int s = x1excess + x2excess * prim.stride(2) + x3excess * prim.stride(1);
+
+    const state_real *qv    = prim.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *vaxis = prim.ptr(IV1 + axis, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *c     = cs.ptr(m.x3s + kk, m.x2s + jj) + m.x1s;
+    const double *dxrow = nullptr;
+    int dxstep = 0;
+    if constexpr (RECON == RECON_MINMOD){
+        prim_row_dx(m, axis, kk, jj, dxrow, dxstep);
+    }
+
+    #pragma omp simd
+    for (int ii = is; ii < ie; ii++){
+        if constexpr (RECON == RECON_CONST){
+            bl[ii - is] = qv[ii];
+            br[ii - is] = qv[ii];
+        }
+        else if constexpr (RECON == RECON_MINMOD){
+            double a = std::max(c[ii] + vaxis[ii], c[ii] - vaxis[ii]);
+            minmod(qv[ii + s], qv[ii], qv[ii - s], dxrow[dxstep * ii], dt, vaxis[ii], a, bl[ii - is], br[ii - is]);
+        }
+        else if constexpr (RECON == RECON_PPM){
+            ppm_cell(qv[ii - 2 * s], qv[ii - s], qv[ii], qv[ii + s], qv[ii + 2 * s], bl[ii - is], br[ii - is]);
+        }
+        else {
+            bl[ii - is] = weno5_face(qv[ii + 2 * s], qv[ii + s], qv[ii], qv[ii - s], qv[ii - 2 * s]);
+            br[ii - is] = weno5_face(qv[ii - 2 * s], qv[ii - s], qv[ii], qv[ii + s], qv[ii + 2 * s]);
+        }
+    }
+}
+
+
+static void prim_row_cells(mesh &m, int kk, int jj, const state_real **q){
+    BootesView<state_real, 4> prim(m.prim);
+    for (int var = 0; var < NUMPRIM; var++){
+        q[var] = prim.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+    }
+}
+
+
+template <int RECON>
+static void prim_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    for (int var = 0; var < NUMPRIM; var++){
+        prim_row_var<RECON>(m, axis, var, kk, jj, is, ie, dt, BL[var], BR[var]);
+    }
+    if constexpr (RECON != RECON_CONST){
+        const state_real *q[NUMPRIM];
+        prim_row_cells(m, kk, jj, q);
+        prim_row_positivity(q, is, ie, BL, BR);
+    }
+}
+
+
+// the stencil of every cell projected on the left eigenvectors of the Euler equations in primitive form at that
+// cell, limited field by field and projected back; the transverse velocities are their own characteristic
+// variables and are limited as they are
+template <int RECON>
+static void char_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    int IVN = IV1 + axis;           // velocity along the axis
+    for (int var = IV1; var <= IV3; var++){
+        if (var != IVN){
+            prim_row_var<RECON>(m, axis, var, kk, jj, is, ie, dt, BL[var], BR[var]);
+        }
+    }
+
+    BootesView<state_real, 4> prim(m.prim);
+    BootesView<state_real, 3> cs(m.cs);
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    int s = x1excess + x2excess * prim.stride(2) + x3excess * prim.stride(1);
+    const state_real *rho = prim.ptr(IDN, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *un  = prim.ptr(IVN, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *p   = prim.ptr(IPN, m.x3s + kk, m.x2s + jj) + m.x1s;
+    const state_real *c   = cs.ptr(m.x3s + kk, m.x2s + jj) + m.x1s;
+    const double *dxrow = nullptr;
+    int dxstep = 0;
+    if constexpr (RECON == RECON_MINMOD){
+        prim_row_dx(m, axis, kk, jj, dxrow, dxstep);
+    }
+    double *bld = BL[IDN], *blv = BL[IVN], *blp = BL[IPN];
+    double *brd = BR[IDN], *brv = BR[IVN], *brp = BR[IPN];
+
+    #pragma omp simd
+    for (int ii = is; ii < ie; ii++){
+        double rho0 = rho[ii];
+        double c0   = c[ii];
+        double c2   = c0 * c0;
+        // amplitudes of the u - c (wm), entropy (we) and u + c (wp) waves over the stencil, wX[2 + k] at ii + k * s
+        double wm[5], we[5], wp[5];
+        for (int k = -2; k <= 2; k++){
+            if ((RECON == RECON_MINMOD) && (k == -2 || k == 2)) continue;
+            int ik = ii + k * s;
+            wm[2 + k] = 0.5 * (p[ik] / c2 - rho0 * un[ik] / c0);
+            we[2 + k] = rho[ik] - p[ik] / c2;
+            wp[2 + k] = 0.5 * (p[ik] / c2 + rho0 * un[ik] / c0);
+        }
+        double wmL, wmR, weL, weR, wpL, wpR;
+        if constexpr (RECON == RECON_MINMOD){
+            double a = std::max(c0 + un[ii], c0 - un[ii]);
+            minmod(wm[3], wm[2], wm[1], dxrow[dxstep * ii], dt, un[ii], a, wmL, wmR);
+            minmod(we[3], we[2], we[1], dxrow[dxstep * ii], dt, un[ii], a, weL, weR);
+            minmod(wp[3], wp[2], wp[1], dxrow[dxstep * ii], dt, un[ii], a, wpL, wpR);
+        }
+        else if constexpr (RECON == RECON_PPM){
+            ppm_cell(wm[0], wm[1], wm[2], wm[3], wm[4], wmL, wmR);
+            ppm_cell(we[0], we[1], we[2], we[3], we[4], weL, weR);
+            ppm_cell(wp[0], wp[1], wp[2], wp[3], wp[4], wpL, wpR);
+        }
+        else {
+            wmL = weno5_face(wm[4], wm[3], wm[2], wm[1], wm[0]);
+            wmR = weno5_face(wm[0], wm[1], wm[2], wm[3], wm[4]);
+            weL = weno5_face(we[4], we[3], we[2], we[1], we[0]);
+            weR = weno5_face(we[0], we[1], we[2], we[3], we[4]);
+            wpL = weno5_face(wp[4], wp[3], wp[2], wp[1], wp[0]);
+            wpR = weno5_face(wp[0], wp[1], wp[2], wp[3], wp[4]);
+        }
+        bld[ii - is] = wmL + weL + wpL;
+        blv[ii - is] = c0 / rho0 * (wpL - wmL);
+        blp[ii - is] = c2 * (wmL + wpL);
+        brd[ii - is] = wmR + weR + wpR;
+        brv[ii - is] = c0 / rho0 * (wpR - wmR);
+        brp[ii - is] = c2 * (wmR + wpR);
+    }
+
+    const state_real *q[NUMPRIM];
+    prim_row_cells(m, kk, jj, q);
+    prim_row_positivity(q, is, ie, BL, BR);
+}
+
+
+void reconstruct_prim_row(mesh &m, int recon, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    bool characteristic = (m.modules.recon_variables == RECON_VARS_CHARACTERISTIC);
+    switch (recon){
+        case RECON_CONST:
+            prim_row<RECON_CONST>(m, axis, kk, jj, is, ie, dt, BL, BR); break;
+        case RECON_MINMOD:
+            if (characteristic){ char_row<RECON_MINMOD>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            else               { prim_row<RECON_MINMOD>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            break;
+        case RECON_PPM:
+            if (characteristic){ char_row<RECON_PPM>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            else               { prim_row<RECON_PPM>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            break;
+        case RECON_WENO5:
+            if (characteristic){ char_row<RECON_WENO5>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            else               { prim_row<RECON_WENO5>(m, axis, kk, jj, is, ie, dt, BL, BR); }
+            break;
+        default: cout << "reconstruction has no primitive form" << endl << flush; throw 1;
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef PRIMITIVE_RECONSTRUCT_HPP_
+#define PRIMITIVE_RECONSTRUCT_HPP_
+
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+
+
+class mesh;
+
+
+// Left (BL) and right (BR) primitive states (IDN, IV1, IV2, IV3, IPN) of the cells ii in [is, ie) of the row
+// (kk, jj) along axis, written to BL[var][ii - is] as in reconstruct_minmod_row, for reconstruction_variables =
+// primitive or characteristic. recon is the limiter (RECON_CONST, RECON_MINMOD, RECON_PPM or RECON_WENO5). It
+// works on m.prim and the sound speed m.cs, both computed once per flux evaluation, so no cell state goes
+// through pres() or soundspeed() again per axis. With characteristic variables the stencil of every cell is
+// projected on the left eigenvectors of the Euler equations in primitive form at that cell, limited field by
+// field and projected back. A cell with a face density or pressure <= 0 falls back to its cell value.
+void reconstruct_prim_row(mesh &m, int recon, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
+#endif
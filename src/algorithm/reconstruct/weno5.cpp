@@ -0,0 +1,27 @@
+#include "weno5.hpp"
+
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+#include "../index_def.hpp"
+#include "../mesh/mesh.hpp"
+#include <cmath>
+
+
+void reconstruct_WENO5_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    BootesView<state_real, 4> cons(m.cons);
+    int x1excess = (axis == 0) ? 1 : 0;
+    int x2excess = (axis == 1) ? 1 : 0;
+    int x3excess = (axis == 2) ? 1 : 0;
+    int s = x1excess + x2excess * cons.stride(2) + x3excess * cons.stride(1);
+
+    for (int var = 0; var < NUMCONS; var++){
+        const state_real * __restrict q = cons.ptr(var, m.x3s + kk, m.x2s + jj) + m.x1s;
+        double * __restrict bl = BL[var];
+        double * __restrict br = BR[var];
+        #pragma omp simd
+        for (int ii = is; ii < ie; ii++){
+            bl[ii - is] = weno5_face(q[ii + 2 * s], q[ii + s], q[ii], q[ii - s], q[ii - 2 * s]);
+            br[ii - is] = weno5_face(q[ii - 2 * s], q[ii - s], q[ii], q[ii + s], q[ii + 2 * s]);
+        }
+    }
+}
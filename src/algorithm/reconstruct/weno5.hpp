@@ -0,0 +1,36 @@
+#ifndef WENO5_RECONSTRUCT_HPP_
+#define WENO5_RECONSTRUCT_HPP_
+
+#include "../BootesArray.hpp"
+#include "../../defs.hpp"
+#include <cmath>
+
+
+class mesh;
+
+
+// value at the face between q0 and q1 from the five cells qm2 .. q2 (upwind side qm2)
+inline double weno5_face(double qm2, double qm1, double q0, double q1, double q2){
+    const double eps = 1e-40;
+    double b0 = 13. / 12. * (qm2 - 2. * qm1 + q0) * (qm2 - 2. * qm1 + q0) + 0.25 * (qm2 - 4. * qm1 + 3. * q0) * (qm2 - 4. * qm1 + 3. * q0);
+    double b1 = 13. / 12. * (qm1 - 2. * q0 + q1)  * (qm1 - 2. * q0 + q1)  + 0.25 * (qm1 - q1) * (qm1 - q1);
+    double b2 = 13. / 12. * (q0 - 2. * q1 + q2)   * (q0 - 2. * q1 + q2)   + 0.25 * (3. * q0 - 4. * q1 + q2) * (3. * q0 - 4. * q1 + q2);
+    double tau = std::abs(b0 - b2);
+    double a0 = 0.1 * (1. + tau / (b0 + eps));
+    double a1 = 0.6 * (1. + tau / (b1 + eps));
+    double a2 = 0.3 * (1. + tau / (b2 + eps));
+    double p0 = (2. * qm2 - 7. * qm1 + 11. * q0) / 6.;
+    double p1 = (- qm1 + 5. * q0 + 2. * q1) / 6.;
+    double p2 = (2. * q0 + 5. * q1 - q2) / 6.;
+    return (a0 * p0 + a1 * p1 + a2 * p2) / (a0 + a1 + a2);
+}
+
+
+// Left (BL) and right (BR) WENO5 states of the cells ii in [is, ie) of the row (kk, jj) along axis, written to
+// BL[var][ii - is] as in reconstruct_minmod_row. Fifth order Jiang & Shu stencils with the WENO-Z weights of
+// Borges et al. (2008); the stencil reaches two cells on either side, so the first ghost cell needs three
+// ghost zones. Spatial only, dt is not used (integrator = rk2 or rk3).
+void reconstruct_WENO5_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR);
+
+
+#endif
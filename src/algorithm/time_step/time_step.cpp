@@ -20,8 +20,14 @@ double timestep(mesh &m, double &CFL){
             }
         }
         #ifdef ENABLE_DUSTFLUID
-        #pragma omp parallel for collapse(4) reduction (min: min_dt)
+        // each species keeps its own limit, so that species slower than the gas need not hold it back
         for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+            double spec_dt = std::numeric_limits<double>::max();
+            if (m.dust_floor(specIND)){
+                m.dust_dt(specIND) = spec_dt;       // at the floor, takes no step (find_floor_species)
+                continue;
+            }
+            #pragma omp parallel for collapse(3) reduction (min: spec_dt)
             for (int kk = m.x3s; kk < m.x3l ; kk++){
                 for (int jj = m.x2s; jj < m.x2l; jj++){
                     for (int ii = m.x1s; ii < m.x1l; ii++){
@@ -29,7 +35,7 @@ double timestep(mesh &m, double &CFL){
 
                         double dx1_sig = std::min(std::min(m.dx1p(kk, jj, ii - 1), m.dx1p(kk, jj, ii)), m.dx1p(kk, jj, ii + 1));
                         double mindt_cell = dx1_sig / vmx1;
-                        min_dt = std::min(mindt_cell, min_dt);
+                        spec_dt = std::min(mindt_cell, spec_dt);
                         #ifdef DEBUG
                         if (mindt_cell < 0){
                             std::cout << kk << '\t' << jj << '\t' << ii << '\t' << dx1_sig << '\t' << vmx1 << '\t' << std::endl << std::flush;
@@ -38,6 +44,7 @@ double timestep(mesh &m, double &CFL){
                     }
                 }
             }
+            m.dust_dt(specIND) = spec_dt;
         }
         #endif // ENABLE_DUSTFLUID
     }
@@ -64,8 +71,14 @@ double timestep(mesh &m, double &CFL){
             }
         }
         #ifdef ENABLE_DUSTFLUID
-        #pragma omp parallel for collapse(4) reduction (min: min_dt)
+        // each species keeps its own limit, so that species slower than the gas need not hold it back
         for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+            double spec_dt = std::numeric_limits<double>::max();
+            if (m.dust_floor(specIND)){
+                m.dust_dt(specIND) = spec_dt;       // at the floor, takes no step (find_floor_species)
+                continue;
+            }
+            #pragma omp parallel for collapse(3) reduction (min: spec_dt)
             for (int kk = m.x3s; kk < m.x3l ; kk++){
                 for (int jj = m.x2s; jj < m.x2l; jj++){
                     for (int ii = m.x1s; ii < m.x1l; ii++){
@@ -75,7 +88,7 @@ double timestep(mesh &m, double &CFL){
                         double dx1_sig = std::min(std::min(m.dx1p(kk, jj, ii - 1), m.dx1p(kk, jj, ii)), m.dx1p(kk, jj, ii + 1));
                         double dx2_sig = std::min(std::min(m.dx2p(kk, jj - 1, ii), m.dx2p(kk, jj, ii)), m.dx2p(kk, jj + 1, ii));
                         double mindt_cell = std::min(dx2_sig / vmx2, dx1_sig / vmx1);
-                        min_dt = std::min(mindt_cell, min_dt);
+                        spec_dt = std::min(mindt_cell, spec_dt);
                         #ifdef DEBUG
                         if (mindt_cell < 0){
                             std::cout << kk << '\t' << jj << '\t' << ii << '\t' << dx1_sig << '\t' << dx2_sig << '\t' << vmx1 << '\t' << vmx2 << std::endl << std::flush;
@@ -84,6 +97,7 @@ double timestep(mesh &m, double &CFL){
                     }
                 }
             }
+            m.dust_dt(specIND) = spec_dt;
         }
         #endif // ENABLE_DUSTFLUID
     }
@@ -106,15 +120,21 @@ double timestep(mesh &m, double &CFL){
                     if (mindt_cell < 0){
                         std::cout << "(" << kk << '\t' << jj << '\t' << ii << ")" << '\t';
                         std::cout << dx1_sig << '\t' << dx2_sig << '\t' << vmx1 << '\t' << vmx2 << '\t' << vmx3 << std::flush;
-                        std::cout << m.prim(IV1, kk, jj, ii) << '\t' << m.dprim(IV2, kk, jj, ii) << '\t' << m.dprim(IV3, kk, jj, ii) << std::endl << std::flush;
+                        std::cout << m.prim(IV1, kk, jj, ii) << '\t' << m.prim(IV2, kk, jj, ii) << '\t' << m.prim(IV3, kk, jj, ii) << std::endl << std::flush;
                     }
                     #endif // DEBUG
                 }
             }
         }
         #ifdef ENABLE_DUSTFLUID
-        #pragma omp parallel for collapse(4) reduction (min: min_dt)
+        // each species keeps its own limit, so that species slower than the gas need not hold it back
         for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+            double spec_dt = std::numeric_limits<double>::max();
+            if (m.dust_floor(specIND)){
+                m.dust_dt(specIND) = spec_dt;       // at the floor, takes no step (find_floor_species)
+                continue;
+            }
+            #pragma omp parallel for collapse(3) reduction (min: spec_dt)
             for (int kk = m.x3s; kk < m.x3l ; kk++){
                 for (int jj = m.x2s; jj < m.x2l; jj++){
                     for (int ii = m.x1s; ii < m.x1l; ii++){
@@ -126,7 +146,7 @@ double timestep(mesh &m, double &CFL){
                         double dx2_sig = std::min(std::min(m.dx2p(kk, jj - 1, ii), m.dx2p(kk, jj, ii)), m.dx2p(kk, jj + 1, ii));
                         double dx3_sig = std::min(std::min(m.dx3p(kk - 1, jj, ii), m.dx3p(kk, jj, ii)), m.dx3p(kk + 1, jj, ii));
                         double mindt_cell = std::min(dx3_sig / vmx3, std::min(dx2_sig / vmx2, dx1_sig / vmx1));
-                        min_dt = std::min(mindt_cell, min_dt);
+                        spec_dt = std::min(mindt_cell, spec_dt);
                         #ifdef DEBUG
                         if (mindt_cell < 0){
                             std::cout << kk << '\t' << jj << '\t' << ii << '\t' << dx1_sig << '\t' << dx2_sig<< '\t' << vmx1 << '\t' << vmx2 << '\t' << std::flush;
@@ -136,10 +156,30 @@ double timestep(mesh &m, double &CFL){
                     }
                 }
             }
+            m.dust_dt(specIND) = spec_dt;
         }
         #endif // ENABLE_DUSTFLUID
     }
 
+    #ifdef ENABLE_MPI
+    // every rank takes the step of the most restrictive block
+    MPI_Allreduce(MPI_IN_PLACE, &min_dt, 1, MPI_DOUBLE, MPI_MIN, m.decomp.comm);
+    #ifdef ENABLE_DUSTFLUID
+    MPI_Allreduce(MPI_IN_PLACE, m.dust_dt.get_arr(), m.NUMSPECIES, MPI_DOUBLE, MPI_MIN, m.decomp.comm);
+    #endif // ENABLE_DUSTFLUID
+    #endif // ENABLE_MPI
+
+    #ifdef ENABLE_DUSTFLUID
+    // the gas step, unless a species would need more than dust_max_subcycles substeps of its own step for it
+    // (see first_order); with the default of 1 this is the step of the slowest of gas and dust
+    double min_dust_dt = std::numeric_limits<double>::max();
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        m.dust_dt(specIND) *= CFL;
+        min_dust_dt = std::min(min_dust_dt, m.dust_dt(specIND));
+    }
+    return std::min(CFL * min_dt, m.dust_max_subcycles * min_dust_dt);
+    #else
     return CFL * min_dt;
+    #endif // ENABLE_DUSTFLUID
 }
 
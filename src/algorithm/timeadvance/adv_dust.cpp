@@ -2,17 +2,32 @@
 
 #include "adv_dust.hpp"
 
-// #include "../reconstruct/minmod_dust.hpp"
+#include "../reconstruct/minmod_dust.hpp"
 #include "../reconstruct/const_reconst_dust.hpp"
 #include "../time_step/time_step.hpp"
 #include "../util/util.hpp"
-// #include "../dust/hll_dust.hpp"
+#include "../dust/hll_dust.hpp"
 #include "../dust/doner_dust.hpp"
 #include "../boundary_condition/apply_bc.hpp"
 #include "../mesh/mesh.hpp"
 #include "../dust/terminalvel.hpp"
+#include "../dust/gas_drag_on_dust.hpp"
 
-void calc_flux_dust(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double> &fdcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+
+#ifdef ENABLE_DUSTFLUID
+// gas velocity (axis dd) a fraction theta into the step: between prim, from the start of the step, and cons,
+// already advanced by the hydro (see first_order)
+static inline double gas_velocity(mesh &m, int dd, double theta, int kk, int jj, int ii){
+    if (theta == 0){
+        return m.prim(IV1 + dd, kk, jj, ii);
+    }
+    double vend = m.cons(IM1 + dd, kk, jj, ii) / m.cons(IDN, kk, jj, ii);
+    return m.prim(IV1 + dd, kk, jj, ii) + theta * (vend - m.prim(IV1 + dd, kk, jj, ii));
+}
+
+// One instantiation per dust reconstruction and Riemann solver, picked in calc_flux_dust() from m.modules
+template <int RECON, int RIEMANN>
+static void calc_flux_dust_modules(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double> &fdcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
     // store the redconstructed value
     // index: (specIadvecting direction, quantity, kk, jj, ii)
     for (int axis = 0; axis < m.dim; axis ++){
@@ -24,33 +39,59 @@ void calc_flux_dust(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double> &f
         else if (axis == 2){ x1excess = 0; x2excess = 0; x3excess = 1; IMP = IM3;}
         else { cout << "axis > 3!!!" << endl << flush; throw 1; }
 
-        reconstruct_dust_const(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
-        // step 1.2: solve the Riemann problem. Use HLL for now, update dconservative vars
+        if constexpr (RECON == RECON_CONST){
+            reconstruct_dust_const(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
+        }
+        else {
+            reconstruct_dust_minmod(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
+        }
+        // step 1.2: solve the Riemann problem, one x1 row of faces per call
+        BootesView<double, 6> vL(valsL);
+        BootesView<double, 6> vR(valsR);
+        BootesView<double, 6> flux(fdcons);
         #pragma omp parallel for collapse (3) schedule (static)
         for (int specIND = 0; specIND < NUMSPECIES; specIND++){
             for (int kk = 0; kk < m.nx3 + x3excess; kk ++){
                 for (int jj = 0; jj < m.nx2 + x2excess; jj ++){
-                    for (int ii = 0; ii < m.nx1 + x1excess; ii ++){
-                        double valL[4];
-                        double valR[4];
-                        double fxs[4];
-                        valL[IDN] = valsL(specIND, axis, IDN, kk, jj, ii); valR[IDN] = valsR(specIND, axis, IDN, kk, jj, ii);
-                        valL[IM1] = valsL(specIND, axis, IM1, kk, jj, ii); valR[IM1] = valsR(specIND, axis, IM1, kk, jj, ii);
-                        valL[IM2] = valsL(specIND, axis, IM2, kk, jj, ii); valR[IM2] = valsR(specIND, axis, IM2, kk, jj, ii);
-                        valL[IM3] = valsL(specIND, axis, IM3, kk, jj, ii); valR[IM3] = valsR(specIND, axis, IM3, kk, jj, ii);
-                        doner_cell_dust( valL, valR, fxs,
-                                         IMP,                   // the momentum term to add pressure; shift by one index (since first index is density)
-                                         m.hydro_gamma
-                                         );
-                        fdcons(specIND, IDN, axis, kk, jj, ii) = fxs[IDN];
-                        fdcons(specIND, IM1, axis, kk, jj, ii) = fxs[IM1];
-                        fdcons(specIND, IM2, axis, kk, jj, ii) = fxs[IM2];
-                        fdcons(specIND, IM3, axis, kk, jj, ii) = fxs[IM3];
+                    if (m.dust_nsub(specIND) <= m.dust_substep){
+                        continue;
+                    }
+                    int nface = m.nx1 + x1excess;
+                    double *L[4], *R[4], *F[4];
+                    for (int var = 0; var < 4; var++){
+                        L[var] = vL.ptr(specIND, axis, var, kk, jj);
+                        R[var] = vR.ptr(specIND, axis, var, kk, jj);
+                        F[var] = flux.ptr(specIND, var, axis, kk, jj);
+                    }
+                    if constexpr (RIEMANN == DUST_RIEMANN_DONOR){
+                        doner_dust_batch(nface, L, R, F, IMP);
+                    }
+                    else {
+                        hll_dust_batch(nface, L, R, F, IMP);
                     }
                 }
             }
         }
     }
+}
+
+
+template <int RECON>
+static void calc_flux_dust_recon(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double> &fdcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+    switch (m.modules.dust_riemann_solver){
+        case DUST_RIEMANN_DONOR: calc_flux_dust_modules<RECON, DUST_RIEMANN_DONOR>(m, dt, NUMSPECIES, fdcons, valsL, valsR); break;
+        case DUST_RIEMANN_HLL:   calc_flux_dust_modules<RECON, DUST_RIEMANN_HLL>  (m, dt, NUMSPECIES, fdcons, valsL, valsR); break;
+        default: cout << "unknown dust Riemann solver" << endl << flush; throw 1;
+    }
+}
+
+
+void calc_flux_dust(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double> &fdcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+    switch (m.modules.dust_reconstruction){
+        case RECON_CONST:  calc_flux_dust_recon<RECON_CONST> (m, dt, NUMSPECIES, fdcons, valsL, valsR); break;
+        case RECON_MINMOD: calc_flux_dust_recon<RECON_MINMOD>(m, dt, NUMSPECIES, fdcons, valsL, valsR); break;
+        default: cout << "unknown dust reconstruction" << endl << flush; throw 1;
+    }
     // Need to set unused values in the fdcons to zeros.
     // To do so the axis goes from "number of active axis" to 3
     #pragma omp parallel for collapse (5) schedule (static)
@@ -80,12 +121,23 @@ void advect_cons_dust_sphericalpolar(mesh &m, double &dt, int &NUMSPECIES, Boote
                     int kkf = kk - m.x3s;
                     int jjf = jj - m.x2s;
                     int iif = ii - m.x1s;
-                    // calculate density. If density < 0 or stopping time < dt: apply terminal velocity approximation.
-                    m.dcons(specIND, IDN, kk, jj, ii) -= (dt / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 0, kkf, jjf, iif + 1) * m.f1a(kk, jj, ii + 1) - fdcons(specIND, IDN, 0, kkf, jjf, iif) * m.f1a(kk, jj, ii))
-                                                        + dt / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 1, kkf, jjf + 1, iif) * m.f2a(kk, jj + 1, ii) - fdcons(specIND, IDN, 1, kkf, jjf, iif) * m.f2a(kk, jj, ii))
-                                                        + dt / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 2, kkf + 1, jjf, iif) * m.f3a(kk + 1, jj, ii) - fdcons(specIND, IDN, 2, kkf, jjf, iif) * m.f3a(kk, jj, ii)));
-                    bool denl0 = m.dcons(specIND, IDN, kk, jj, ii) < m.dminDensity;
-                    bool stldt = stoppingtimemesh(specIND, kk, jj, ii) < dt;
+                    if (m.dust_nsub(specIND) <= m.dust_substep){
+                        continue;               // this species has taken all its substeps
+                    }
+                    // substep of this species and the gas velocity at its start
+                    double dts = dt / m.dust_nsub(specIND);
+                    double theta = (double) m.dust_substep / m.dust_nsub(specIND);
+                    double vgas1 = gas_velocity(m, 0, theta, kk, jj, ii);
+                    double vgas2 = gas_velocity(m, 1, theta, kk, jj, ii);
+                    double vgas3 = gas_velocity(m, 2, theta, kk, jj, ii);
+                    // calculate density. If density < 0 or stopping time < dts: apply terminal velocity approximation.
+                    m.dcons(specIND, IDN, kk, jj, ii) -= (dts / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 0, kkf, jjf, iif + 1) * m.f1a(kk, jj, ii + 1) - fdcons(specIND, IDN, 0, kkf, jjf, iif) * m.f1a(kk, jj, ii))
+                                                        + dts / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 1, kkf, jjf + 1, iif) * m.f2a(kk, jj + 1, ii) - fdcons(specIND, IDN, 1, kkf, jjf, iif) * m.f2a(kk, jj, ii))
+                                                        + dts / m.vol(kk, jj, ii) * (fdcons(specIND, IDN, 2, kkf + 1, jjf, iif) * m.f3a(kk + 1, jj, ii) - fdcons(specIND, IDN, 2, kkf, jjf, iif) * m.f3a(kk, jj, ii)));
+                    bool denl0 = m.dcons(specIND, IDN, kk, jj, ii) < (state_real) m.dminDensity;     // the floor as stored, so floor cells are not below it
+                    // the exponential drag holds for any stopping time, the explicit one needs the terminal velocity
+                    // approximation where ts < dts
+                    bool stldt = (m.modules.dust_drag == DRAG_EXPLICIT) && stoppingtimemesh(specIND, kk, jj, ii) < dts;
                     if (denl0 || stldt){
                         if (denl0){
                             m.dcons(specIND, IDN, kk, jj, ii) = m.dminDensity;
@@ -102,7 +154,7 @@ void advect_cons_dust_sphericalpolar(mesh &m, double &dt, int &NUMSPECIES, Boote
                         rhogradphix2 = 0;
                         rhogradphix3 = 0;
                         #endif // ENABLE_GRAVITY
-                        dust_terminalvelocityapprixmation_rtp(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
+                        dust_terminalvelocityapprixmation_rtp(vgas1, vgas2, vgas3,
                                                               rhogradphix1, rhogradphix2, rhogradphix3,
                                                               m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), m.x1v(ii), m.geo_cot(jj),
                                                               m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
@@ -116,18 +168,18 @@ void advect_cons_dust_sphericalpolar(mesh &m, double &dt, int &NUMSPECIES, Boote
                     else{
                         // if density is fine, then calculate everything self-consistantly.
                         for (int dconsIND = 1; dconsIND < NUMCONS - 1; dconsIND++){
-                            m.dcons(specIND, dconsIND, kk, jj, ii) -= (dt / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 0, kkf, jjf, iif + 1) * m.f1a(kk, jj, ii + 1) - fdcons(specIND, dconsIND, 0, kkf, jjf, iif) * m.f1a(kk, jj, ii))
-                                                                     + dt / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 1, kkf, jjf + 1, iif) * m.f2a(kk, jj + 1, ii) - fdcons(specIND, dconsIND, 1, kkf, jjf, iif) * m.f2a(kk, jj, ii))
-                                                                     + dt / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 2, kkf + 1, jjf, iif) * m.f3a(kk + 1, jj, ii) - fdcons(specIND, dconsIND, 2, kkf, jjf, iif) * m.f3a(kk, jj, ii)));
+                            m.dcons(specIND, dconsIND, kk, jj, ii) -= (dts / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 0, kkf, jjf, iif + 1) * m.f1a(kk, jj, ii + 1) - fdcons(specIND, dconsIND, 0, kkf, jjf, iif) * m.f1a(kk, jj, ii))
+                                                                     + dts / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 1, kkf, jjf + 1, iif) * m.f2a(kk, jj + 1, ii) - fdcons(specIND, dconsIND, 1, kkf, jjf, iif) * m.f2a(kk, jj, ii))
+                                                                     + dts / m.vol(kk, jj, ii) * (fdcons(specIND, dconsIND, 2, kkf + 1, jjf, iif) * m.f3a(kk + 1, jj, ii) - fdcons(specIND, dconsIND, 2, kkf, jjf, iif) * m.f3a(kk, jj, ii)));
                         }
                         // geometry term
 
-                        m.dcons(specIND, IM1, kk, jj, ii) += dt * m.one_orgeo(ii) * \
+                        m.dcons(specIND, IM1, kk, jj, ii) += dts * m.one_orgeo(ii) * \
                                     (m.dprim(specIND, IDN, kk, jj, ii) * (pow(m.dprim(specIND, IV2, kk, jj, ii), 2) + pow(m.dprim(specIND, IV3, kk, jj, ii), 2)));
-                        m.dcons(specIND, IM2, kk, jj, ii) -= dt * m.one_orgeo(ii) * m.dprim(specIND, IDN, kk, jj, ii) * m.dprim(specIND, IV1, kk, jj, ii) * m.dprim(specIND, IV2, kk, jj, ii);
-                        m.dcons(specIND, IM2, kk, jj, ii) += dt * m.geo_cot(jj) * m.one_orgeo(ii) * (m.dprim(specIND, IDN, kk, jj, ii) * pow(m.dprim(specIND, IV3, kk, jj, ii), 2));
-                        m.dcons(specIND, IM3, kk, jj, ii) -= dt * m.one_orgeo(ii) * m.dprim(specIND, IDN, kk, jj, ii) * m.dprim(specIND, IV1, kk, jj, ii) * m.dprim(specIND, IV3, kk, jj, ii);
-                        m.dcons(specIND, IM3, kk, jj, ii) -= dt * m.geo_cot(jj) * m.one_orgeo(ii) * (m.dprim(specIND, IDN, kk, jj, ii) * (m.dprim(specIND, IV2, kk, jj, ii) * m.dprim(specIND, IV3, kk, jj, ii)));
+                        m.dcons(specIND, IM2, kk, jj, ii) -= dts * m.one_orgeo(ii) * m.dprim(specIND, IDN, kk, jj, ii) * m.dprim(specIND, IV1, kk, jj, ii) * m.dprim(specIND, IV2, kk, jj, ii);
+                        m.dcons(specIND, IM2, kk, jj, ii) += dts * m.geo_cot(jj) * m.one_orgeo(ii) * (m.dprim(specIND, IDN, kk, jj, ii) * pow(m.dprim(specIND, IV3, kk, jj, ii), 2));
+                        m.dcons(specIND, IM3, kk, jj, ii) -= dts * m.one_orgeo(ii) * m.dprim(specIND, IDN, kk, jj, ii) * m.dprim(specIND, IV1, kk, jj, ii) * m.dprim(specIND, IV3, kk, jj, ii);
+                        m.dcons(specIND, IM3, kk, jj, ii) -= dts * m.geo_cot(jj) * m.one_orgeo(ii) * (m.dprim(specIND, IDN, kk, jj, ii) * (m.dprim(specIND, IV2, kk, jj, ii) * m.dprim(specIND, IV3, kk, jj, ii)));
 
                         // source terms
                         double rhogradphix1;
@@ -143,24 +195,43 @@ void advect_cons_dust_sphericalpolar(mesh &m, double &dt, int &NUMSPECIES, Boote
                         rhogradphix3 = 0;
                         #endif // ENABLE_GRAVITY
 
-                        // apply gravity
-                        m.dcons(specIND, IM1, kk, jj, ii) += rhogradphix1 * dt;
-                        m.dcons(specIND, IM2, kk, jj, ii) += rhogradphix2 * dt;
-                        m.dcons(specIND, IM3, kk, jj, ii) += rhogradphix3 * dt;
-                        // gas drag
-                        double vdust1 = m.dcons(specIND, IV1, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas1  = m.prim(IV1, kk, jj, ii);
-                        double vdust2 = m.dcons(specIND, IV2, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas2  = m.prim(IV2, kk, jj, ii);
-                        double vdust3 = m.dcons(specIND, IV3, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas3  = m.prim(IV3, kk, jj, ii);
-                        double rhodt_stime = m.dcons(specIND, IDN, kk, jj, ii) * dt / stoppingtimemesh(specIND, kk, jj, ii);
-                        double dragMOM1 = rhodt_stime * (vgas1 - vdust1);
-                        double dragMOM2 = rhodt_stime * (vgas2 - vdust2);
-                        double dragMOM3 = rhodt_stime * (vgas3 - vdust3);
-                        m.dcons(specIND, IM1, kk, jj, ii) += dragMOM1;
-                        m.dcons(specIND, IM2, kk, jj, ii) += dragMOM2;
-                        m.dcons(specIND, IM3, kk, jj, ii) += dragMOM3;
+                        if (m.modules.dust_drag != DRAG_EXPLICIT){
+                            // with feedback on the gas, gravity and drag are applied cell by cell in dust_gas_drag
+                            if (!m.modules.dust_feedback){
+                                double vg[3]  = {vgas1, vgas2, vgas3};
+                                double accel[3] = {rhogradphix1 / m.dprim(specIND, IDN, kk, jj, ii),
+                                                   rhogradphix2 / m.dprim(specIND, IDN, kk, jj, ii),
+                                                   rhogradphix3 / m.dprim(specIND, IDN, kk, jj, ii)};
+                                double pd[3]  = {m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)};
+                                if (m.modules.dust_drag == DRAG_EXPONENTIAL){
+                                    double eps = 0;
+                                    dust_drag_exponential(vg, eps, m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), dts, accel, pd);
+                                }
+                                else {
+                                    dust_drag_implicit(vg, m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), dts, accel, pd);
+                                }
+                                m.dcons(specIND, IM1, kk, jj, ii) = pd[0];
+                                m.dcons(specIND, IM2, kk, jj, ii) = pd[1];
+                                m.dcons(specIND, IM3, kk, jj, ii) = pd[2];
+                            }
+                        }
+                        else {
+                            // apply gravity
+                            m.dcons(specIND, IM1, kk, jj, ii) += rhogradphix1 * dts;
+                            m.dcons(specIND, IM2, kk, jj, ii) += rhogradphix2 * dts;
+                            m.dcons(specIND, IM3, kk, jj, ii) += rhogradphix3 * dts;
+                            // gas drag
+                            double vdust1 = (double) m.dcons(specIND, IV1, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double vdust2 = (double) m.dcons(specIND, IV2, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double vdust3 = (double) m.dcons(specIND, IV3, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double rhodt_stime = m.dcons(specIND, IDN, kk, jj, ii) * dts / stoppingtimemesh(specIND, kk, jj, ii);
+                            double dragMOM1 = rhodt_stime * (vgas1 - vdust1);
+                            double dragMOM2 = rhodt_stime * (vgas2 - vdust2);
+                            double dragMOM3 = rhodt_stime * (vgas3 - vdust3);
+                            m.dcons(specIND, IM1, kk, jj, ii) += dragMOM1;
+                            m.dcons(specIND, IM2, kk, jj, ii) += dragMOM2;
+                            m.dcons(specIND, IM3, kk, jj, ii) += dragMOM3;
+                        }
                     }
                 }
             }
@@ -181,12 +252,23 @@ void advect_cons_dust_cartesian(mesh &m, double &dt, int &NUMSPECIES, BootesArra
                     int kkf = kk - m.x3s;
                     int jjf = jj - m.x2s;
                     int iif = ii - m.x1s;
+                    if (m.dust_nsub(specIND) <= m.dust_substep){
+                        continue;               // this species has taken all its substeps
+                    }
+                    // substep of this species and the gas velocity at its start
+                    double dts = dt / m.dust_nsub(specIND);
+                    double theta = (double) m.dust_substep / m.dust_nsub(specIND);
+                    double vgas1 = gas_velocity(m, 0, theta, kk, jj, ii);
+                    double vgas2 = gas_velocity(m, 1, theta, kk, jj, ii);
+                    double vgas3 = gas_velocity(m, 2, theta, kk, jj, ii);
                     m.dcons(specIND, IDN, kk, jj, ii)
-                                -= (dt / m.dx1(ii) * (fdcons(specIND, IDN, 0, kkf, jjf, iif + 1) - fdcons(specIND, IDN, 0, kkf, jjf, iif))
-                                  + dt / m.dx2(jj) * (fdcons(specIND, IDN, 1, kkf, jjf + 1, iif) - fdcons(specIND, IDN, 1, kkf, jjf, iif))
-                                  + dt / m.dx3(kk) * (fdcons(specIND, IDN, 2, kkf + 1, jjf, iif) - fdcons(specIND, IDN, 2, kkf, jjf, iif)));
-                    bool denl0 = m.dcons(specIND, IDN, kk, jj, ii) < m.dminDensity;
-                    bool stldt = stoppingtimemesh(specIND, kk, jj, ii) < dt;
+                                -= (dts / m.dx1(ii) * (fdcons(specIND, IDN, 0, kkf, jjf, iif + 1) - fdcons(specIND, IDN, 0, kkf, jjf, iif))
+                                  + dts / m.dx2(jj) * (fdcons(specIND, IDN, 1, kkf, jjf + 1, iif) - fdcons(specIND, IDN, 1, kkf, jjf, iif))
+                                  + dts / m.dx3(kk) * (fdcons(specIND, IDN, 2, kkf + 1, jjf, iif) - fdcons(specIND, IDN, 2, kkf, jjf, iif)));
+                    bool denl0 = m.dcons(specIND, IDN, kk, jj, ii) < (state_real) m.dminDensity;     // the floor as stored, so floor cells are not below it
+                    // the exponential drag holds for any stopping time, the explicit one needs the terminal velocity
+                    // approximation where ts < dts
+                    bool stldt = (m.modules.dust_drag == DRAG_EXPLICIT) && stoppingtimemesh(specIND, kk, jj, ii) < dts;
                     if (denl0 || stldt){
                         if (denl0){
                             m.dcons(specIND, IDN, kk, jj, ii) = m.dminDensity;
@@ -203,7 +285,7 @@ void advect_cons_dust_cartesian(mesh &m, double &dt, int &NUMSPECIES, BootesArra
                         rhogradphix2 = 0;
                         rhogradphix3 = 0;
                         #endif // ENABLE_GRAVITY
-                        dust_terminalvelocityapprixmation_xyz(m.prim(IV1, kk, jj, ii), m.prim(IV2, kk, jj, ii), m.prim(IV3, kk, jj, ii),
+                        dust_terminalvelocityapprixmation_xyz(vgas1, vgas2, vgas3,
                                                               rhogradphix1, rhogradphix2, rhogradphix3,
                                                               m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii),
                                                               m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)
@@ -217,9 +299,9 @@ void advect_cons_dust_cartesian(mesh &m, double &dt, int &NUMSPECIES, BootesArra
                     else{
                         // if density is fine, then calculate everything self-consistantly.
                         for (int dconsIND = 1; dconsIND < NUMCONS - 1; dconsIND++){
-                            m.dcons(specIND, dconsIND, kk, jj, ii) -= (dt / m.dx1(ii) * (fdcons(specIND, dconsIND, 0, kkf, jjf, iif + 1) - fdcons(specIND, dconsIND, 0, kkf, jjf, iif))
-                                                                     + dt / m.dx2(jj) * (fdcons(specIND, dconsIND, 1, kkf, jjf + 1, iif) - fdcons(specIND, dconsIND, 1, kkf, jjf, iif))
-                                                                     + dt / m.dx3(kk) * (fdcons(specIND, dconsIND, 2, kkf + 1, jjf, iif) - fdcons(specIND, dconsIND, 2, kkf, jjf, iif)));
+                            m.dcons(specIND, dconsIND, kk, jj, ii) -= (dts / m.dx1(ii) * (fdcons(specIND, dconsIND, 0, kkf, jjf, iif + 1) - fdcons(specIND, dconsIND, 0, kkf, jjf, iif))
+                                                                     + dts / m.dx2(jj) * (fdcons(specIND, dconsIND, 1, kkf, jjf + 1, iif) - fdcons(specIND, dconsIND, 1, kkf, jjf, iif))
+                                                                     + dts / m.dx3(kk) * (fdcons(specIND, dconsIND, 2, kkf + 1, jjf, iif) - fdcons(specIND, dconsIND, 2, kkf, jjf, iif)));
                         }
                         // geometry term
 
@@ -237,24 +319,43 @@ void advect_cons_dust_cartesian(mesh &m, double &dt, int &NUMSPECIES, BootesArra
                         rhogradphix3 = 0;
                         #endif // ENABLE_GRAVITY
 
-                        // apply gravity
-                        m.dcons(specIND, IM1, kk, jj, ii) += rhogradphix1 * dt;
-                        m.dcons(specIND, IM2, kk, jj, ii) += rhogradphix2 * dt;
-                        m.dcons(specIND, IM3, kk, jj, ii) += rhogradphix3 * dt;
-                        // gas drag
-                        double vdust1 = m.dcons(specIND, IV1, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas1  = m.prim(IV1, kk, jj, ii);
-                        double vdust2 = m.dcons(specIND, IV2, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas2  = m.prim(IV2, kk, jj, ii);
-                        double vdust3 = m.dcons(specIND, IV3, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
-                        double vgas3  = m.prim(IV3, kk, jj, ii);
-                        double rhodt_stime = m.dcons(specIND, IDN, kk, jj, ii) * dt / stoppingtimemesh(specIND, kk, jj, ii);
-                        double dragMOM1 = rhodt_stime * (vgas1 - vdust1);
-                        double dragMOM2 = rhodt_stime * (vgas2 - vdust2);
-                        double dragMOM3 = rhodt_stime * (vgas3 - vdust3);
-                        m.dcons(specIND, IM1, kk, jj, ii) += dragMOM1;
-                        m.dcons(specIND, IM2, kk, jj, ii) += dragMOM2;
-                        m.dcons(specIND, IM3, kk, jj, ii) += dragMOM3;
+                        if (m.modules.dust_drag != DRAG_EXPLICIT){
+                            // with feedback on the gas, gravity and drag are applied cell by cell in dust_gas_drag
+                            if (!m.modules.dust_feedback){
+                                double vg[3]  = {vgas1, vgas2, vgas3};
+                                double accel[3] = {rhogradphix1 / m.dprim(specIND, IDN, kk, jj, ii),
+                                                   rhogradphix2 / m.dprim(specIND, IDN, kk, jj, ii),
+                                                   rhogradphix3 / m.dprim(specIND, IDN, kk, jj, ii)};
+                                double pd[3]  = {m.dcons(specIND, IM1, kk, jj, ii), m.dcons(specIND, IM2, kk, jj, ii), m.dcons(specIND, IM3, kk, jj, ii)};
+                                if (m.modules.dust_drag == DRAG_EXPONENTIAL){
+                                    double eps = 0;
+                                    dust_drag_exponential(vg, eps, m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), dts, accel, pd);
+                                }
+                                else {
+                                    dust_drag_implicit(vg, m.dcons(specIND, IDN, kk, jj, ii), stoppingtimemesh(specIND, kk, jj, ii), dts, accel, pd);
+                                }
+                                m.dcons(specIND, IM1, kk, jj, ii) = pd[0];
+                                m.dcons(specIND, IM2, kk, jj, ii) = pd[1];
+                                m.dcons(specIND, IM3, kk, jj, ii) = pd[2];
+                            }
+                        }
+                        else {
+                            // apply gravity
+                            m.dcons(specIND, IM1, kk, jj, ii) += rhogradphix1 * dts;
+                            m.dcons(specIND, IM2, kk, jj, ii) += rhogradphix2 * dts;
+                            m.dcons(specIND, IM3, kk, jj, ii) += rhogradphix3 * dts;
+                            // gas drag
+                            double vdust1 = (double) m.dcons(specIND, IV1, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double vdust2 = (double) m.dcons(specIND, IV2, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double vdust3 = (double) m.dcons(specIND, IV3, kk, jj, ii) / m.dcons(specIND, IDN, kk, jj, ii);
+                            double rhodt_stime = m.dcons(specIND, IDN, kk, jj, ii) * dts / stoppingtimemesh(specIND, kk, jj, ii);
+                            double dragMOM1 = rhodt_stime * (vgas1 - vdust1);
+                            double dragMOM2 = rhodt_stime * (vgas2 - vdust2);
+                            double dragMOM3 = rhodt_stime * (vgas3 - vdust3);
+                            m.dcons(specIND, IM1, kk, jj, ii) += dragMOM1;
+                            m.dcons(specIND, IM2, kk, jj, ii) += dragMOM2;
+                            m.dcons(specIND, IM3, kk, jj, ii) += dragMOM3;
+                        }
                     }
                 }
             }
@@ -271,4 +372,9 @@ void advect_cons_dust(mesh &m, double &dt, int &NUMSPECIES, BootesArray<double>
     #else
         # error need coordinate defined
     #endif
+    if (m.modules.dust_feedback){
+        dust_gas_drag(m, dt, stoppingtimemesh);
+    }
 }
+
+#endif // ENABLE_DUSTFLUID
@@ -1,21 +1,162 @@
 #include <cmath>
+#include <omp.h>
 
-//#include "../reconstruct/const_recon.hpp"
+#include "../reconstruct/const_recon.hpp"
 #include "../reconstruct/minmod.hpp"
-//#include "../reconstruct/MUSCL_Hancock.hpp"
+#include "../reconstruct/MUSCL_Hancock.hpp"
+#include "../reconstruct/ppm.hpp"
+#include "../reconstruct/weno5.hpp"
+#include "../reconstruct/primitive_recon.hpp"
 #include "../time_step/time_step.hpp"
 #include "../BootesArray.hpp"
 #include "../util/util.hpp"
-//#include "../hydro/hll.hpp"
+#include "../hydro/hll.hpp"
 #include "../hydro/hlle.hpp"
-//#include "../hydro/hllc.hpp"
+#include "../hydro/hllc.hpp"
+#include "../hydro/roe.hpp"
 #include "../boundary_condition/apply_bc.hpp"
 #include "../index_def.hpp"
 #include "../mesh/mesh.hpp"
 #include "../eos/eos.hpp"
+#include "adv_hydro.hpp"
 
 
-void calc_flux(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+// Riemann problems of nface faces, left states L[var][ff] and right states R[var][ff], fluxes to F[var][ff].
+// The states are conserved, or primitive with reconstruction_variables = primitive or characteristic.
+template <int RIEMANN>
+static void riemann_row(mesh &m, int IMP, int nface, double **L, double **R, double **F){
+    if (m.modules.recon_variables != RECON_VARS_CONSERVED){
+        #ifdef ENABLE_TEMPERATURE_PROTECTION
+        for (int ii = 0; ii < nface; ii ++){
+            L[IPN][ii] = pressure_from_temperature_protection(L[IDN][ii], L[IPN][ii], m.minTemp);
+            R[IPN][ii] = pressure_from_temperature_protection(R[IDN][ii], R[IPN][ii], m.minTemp);
+        }
+        #endif // ENABLE_TEMPERATURE_PROTECTION
+        if constexpr (RIEMANN == RIEMANN_HLL){
+            hll_prim_batch(nface, L, R, F, IMP, m.hydro_gamma);
+        }
+        else if constexpr (RIEMANN == RIEMANN_HLLE){
+            hlle_prim_batch(nface, L, R, F, IMP, m.hydro_gamma);
+        }
+        else if constexpr (RIEMANN == RIEMANN_HLLC){
+            hllc_prim_batch(nface, L, R, F, IMP, m.hydro_gamma);
+        }
+        else {
+            roe_prim_batch(nface, L, R, F, IMP, m.hydro_gamma);
+        }
+        return;
+    }
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    // each face state goes into one Riemann problem only, so it can be fixed in place
+    for (int ii = 0; ii < nface; ii ++){
+        L[IEN][ii] = energy_from_temperature_protection(L[IDN][ii], L[IEN][ii], L[IM1][ii], L[IM2][ii], L[IM3][ii], m.minTemp, m.hydro_gamma);
+        R[IEN][ii] = energy_from_temperature_protection(R[IDN][ii], R[IEN][ii], R[IM1][ii], R[IM2][ii], R[IM3][ii], m.minTemp, m.hydro_gamma);
+    }
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    // IMP: the momentum term to add pressure; shift by one index (since first index is density)
+    if constexpr (RIEMANN == RIEMANN_HLL){
+        hll_batch(nface, L, R, F, IMP, m.hydro_gamma);
+    }
+    else if constexpr (RIEMANN == RIEMANN_HLLE){
+        hlle_batch(nface, L, R, F, IMP, m.hydro_gamma);
+    }
+    else if constexpr (RIEMANN == RIEMANN_HLLC){
+        hllc_batch(nface, L, R, F, IMP, m.hydro_gamma);
+    }
+    else {
+        roe_batch(nface, L, R, F, IMP, m.hydro_gamma);
+    }
+}
+
+
+// PPM and WENO5 face states can undershoot at strong jumps: a cell with a face density or pressure <= 0 falls
+// back to its cell value on both faces
+static void positive_faces(mesh &m, int axis, int kk, int jj, int is, int ie, double **BL, double **BR){
+    BootesView<state_real, 4> cons(m.cons);
+    double gm1 = m.hydro_gamma - 1.;
+    for (int ii = is; ii < ie; ii++){
+        int ff = ii - is;
+        double pL = gm1 * (BL[IEN][ff] - 0.5 * (BL[IM1][ff] * BL[IM1][ff] + BL[IM2][ff] * BL[IM2][ff] + BL[IM3][ff] * BL[IM3][ff]) / BL[IDN][ff]);
+        double pR = gm1 * (BR[IEN][ff] - 0.5 * (BR[IM1][ff] * BR[IM1][ff] + BR[IM2][ff] * BR[IM2][ff] + BR[IM3][ff] * BR[IM3][ff]) / BR[IDN][ff]);
+        if (BL[IDN][ff] > 0 && BR[IDN][ff] > 0 && pL > 0 && pR > 0){
+            continue;
+        }
+        for (int var = 0; var < NUMCONS; var++){
+            BL[var][ff] = BR[var][ff] = cons(var, m.x3s + kk, m.x2s + jj, m.x1s + ii);
+        }
+    }
+}
+
+
+template <int RECON>
+static void reconstruct_row(mesh &m, int axis, int kk, int jj, int is, int ie, double &dt, double **BL, double **BR){
+    if (m.modules.recon_variables != RECON_VARS_CONSERVED){
+        reconstruct_prim_row(m, RECON, axis, kk, jj, is, ie, dt, BL, BR);
+        return;
+    }
+    if constexpr (RECON == RECON_CONST){
+        reconstruct_const_row(m, axis, kk, jj, is, ie, dt, BL, BR);
+    }
+    else if constexpr (RECON == RECON_MINMOD){
+        reconstruct_minmod_row(m, axis, kk, jj, is, ie, dt, BL, BR);
+    }
+    else if constexpr (RECON == RECON_MHM){
+        reconstruct_MHM_row(m, axis, kk, jj, is, ie, dt, BL, BR);
+    }
+    else if constexpr (RECON == RECON_PPM){
+        reconstruct_PPM_row(m, axis, kk, jj, is, ie, dt, BL, BR);
+        positive_faces(m, axis, kk, jj, is, ie, BL, BR);
+    }
+    else {
+        reconstruct_WENO5_row(m, axis, kk, jj, is, ie, dt, BL, BR);
+        positive_faces(m, axis, kk, jj, is, ie, BL, BR);
+    }
+}
+
+
+// valsL/valsR of one axis from reconstruct_row, for PPM, WENO5 and the primitive variables, which have no full
+// grid version: the cells -1 .. n along the axis, BR of a cell is the left state of the face above it, BL the
+// right state of its own
+template <int RECON>
+static void reconstruct_from_rows(mesh &m, BootesArray<double> &valsL, BootesArray<double> &valsR,
+                                  int x1excess, int x2excess, int x3excess, int axis, double &dt){
+    BootesView<double, 4> tile(m.flux_tile);
+    BootesView<double, 5> vL(valsL);
+    BootesView<double, 5> vR(valsR);
+    #pragma omp parallel for collapse (2) schedule (static)
+    for (int kk = - x3excess; kk < m.nx3 + x3excess; kk ++){
+        for (int jj = - x2excess; jj < m.nx2 + x2excess; jj ++){
+            int tid = omp_get_thread_num();
+            double *BL[NUMCONS], *BR[NUMCONS];
+            for (int var = 0; var < NUMCONS; var++){
+                BL[var] = tile.ptr(tid, 0, var);
+                BR[var] = tile.ptr(tid, 1, var);
+            }
+            reconstruct_row<RECON>(m, axis, kk, jj, - x1excess, m.nx1 + x1excess, dt, BL, BR);
+            bool storeR = (kk >= 0 && jj >= 0);             // the row below the first face has no face of its own
+            bool storeL = (kk < m.nx3 && jj < m.nx2);       // nor the row above the last face one above it
+            for (int var = 0; var < NUMCONS; var++){
+                if (storeR){
+                    double *R = vR.ptr(axis, var, kk, jj);
+                    for (int ii = 0; ii < m.nx1 + x1excess; ii++){
+                        R[ii] = BL[var][ii + x1excess];
+                    }
+                }
+                if (storeL){
+                    double *L = vL.ptr(axis, var, kk + x3excess, jj + x2excess);
+                    for (int ii = 0; ii < m.nx1 + x1excess; ii++){
+                        L[ii] = BR[var][ii];
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// flux_pass = axis: for every axis one sweep to reconstruct all faces into valsL/valsR, one to solve them
+template <int RECON, int RIEMANN>
+static void calc_flux_axis(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
     // store the reconstructed value
     // index: (advecting direction, quantity, kk, jj, ii)
     for (int axis = 0; axis < m.dim; axis ++){
@@ -27,49 +168,141 @@ void calc_flux(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<doub
         else if (axis == 2){ x1excess = 0; x2excess = 0; x3excess = 1; IMP = IM3;}
         else { cout << "axis > 3!!!" << endl << flush; throw 1; }
 
-        reconstruct_minmod(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
-        // step 1.2: solve the Riemann problem. Use HLL for now, update conservative vars
-        #pragma omp parallel for collapse (3) schedule (static)
+        if (m.modules.recon_variables != RECON_VARS_CONSERVED){
+            reconstruct_from_rows<RECON>(m, valsL, valsR, x1excess, x2excess, x3excess, axis, dt);
+        }
+        else if constexpr (RECON == RECON_CONST){
+            reconstruct_const(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
+        }
+        else if constexpr (RECON == RECON_MINMOD){
+            reconstruct_minmod(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
+        }
+        else if constexpr (RECON == RECON_MHM){
+            reconstruct_MHM(m, valsL, valsR, x1excess, x2excess, x3excess, axis, IMP, dt);
+        }
+        else {
+            reconstruct_from_rows<RECON>(m, valsL, valsR, x1excess, x2excess, x3excess, axis, dt);
+        }
+        // step 1.2: solve the Riemann problem, one x1 row of faces per call
+        BootesView<double, 5> vL(valsL);
+        BootesView<double, 5> vR(valsR);
+        BootesView<double, 5> flux(fcons);
+        #pragma omp parallel for collapse (2) schedule (static)
         for (int kk = 0; kk < m.nx3 + x3excess; kk ++){
             for (int jj = 0; jj < m.nx2 + x2excess; jj ++){
-                for (int ii = 0; ii < m.nx1 + x1excess; ii ++){
-                    double valL[5];
-                    double valR[5];
-                    double fxs[5];
-                    valL[IDN] = valsL(axis, IDN, kk, jj, ii); valR[IDN] = valsR(axis, IDN, kk, jj, ii);
-                    valL[IM1] = valsL(axis, IM1, kk, jj, ii); valR[IM1] = valsR(axis, IM1, kk, jj, ii);
-                    valL[IM2] = valsL(axis, IM2, kk, jj, ii); valR[IM2] = valsR(axis, IM2, kk, jj, ii);
-                    valL[IM3] = valsL(axis, IM3, kk, jj, ii); valR[IM3] = valsR(axis, IM3, kk, jj, ii);
-                    valL[IEN] = valsL(axis, IEN, kk, jj, ii); valR[IEN] = valsR(axis, IEN, kk, jj, ii);
-                    #ifdef ENABLE_TEMPERATURE_PROTECTION
-                    valL[IEN] = energy_from_temperature_protection(valL[IDN], valL[IEN], valL[IM1], valL[IM2], valL[IM3], m.minTemp, m.hydro_gamma);
-                    valR[IEN] = energy_from_temperature_protection(valR[IDN], valR[IEN], valR[IM1], valR[IM2], valR[IM3], m.minTemp, m.hydro_gamma);
-                    #endif // ENABLE_TEMPERATURE_PROTECTION
-                    hlle(valL, valR, fxs,
-                         IMP,                   // the momentum term to add pressure; shift by one index (since first index is density)
-                         m.hydro_gamma
-                         );
-                    fcons(IDN, axis, kk, jj, ii) = fxs[IDN];
-                    fcons(IM1, axis, kk, jj, ii) = fxs[IM1];
-                    fcons(IM2, axis, kk, jj, ii) = fxs[IM2];
-                    fcons(IM3, axis, kk, jj, ii) = fxs[IM3];
-                    fcons(IEN, axis, kk, jj, ii) = fxs[IEN];
+                double *L[NUMCONS], *R[NUMCONS], *F[NUMCONS];
+                for (int var = 0; var < NUMCONS; var++){
+                    L[var] = vL.ptr(axis, var, kk, jj);
+                    R[var] = vR.ptr(axis, var, kk, jj);
+                    F[var] = flux.ptr(var, axis, kk, jj);
                 }
+                riemann_row<RIEMANN>(m, IMP, m.nx1 + x1excess, L, R, F);
             }
         }
     }
-    // Need to set unused values in the fdcons to zeros.
-    // To do so the axis goes from "number of active axis" to 3
-    #pragma omp parallel for collapse (4) schedule (static)
-    for (int axis = m.dim; axis < 3; axis ++){
-        for (int kk = 0; kk < fcons.shape()[2]; kk ++){
-            for (int jj = 0; jj < fcons.shape()[3]; jj ++){
-                for (int ii = 0; ii < fcons.shape()[4]; ii ++){
-                    fcons(IDN, axis, kk, jj, ii) = 0.0;
-                    fcons(IM1, axis, kk, jj, ii) = 0.0;
-                    fcons(IM2, axis, kk, jj, ii) = 0.0;
-                    fcons(IM3, axis, kk, jj, ii) = 0.0;
-                    fcons(IEN, axis, kk, jj, ii) = 0.0;
+}
+
+
+// rows[var] = start of the per thread row (tid, row, var) of m.flux_tile
+static void tile_rows(BootesView<double, 4> &tile, int tid, int row, double **rows){
+    for (int var = 0; var < NUMCONS; var++){
+        rows[var] = tile.ptr(tid, row, var);
+    }
+}
+
+
+// rows[var] = flux of the faces (kk, jj, i0 ...) along axis
+static void flux_rows(BootesView<double, 5> &flux, int axis, int kk, int jj, int i0, double **rows){
+    for (int var = 0; var < NUMCONS; var++){
+        rows[var] = flux.ptr(var, axis, kk, jj) + i0;
+    }
+}
+
+
+// flux_pass = tiled: one parallel region for all axes. While a tile is swept along x3, the x1 faces of a row are
+// solved in place, the x2 faces carry the states of the previous row and the x3 faces those of the previous plane
+// (as in advect_cons_fused), so the cells around the tile are read from cache by all three axes and the face
+// states never go to memory. A tile solves the faces at its lower edges; the upper edge only at the end of the
+// block. Same values as calc_flux_axis.
+template <int RECON, int RIEMANN>
+static void calc_flux_tiled(mesh &m, double &dt, BootesArray<double> &fcons){
+    BootesView<double, 4> tile(m.flux_tile);
+    BootesView<double, 5> flux(fcons);
+    int nb1 = (m.nx1 + FLUX_X1_BLOCK - 1) / FLUX_X1_BLOCK;
+    int nb2 = (m.nx2 + FLUX_X2_BLOCK - 1) / FLUX_X2_BLOCK;
+    int nb3 = (m.nx3 + FLUX_X3_BLOCK - 1) / FLUX_X3_BLOCK;
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        double *xBL[NUMCONS], *xBR[NUMCONS], *xBLnext[NUMCONS];
+        double *yBL[2][NUMCONS], *yBR[2][NUMCONS];
+        double *zBL[2][NUMCONS], *zBR[2][NUMCONS];
+        double *F[NUMCONS];
+        tile_rows(tile, tid, 0, xBL);
+        tile_rows(tile, tid, 1, xBR);
+        for (int slot = 0; slot < 2; slot++){
+            tile_rows(tile, tid, 2 + slot, yBL[slot]);
+            tile_rows(tile, tid, 4 + slot, yBR[slot]);
+        }
+        for (int var = 0; var < NUMCONS; var++){
+            xBLnext[var] = xBL[var] + 1;
+        }
+
+        #pragma omp for schedule (static)
+        for (int tileIND = 0; tileIND < nb1 * nb2 * nb3; tileIND ++){
+            int i0 = (tileIND % nb1) * FLUX_X1_BLOCK;
+            int i1 = std::min(m.nx1, i0 + FLUX_X1_BLOCK);
+            int j0 = (tileIND / nb1 % nb2) * FLUX_X2_BLOCK;
+            int j1 = std::min(m.nx2, j0 + FLUX_X2_BLOCK);
+            int k0 = (tileIND / (nb1 * nb2)) * FLUX_X3_BLOCK;
+            int k1 = std::min(m.nx3, k0 + FLUX_X3_BLOCK);
+            int ncell = i1 - i0;
+            int nx1face = (i1 == m.nx1) ? ncell + 1 : ncell;
+            bool x2last = (j1 == m.nx2);
+            bool x3last = (k1 == m.nx3);
+            for (int kk = k0; kk < k1; kk ++){
+                int zs = (kk - k0) % 2;         // slot of plane kk, the other one gets kk + 1
+                for (int jj = j0; jj < j1; jj ++){
+                    int ys = (jj - j0) % 2;     // slot of row jj, the other one gets jj + 1
+                    /** x1 faces: left state from cell ff - 1, right state from cell ff **/
+                    reconstruct_row<RECON>(m, 0, kk, jj, i0 - 1, i0 + nx1face, dt, xBL, xBR);
+                    flux_rows(flux, 0, kk, jj, i0, F);
+                    riemann_row<RIEMANN>(m, IM1, nx1face, xBR, xBLnext, F);
+
+                    /** x2 faces jj and jj + 1 **/
+                    if (m.dim > 1){
+                        if (jj == j0){
+                            reconstruct_row<RECON>(m, 1, kk, jj - 1, i0, i1, dt, yBL[1 - ys], yBR[1 - ys]);
+                            reconstruct_row<RECON>(m, 1, kk, jj,     i0, i1, dt, yBL[ys],     yBR[ys]);
+                            flux_rows(flux, 1, kk, jj, i0, F);
+                            riemann_row<RIEMANN>(m, IM2, ncell, yBR[1 - ys], yBL[ys], F);
+                        }
+                        if (jj + 1 < j1 || x2last){
+                            reconstruct_row<RECON>(m, 1, kk, jj + 1, i0, i1, dt, yBL[1 - ys], yBR[1 - ys]);
+                            flux_rows(flux, 1, kk, jj + 1, i0, F);
+                            riemann_row<RIEMANN>(m, IM2, ncell, yBR[ys], yBL[1 - ys], F);
+                        }
+                    }
+
+                    /** x3 faces kk and kk + 1 **/
+                    if (m.dim > 2){
+                        int zrow = 6 + 4 * (jj - j0);
+                        for (int slot = 0; slot < 2; slot++){
+                            tile_rows(tile, tid, zrow + slot,     zBL[slot]);
+                            tile_rows(tile, tid, zrow + 2 + slot, zBR[slot]);
+                        }
+                        if (kk == k0){
+                            reconstruct_row<RECON>(m, 2, kk - 1, jj, i0, i1, dt, zBL[1 - zs], zBR[1 - zs]);
+                            reconstruct_row<RECON>(m, 2, kk,     jj, i0, i1, dt, zBL[zs],     zBR[zs]);
+                            flux_rows(flux, 2, kk, jj, i0, F);
+                            riemann_row<RIEMANN>(m, IM3, ncell, zBR[1 - zs], zBL[zs], F);
+                        }
+                        if (kk + 1 < k1 || x3last){
+                            reconstruct_row<RECON>(m, 2, kk + 1, jj, i0, i1, dt, zBL[1 - zs], zBR[1 - zs]);
+                            flux_rows(flux, 2, kk + 1, jj, i0, F);
+                            riemann_row<RIEMANN>(m, IM3, ncell, zBR[zs], zBL[1 - zs], F);
+                        }
+                    }
                 }
             }
         }
@@ -77,19 +310,71 @@ void calc_flux(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<doub
 }
 
 
+// One instantiation per reconstruction, Riemann solver and flux pass, picked in calc_flux() from m.modules
+template <int RECON, int RIEMANN>
+static void calc_flux_modules(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+    if (m.modules.flux_pass == FLUX_PASS_TILED){
+        calc_flux_tiled<RECON, RIEMANN>(m, dt, fcons);
+    }
+    else {
+        calc_flux_axis<RECON, RIEMANN>(m, dt, fcons, valsL, valsR);
+    }
+}
+
+
+template <int RECON>
+static void calc_flux_recon(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+    switch (m.modules.riemann_solver){
+        case RIEMANN_HLL:  calc_flux_modules<RECON, RIEMANN_HLL> (m, dt, fcons, valsL, valsR); break;
+        case RIEMANN_HLLE: calc_flux_modules<RECON, RIEMANN_HLLE>(m, dt, fcons, valsL, valsR); break;
+        case RIEMANN_HLLC: calc_flux_modules<RECON, RIEMANN_HLLC>(m, dt, fcons, valsL, valsR); break;
+        case RIEMANN_ROE:  calc_flux_modules<RECON, RIEMANN_ROE> (m, dt, fcons, valsL, valsR); break;
+        default: cout << "unknown Riemann solver" << endl << flush; throw 1;
+    }
+}
+
+
+void calc_flux(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
+    // the fluxes of unused axes are zeroed once in setupScratchArrays and never written
+    if (m.modules.recon_variables != RECON_VARS_CONSERVED){
+        prim_to_soundspeed(m);
+    }
+    switch (m.modules.reconstruction){
+        case RECON_CONST:  calc_flux_recon<RECON_CONST> (m, dt, fcons, valsL, valsR); break;
+        case RECON_MINMOD: calc_flux_recon<RECON_MINMOD>(m, dt, fcons, valsL, valsR); break;
+        case RECON_MHM:    calc_flux_recon<RECON_MHM>   (m, dt, fcons, valsL, valsR); break;
+        case RECON_PPM:    calc_flux_recon<RECON_PPM>   (m, dt, fcons, valsL, valsR); break;
+        case RECON_WENO5:  calc_flux_recon<RECON_WENO5> (m, dt, fcons, valsL, valsR); break;
+        default: cout << "unknown reconstruction" << endl << flush; throw 1;
+    }
+}
+
+
 void advect_cons(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR){
     #if defined(CARTESIAN_COORD)
-        #pragma omp parallel for collapse (3) schedule (static)
+        BootesView<state_real, 4> cons(m.cons);
+        BootesView<double, 5> flux(fcons);
+        const double * __restrict dx1 = m.dx1.get_arr() + m.x1s;
+        #pragma omp parallel for collapse (2) schedule (static)
         for (int kk = m.x3s; kk < m.x3l; kk ++){
             for (int jj = m.x2s; jj < m.x2l; jj ++){
-                for (int ii = m.x1s; ii < m.x1l; ii ++){
-                    int kkf = kk - m.x3s;
-                    int jjf = jj - m.x2s;
-                    int iif = ii - m.x1s;
-                    for (int consIND = 0; consIND < NUMCONS; consIND++){
-                        m.cons(consIND, kk, jj, ii) -= (dt / m.dx1(ii) * (fcons(consIND, 0, kkf, jjf, iif + 1) - fcons(consIND, 0, kkf, jjf, iif))
-                                                      + dt / m.dx2(jj) * (fcons(consIND, 1, kkf, jjf + 1, iif) - fcons(consIND, 1, kkf, jjf, iif))
-                                                      + dt / m.dx3(kk) * (fcons(consIND, 2, kkf + 1, jjf, iif) - fcons(consIND, 2, kkf, jjf, iif)));
+                int kkf = kk - m.x3s;
+                int jjf = jj - m.x2s;
+                double dtdx2 = dt / m.dx2(jj);
+                double dtdx3 = dt / m.dx3(kk);
+                // one contiguous row per variable, so the ii loop vectorizes
+                for (int consIND = 0; consIND < NUMCONS; consIND++){
+                    state_real * __restrict u     = cons.ptr(consIND, kk, jj) + m.x1s;
+                    const double * __restrict f1  = flux.ptr(consIND, 0, kkf, jjf);
+                    const double * __restrict f2m = flux.ptr(consIND, 1, kkf, jjf);
+                    const double * __restrict f2p = flux.ptr(consIND, 1, kkf, jjf + 1);
+                    const double * __restrict f3m = flux.ptr(consIND, 2, kkf, jjf);
+                    const double * __restrict f3p = flux.ptr(consIND, 2, kkf + 1, jjf);
+                    #pragma omp simd
+                    for (int iif = 0; iif < m.nx1; iif ++){
+                        u[iif] -= (dt / dx1[iif] * (f1[iif + 1] - f1[iif])
+                                 + dtdx2 * (f2p[iif] - f2m[iif])
+                                 + dtdx3 * (f3p[iif] - f3m[iif]));
                     }
                 }
             }
@@ -137,6 +422,153 @@ void advect_cons(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<do
 }
 
 
+#ifdef ENABLE_FUSED_HYDRO
+#if !defined(CARTESIAN_COORD) || defined(ENABLE_VISCOSITY)
+    # error ENABLE_FUSED_HYDRO needs CARTESIAN_COORD and no ENABLE_VISCOSITY (the fluxes are never stored)
+#endif
+// rows[var] = start of pencil row (tid, row, var)
+static void pencil_rows(BootesView<double, 4> &pencil, int tid, int row, double **rows){
+    for (int var = 0; var < NUMCONS; var++){
+        rows[var] = pencil.ptr(tid, row, var);
+    }
+}
+
+
+// hlle on nface faces with left states L[var][ff] and right states R[var][ff], as in calc_flux
+static void hlle_row(mesh &m, int IMP, int nface, double **L, double **R, double **F){
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    // the pencil states are reused by the neighbouring face, so protect copies
+    double *Lp[NUMCONS], *Rp[NUMCONS];
+    double eLp[FUSED_X1_BLOCK + 1], eRp[FUSED_X1_BLOCK + 1];
+    for (int var = 0; var < NUMCONS; var++){
+        Lp[var] = L[var];
+        Rp[var] = R[var];
+    }
+    for (int ff = 0; ff < nface; ff ++){
+        eLp[ff] = energy_from_temperature_protection(L[IDN][ff], L[IEN][ff], L[IM1][ff], L[IM2][ff], L[IM3][ff], m.minTemp, m.hydro_gamma);
+        eRp[ff] = energy_from_temperature_protection(R[IDN][ff], R[IEN][ff], R[IM1][ff], R[IM2][ff], R[IM3][ff], m.minTemp, m.hydro_gamma);
+    }
+    Lp[IEN] = eLp;
+    Rp[IEN] = eRp;
+    hlle_batch(nface, Lp, Rp, F, IMP, m.hydro_gamma);
+    #else
+    hlle_batch(nface, L, R, F, IMP, m.hydro_gamma);
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+}
+
+
+void advect_cons_fused(mesh &m, double &dt){
+    // Each tile is swept along x3. The x1 fluxes of a row are computed in place; the x2 fluxes carry the
+    // upper face of the previous row and the x3 fluxes carry the upper face of the previous plane, so every
+    // face is solved once (plus one x2 face per tile and plane). Nothing is written to m.cons until all
+    // tiles are done, since the neighbouring tiles still read it; the update goes through m.du instead.
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<double, 4> pencil(m.pencil);
+    BootesView<double, 4> du(m.du);
+    int nb1 = (m.nx1 + FUSED_X1_BLOCK - 1) / FUSED_X1_BLOCK;
+    int nb2 = (m.nx2 + FUSED_X2_BLOCK - 1) / FUSED_X2_BLOCK;
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        double *xBL[NUMCONS], *xBR[NUMCONS], *F1[NUMCONS];
+        double *yBL[2][NUMCONS], *yBR[2][NUMCONS], *F2[2][NUMCONS];
+        double *zBL[2][NUMCONS], *zBR[2][NUMCONS], *F3[2][NUMCONS];
+        double *xBLnext[NUMCONS];
+        pencil_rows(pencil, tid, 0, xBL);
+        pencil_rows(pencil, tid, 1, xBR);
+        pencil_rows(pencil, tid, 2, F1);
+        for (int slot = 0; slot < 2; slot++){
+            pencil_rows(pencil, tid, 3 + slot, yBL[slot]);
+            pencil_rows(pencil, tid, 5 + slot, yBR[slot]);
+            pencil_rows(pencil, tid, 7 + slot, F2[slot]);
+        }
+        for (int var = 0; var < NUMCONS; var++){
+            xBLnext[var] = xBL[var] + 1;
+        }
+
+        #pragma omp for schedule (static)
+        for (int tile = 0; tile < nb1 * nb2; tile ++){
+            int i0 = (tile % nb1) * FUSED_X1_BLOCK;
+            int i1 = std::min(m.nx1, i0 + FUSED_X1_BLOCK);
+            int j0 = (tile / nb1) * FUSED_X2_BLOCK;
+            int j1 = std::min(m.nx2, j0 + FUSED_X2_BLOCK);
+            int ncell = i1 - i0;
+            for (int kk = 0; kk < m.nx3; kk ++){
+                int zs = kk % 2;                // slot of plane kk, the other one gets kk + 1
+                for (int jj = j0; jj < j1; jj ++){
+                    int ys = (jj - j0) % 2;     // slot of row jj, the other one gets jj + 1
+                    /** x1 faces i0 .. i1: left state from cell ff - 1, right state from cell ff **/
+                    reconstruct_minmod_row(m, 0, kk, jj, i0 - 1, i1 + 1, dt, xBL, xBR);
+                    hlle_row(m, IM1, ncell + 1, xBR, xBLnext, F1);
+
+                    /** x2 faces jj and jj + 1 **/
+                    if (m.dim > 1){
+                        if (jj == j0){
+                            reconstruct_minmod_row(m, 1, kk, jj - 1, i0, i1, dt, yBL[1 - ys], yBR[1 - ys]);
+                            reconstruct_minmod_row(m, 1, kk, jj,     i0, i1, dt, yBL[ys],     yBR[ys]);
+                            hlle_row(m, IM2, ncell, yBR[1 - ys], yBL[ys], F2[ys]);
+                        }
+                        reconstruct_minmod_row(m, 1, kk, jj + 1, i0, i1, dt, yBL[1 - ys], yBR[1 - ys]);
+                        hlle_row(m, IM2, ncell, yBR[ys], yBL[1 - ys], F2[1 - ys]);
+                    }
+
+                    /** x3 faces kk and kk + 1 **/
+                    int zrow = 9 + 6 * (jj - j0);
+                    for (int slot = 0; slot < 2; slot++){
+                        pencil_rows(pencil, tid, zrow + slot,     zBL[slot]);
+                        pencil_rows(pencil, tid, zrow + 2 + slot, zBR[slot]);
+                        pencil_rows(pencil, tid, zrow + 4 + slot, F3[slot]);
+                    }
+                    if (m.dim > 2){
+                        if (kk == 0){
+                            reconstruct_minmod_row(m, 2, kk - 1, jj, i0, i1, dt, zBL[1 - zs], zBR[1 - zs]);
+                            reconstruct_minmod_row(m, 2, kk,     jj, i0, i1, dt, zBL[zs],     zBR[zs]);
+                            hlle_row(m, IM3, ncell, zBR[1 - zs], zBL[zs], F3[zs]);
+                        }
+                        reconstruct_minmod_row(m, 2, kk + 1, jj, i0, i1, dt, zBL[1 - zs], zBR[1 - zs]);
+                        hlle_row(m, IM3, ncell, zBR[zs], zBL[1 - zs], F3[1 - zs]);
+                    }
+
+                    /** flux divergence, same expression as advect_cons; unused axes have zero flux rows **/
+                    double dtdx2 = dt / m.dx2(m.x2s + jj);
+                    double dtdx3 = dt / m.dx3(m.x3s + kk);
+                    const double * __restrict dx1 = m.dx1.get_arr() + m.x1s + i0;
+                    for (int consIND = 0; consIND < NUMCONS; consIND++){
+                        double * __restrict d         = du.ptr(consIND, kk, jj) + i0;
+                        const double * __restrict f1  = F1[consIND];
+                        const double * __restrict f2m = F2[ys][consIND];
+                        const double * __restrict f2p = F2[1 - ys][consIND];
+                        const double * __restrict f3m = F3[zs][consIND];
+                        const double * __restrict f3p = F3[1 - zs][consIND];
+                        #pragma omp simd
+                        for (int iif = 0; iif < ncell; iif ++){
+                            d[iif] = (dt / dx1[iif] * (f1[iif + 1] - f1[iif])
+                                    + dtdx2 * (f2p[iif] - f2m[iif])
+                                    + dtdx3 * (f3p[iif] - f3m[iif]));
+                        }
+                    }
+                }
+            }
+        }
+
+        #pragma omp for collapse (2) schedule (static)
+        for (int kk = 0; kk < m.nx3; kk ++){
+            for (int jj = 0; jj < m.nx2; jj ++){
+                for (int consIND = 0; consIND < NUMCONS; consIND++){
+                    state_real * __restrict u   = cons.ptr(consIND, m.x3s + kk, m.x2s + jj) + m.x1s;
+                    const double * __restrict d = du.ptr(consIND, kk, jj);
+                    #pragma omp simd
+                    for (int iif = 0; iif < m.nx1; iif ++){
+                        u[iif] -= d[iif];
+                    }
+                }
+            }
+        }
+    }
+}
+#endif // ENABLE_FUSED_HYDRO
+
+
 #ifdef DENSITY_PROTECTION
 void protection(mesh &m, double &minDensity){
     #pragma omp parallel for collapse (3)
@@ -9,12 +9,34 @@
 class mesh;
 
 
+// flux_pass = tiled works on tiles of FLUX_X1_BLOCK cells x FLUX_X2_BLOCK rows x FLUX_X3_BLOCK planes, swept along x3.
+// Per thread it keeps the face states of the x1 row (2), the two x2 rows it carries (4) and the two x3 rows it
+// carries for every x2 row of the tile (4 * FLUX_X2_BLOCK); the fluxes go straight to fcons.
+const int FLUX_X1_BLOCK = 64;
+const int FLUX_X2_BLOCK = 8;
+const int FLUX_X3_BLOCK = 16;
+const int FLUX_TILE_ROWS = 6 + 4 * FLUX_X2_BLOCK;
+
+// Fluxes of all active axes in fcons; valsL and valsR are only used by flux_pass = axis
 void calc_flux(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR);
 
 
 void advect_cons(mesh &m, double &dt, BootesArray<double> &fcons, BootesArray<double> &valsL, BootesArray<double> &valsR);
 
 
+#ifdef ENABLE_FUSED_HYDRO
+// The fused kernel works on tiles of FUSED_X1_BLOCK cells x FUSED_X2_BLOCK rows, swept along x3.
+// Per thread it keeps pencil rows for the x1 states and fluxes (3), the two x2 rows it carries (6),
+// and the two x3 rows it carries for every x2 row of the tile (6 * FUSED_X2_BLOCK).
+const int FUSED_X1_BLOCK = 64;
+const int FUSED_X2_BLOCK = 8;
+const int FUSED_PENCIL_ROWS = 9 + 6 * FUSED_X2_BLOCK;
+
+// calc_flux + advect_cons in one sweep (minmod + hlle), bit-identical to the two-pass path
+void advect_cons_fused(mesh &m, double &dt);
+#endif // ENABLE_FUSED_HYDRO
+
+
 #ifdef DENSITY_PROTECTION
 void protection(mesh &m, double &minDensity);
 #endif // DENSITY_PROTECTION
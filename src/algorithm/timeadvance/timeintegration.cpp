@@ -11,6 +11,8 @@
 #include "../index_def.hpp"
 #include "../eos/eos.hpp"
 #include "../hydro/srcterm/hydrograv.hpp"
+#include <algorithm>
+#include <cmath>
 
 #ifdef ENABLE_VISCOSITY
     #include "../hydro/srcterm/hydroviscosity.hpp"
@@ -28,36 +30,44 @@
 #endif // ENABLE_DUSTFLUID
 
 
-void first_order(mesh &m, double &dt){
+void first_order(mesh &m, double &dt, double &dt_recon){
     // First order integration
     // (axis, z, y, x)
     /** Step 1: calculate flux **/
-    BootesArray<double> valsL;      // boundary left value
-    BootesArray<double> valsR;      // boundary right value
-    BootesArray<double> fcons;      // flux of conservative variables
-    valsL.NewBootesArray(3, NUMCONS, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    valsR.NewBootesArray(3, NUMCONS, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    fcons.NewBootesArray(NUMCONS, 3, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    calc_flux(m, dt, fcons, valsL, valsR);
+    // valsL, valsR (boundary left/right values) and fcons (flux of conservative variables)
+    // are scratch buffers owned by the mesh, allocated once in mesh::setupScratchArrays()
+    #ifndef ENABLE_FUSED_HYDRO
+    calc_flux(m, dt_recon, m.fcons, m.valsL, m.valsR);
+    #endif // ENABLE_FUSED_HYDRO
     #ifdef ENABLE_VISCOSITY
-        apply_viscous_flux(m, dt, fcons, m.nu_vis);
+        apply_viscous_flux(m, dt, m.fcons, m.nu_vis);
     #endif // ENABLE_VISCOSITY
     #if defined(ENABLE_DUSTFLUID)
-    // TODO: the nan values probably comes from the fact that v_dust >> v_gas,
-    // so the CFL is not satisfied for dust. Periahps the way to get around this is to invoke
-    // adaptive time step, for grains which needs to evolve with more time steps
-    BootesArray<double> dvalsL;      // boundary left value
-    BootesArray<double> dvalsR;      // boundary right value
-    BootesArray<double> fdcons;      // flux of dconservative variables
-    dvalsL.NewBootesArray(m.NUMSPECIES, 3, NUMCONS - 1, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    dvalsR.NewBootesArray(m.NUMSPECIES, 3, NUMCONS - 1, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    fdcons.NewBootesArray(m.NUMSPECIES, NUMCONS - 1, 3, m.nx3 + 1, m.nx2 + 1, m.nx1 + 1);
-    calc_flux_dust(m, dt, m.NUMSPECIES, fdcons, dvalsL, dvalsR);
+    // species whose own CFL step (m.dust_dt, from timestep) is shorter than dt cover it in dust_nsub substeps,
+    // at most dust_max_subcycles; the others take dt at once
+    int nsub_max = 1;
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        int nsub = 1;
+        if (dt > m.dust_dt(specIND)){
+            nsub = std::min((double) m.dust_max_subcycles, std::ceil(dt / m.dust_dt(specIND)));
+        }
+        nsub_max = std::max(nsub_max, nsub);
+        // species at the floor (find_floor_species) take no substep; nsub_max still counts them, since under MPI
+        // every block has to take the same number of substeps
+        m.dust_nsub(specIND) = m.dust_floor(specIND) ? 0 : nsub;
+    }
+    m.dust_substep = 0;
+    // dust scratch buffers are allocated once in mesh::setupDustFluidMesh()
+    calc_flux_dust(m, dt_recon, m.NUMSPECIES, m.fdcons, m.dvalsL, m.dvalsR);
     #endif
 
     /** step 2: hydro: time integrate to update CONSERVATIVE variables, solve Riemann Problem **/
     /** step 2.1: hydro **/
-    advect_cons(m, dt, fcons, valsL, valsR);
+    #ifdef ENABLE_FUSED_HYDRO
+        advect_cons_fused(m, dt);
+    #else
+        advect_cons(m, dt, m.fcons, m.valsL, m.valsR);
+    #endif // ENABLE_FUSED_HYDRO
     /** step 2.2: hydro source **/
     #if defined (ENABLE_GRAVITY)
         apply_grav_source_terms(m, dt);
@@ -65,14 +75,18 @@ void first_order(mesh &m, double &dt){
     /** step 3: dust: time integrate to update CONSERVATIVE variables, solve Riemann Problem **/
     /** step 3.1: dust **/
     #ifdef ENABLE_DUSTFLUID
-        BootesArray<double> stoppingtime_mesh;
-        stoppingtime_mesh.NewBootesArray(m.NUMSPECIES, m.x3v.shape()[0], m.x2v.shape()[0], m.x1v.shape()[0]);
-        calc_stoppingtimemesh(m, stoppingtime_mesh);
+        calc_stoppingtimemesh(m, m.stoppingtime_mesh);
 
-        advect_cons_dust(m, dt, m.NUMSPECIES, fdcons, dvalsL, dvalsR, stoppingtime_mesh);
-        #ifdef ENABLE_DUST_GRAINGROWTH
-            grain_growth(m, stoppingtime_mesh, dt);
-        #endif // ENABLE_DUST_GRAINGROWTH
+        advect_cons_dust(m, dt, m.NUMSPECIES, m.fdcons, m.dvalsL, m.dvalsR, m.stoppingtime_mesh);
+        // further substeps of the fast species, against the gas velocity interpolated between the start of the
+        // step (prim) and its end (cons, updated above)
+        for (m.dust_substep = 1; m.dust_substep < nsub_max; m.dust_substep ++){
+            cons_to_prim_dust(m);
+            apply_boundary_condition_dust(m);
+            calc_flux_dust(m, dt_recon, m.NUMSPECIES, m.fdcons, m.dvalsL, m.dvalsR);
+            advect_cons_dust(m, dt, m.NUMSPECIES, m.fdcons, m.dvalsL, m.dvalsR, m.stoppingtime_mesh);
+        }
+        m.dust_substep = 0;
     #endif // ENABLE_DUSTFLUID
 
     /** step 4: protections **/
@@ -85,3 +99,111 @@ void first_order(mesh &m, double &dt){
 }
 
 
+// cons_stage = cons and dcons_stage = dcons over the active cells
+static void save_stage(mesh &m){
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> reg(m.cons_stage);
+    #pragma omp parallel for collapse (2) schedule (static)
+    for (int kk = m.x3s; kk < m.x3l; kk ++){
+        for (int jj = m.x2s; jj < m.x2l; jj ++){
+            for (int consIND = 0; consIND < NUMCONS; consIND++){
+                const state_real *u = cons.ptr(consIND, kk, jj);
+                state_real *u0 = reg.ptr(consIND, kk, jj);
+                for (int ii = m.x1s; ii < m.x1l; ii ++){
+                    u0[ii] = u[ii];
+                }
+            }
+        }
+    }
+    #ifdef ENABLE_DUSTFLUID
+    size_t xstep = m.dcons.stride(4);
+    #pragma omp parallel for collapse (3) schedule (static)
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        for (int kk = m.x3s; kk < m.x3l; kk ++){
+            for (int jj = m.x2s; jj < m.x2l; jj ++){
+                for (int consIND = 0; consIND < NUMCONS - 1; consIND++){
+                    const state_real *u = &m.dcons(specIND, consIND, kk, jj, m.x1s);
+                    state_real *u0 = &m.dcons_stage(specIND, consIND, kk, jj, m.x1s);
+                    for (int ii = 0; ii < m.nx1; ii ++){
+                        u0[ii * xstep] = u[ii * xstep];
+                    }
+                }
+            }
+        }
+    }
+    #endif // ENABLE_DUSTFLUID
+}
+
+
+// u = a u0 + (1 - a) u over the active cells, u0 the state saved by save_stage. The species that sit out the
+// step (m.dust_floor) are left as they are, so that they stay exactly at the floor.
+static void combine_stage(mesh &m, double a){
+    double b = 1.0 - a;
+    BootesView<state_real, 4> cons(m.cons);
+    BootesView<state_real, 4> reg(m.cons_stage);
+    #pragma omp parallel for collapse (2) schedule (static)
+    for (int kk = m.x3s; kk < m.x3l; kk ++){
+        for (int jj = m.x2s; jj < m.x2l; jj ++){
+            for (int consIND = 0; consIND < NUMCONS; consIND++){
+                state_real *u = cons.ptr(consIND, kk, jj);
+                const state_real *u0 = reg.ptr(consIND, kk, jj);
+                #pragma omp simd
+                for (int ii = m.x1s; ii < m.x1l; ii ++){
+                    u[ii] = a * u0[ii] + b * u[ii];
+                }
+            }
+        }
+    }
+    #ifdef ENABLE_DUSTFLUID
+    size_t xstep = m.dcons.stride(4);
+    #pragma omp parallel for collapse (3) schedule (static)
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        for (int kk = m.x3s; kk < m.x3l; kk ++){
+            for (int jj = m.x2s; jj < m.x2l; jj ++){
+                if (m.dust_floor(specIND)){
+                    continue;
+                }
+                for (int consIND = 0; consIND < NUMCONS - 1; consIND++){
+                    state_real *u = &m.dcons(specIND, consIND, kk, jj, m.x1s);
+                    const state_real *u0 = &m.dcons_stage(specIND, consIND, kk, jj, m.x1s);
+                    for (int ii = 0; ii < m.nx1; ii ++){
+                        u[ii * xstep] = a * u0[ii * xstep] + b * u[ii * xstep];
+                    }
+                }
+            }
+        }
+    }
+    #endif // ENABLE_DUSTFLUID
+}
+
+
+void time_integrate(mesh &m, double &dt, void (*update_ghosts)(mesh &m)){
+    if (m.modules.integrator == INTEGRATOR_EULER){
+        first_order(m, dt, dt);
+    }
+    else {
+        // SSP Runge-Kutta in the Shu-Osher form: every stage is an Euler step of the whole state, mixed with the
+        // state at the start of the step. The face states are not traced over the stage (dt_recon = 0).
+        //   rk2: u1 = E(u0),  u = 1/2 u0 + 1/2 E(u1)
+        //   rk3: u1 = E(u0),  u2 = 3/4 u0 + 1/4 E(u1),  u = 1/3 u0 + 2/3 E(u2)
+        static const double rk2_weights[2] = {0.0, 0.5};
+        static const double rk3_weights[3] = {0.0, 0.75, 1.0 / 3.0};
+        const double *weights = (m.modules.integrator == INTEGRATOR_RK2) ? rk2_weights : rk3_weights;
+        int nstage = (m.modules.integrator == INTEGRATOR_RK2) ? 2 : 3;
+        double dt_recon = 0;
+        save_stage(m);
+        for (int stage = 0; stage < nstage; stage ++){
+            if (stage > 0){
+                update_ghosts(m);
+            }
+            first_order(m, dt, dt_recon);
+            if (weights[stage] > 0){
+                combine_stage(m, weights[stage]);
+            }
+        }
+    }
+    // grain growth once per step, after the transport and the drag
+    #if defined(ENABLE_DUSTFLUID) && defined(ENABLE_DUST_GRAINGROWTH)
+        grain_growth(m, m.stoppingtime_mesh, dt);
+    #endif // defined(ENABLE_DUSTFLUID) && defined(ENABLE_DUST_GRAINGROWTH)
+}
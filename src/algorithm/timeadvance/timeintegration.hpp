@@ -5,7 +5,16 @@
 class mesh;
 
 
-void first_order(mesh &m, double &dt);
+// One Euler stage of everything but grain growth: gas and dust fluxes, gravity, drag and the dust substeps.
+// dt_recon is the time the reconstruction traces the face states over, dt for a single stage step and 0 in the
+// Runge-Kutta stages.
+void first_order(mesh &m, double &dt, double &dt_recon);
+
+
+/** Advance cons and dcons by dt with m.modules.integrator (euler, rk2 or rk3), then grain growth.
+ *  update_ghosts brings prim, dprim and the ghost zones up to date with cons and dcons (cons_to_prim and the
+ *  boundary conditions); it is called between the stages, not after the last one. **/
+void time_integrate(mesh &m, double &dt, void (*update_ghosts)(mesh &m));
 
 
 #endif // TIME_INTEGRATION_HPP_
@@ -0,0 +1,237 @@
+/**
+ * Drag update of one dust species against the gas: the explicit update with the terminal velocity
+ * approximation where ts < dt (dust_drag = explicit) vs the exponential update (dust_drag = exponential).
+ * Build and run with "make drag_bench"; reports updates per second on one core and the error of both
+ * against the exact solution of dv/dt = (vg - v) / ts + a, binned in dt / ts.
+ * With feedback on the gas, the species of a cell are coupled one after the other with the exponential
+ * update (dust_drag = exponential) or all at once (dust_drag = implicit, dust_drag_implicit_row); both are
+ * timed for 20, 32 and 50 species, with the momentum they fail to conserve.
+ **/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/mesh/mesh.hpp"
+#include "../algorithm/dust/terminalvel.hpp"
+#include "../algorithm/dust/gas_drag_on_dust.hpp"
+
+using namespace std;
+
+static double wtime(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// the update of advect_cons_dust_cartesian with dust_drag = explicit, after the flux update
+static void drag_explicit(const double vg[3], const double accel[3], double rhod, double ts, double dt, state_real pd[3]){
+    if (ts < dt){
+        dust_terminalvelocityapprixmation_xyz(vg[0], vg[1], vg[2], rhod * accel[0], rhod * accel[1], rhod * accel[2],
+                                              rhod, ts, pd[0], pd[1], pd[2]);
+        return;
+    }
+    for (int dd = 0; dd < 3; dd++){
+        pd[dd] += rhod * accel[dd] * dt;
+        pd[dd] += rhod * dt / ts * (vg[dd] - pd[dd] / rhod);
+    }
+}
+
+
+// dust_gas_drag with dust_drag = exponential for one cell: the species one after the other
+static void drag_sequential(int NS, double *gas, double *dust, const double *ts, double dt){
+    double vg[3] = {gas[1] / gas[0], gas[2] / gas[0], gas[3] / gas[0]};
+    double accel[3] = {0, 0, 0};
+    for (int ss = 0; ss < NS; ss++){
+        double rhod = dust[4 * ss];
+        double pd[3] = {dust[4 * ss + 1], dust[4 * ss + 2], dust[4 * ss + 3]};
+        double eps = rhod / gas[0];
+        dust_drag_exponential(vg, eps, rhod, ts[ss], dt, accel, pd);
+        for (int dd = 0; dd < 3; dd++){
+            double drag = pd[dd] - dust[4 * ss + 1 + dd];
+            gas[4] -= 0.5 * (pd[dd] * pd[dd] - dust[4 * ss + 1 + dd] * dust[4 * ss + 1 + dd]) / rhod;
+            gas[1 + dd] -= drag;
+            vg[dd] -= drag / gas[0];
+            dust[4 * ss + 1 + dd] = pd[dd];
+        }
+    }
+}
+
+
+// x1 momentum of gas and dust of a row stored as dust_drag_implicit_row reads it
+static double row_momentum(int n, int NS, BootesArray<double> &gas, BootesArray<double> &dust){
+    double sum = 0;
+    for (int ii = 0; ii < n; ii++){
+        sum += gas(1, ii);
+        for (int ss = 0; ss < NS; ss++){
+            sum += dust(ss, 1, ii);
+        }
+    }
+    return sum;
+}
+
+
+// time the coupled drag of NS species in a row of n cells, dt / ts log-uniform in 1e-3 .. 1e3, dust to gas ratio ~ 1
+static void coupled_drag(int NS, int n, int reps){
+    mt19937_64 rng(NS);
+    uniform_real_distribution<double> uni(-1., 1.);
+    double dt = 1.0;
+    BootesArray<double> gas, dust, ts, work, accel, dts;
+    gas.NewBootesArray(5, n);               // as in cons: density, momenta, energy
+    dust.NewBootesArray(NS, 4, n);          // as in dcons: species, (density, momenta), cell
+    ts.NewBootesArray(NS, n);
+    work.NewBootesArray(8, n);
+    accel.NewBootesArray(3, n);
+    dts.NewBootesArray(NS);
+    accel.set_uniform(0.0);
+    for (int ii = 0; ii < n; ii++){
+        gas(0, ii) = 1. + 0.5 * uni(rng);
+        for (int dd = 0; dd < 3; dd++){
+            gas(1 + dd, ii) = gas(0, ii) * uni(rng);
+        }
+        gas(4, ii) = 10.;
+        for (int ss = 0; ss < NS; ss++){
+            dust(ss, 0, ii) = (1. + 0.9 * uni(rng)) / NS;
+            for (int dd = 0; dd < 3; dd++){
+                dust(ss, 1 + dd, ii) = dust(ss, 0, ii) * 2. * uni(rng);
+            }
+            ts(ss, ii) = dt * pow(10., -3. * uni(rng));
+        }
+    }
+    for (int ss = 0; ss < NS; ss++){
+        dts(ss) = dt;
+    }
+    BootesArray<double> gas0, dust0;
+    gas0.NewBootesArray(5, n);
+    dust0.NewBootesArray(NS, 4, n);
+    for (int ii = 0; ii < gas.arrsize(); ii++){ gas0.get_arr()[ii] = gas.get_arr()[ii]; }
+    for (int ii = 0; ii < dust.arrsize(); ii++){ dust0.get_arr()[ii] = dust.get_arr()[ii]; }
+    double p0 = row_momentum(n, NS, gas, dust);
+
+    double *gasrow[5] = {&gas(0, 0), &gas(1, 0), &gas(2, 0), &gas(3, 0), &gas(4, 0)};
+    const double *accelrow[3] = {&accel(0, 0), &accel(1, 0), &accel(2, 0)};
+    double t0 = wtime();
+    for (int rr = 0; rr < reps; rr++){
+        dust_drag_implicit_row(n, NS, 0.0, gasrow, dust.get_arr(), 4 * (size_t) n, (size_t) n, 1, ts.get_arr(), (size_t) n,
+                               dts.get_arr(), accelrow, work.get_arr());
+    }
+    double t_implicit = wtime() - t0;
+    double err_implicit = abs(row_momentum(n, NS, gas, dust) - p0) / reps;
+
+    // the sequential update works cell by cell on (species, component) of one cell
+    for (int ii = 0; ii < gas.arrsize(); ii++){ gas.get_arr()[ii] = gas0.get_arr()[ii]; }
+    for (int ii = 0; ii < dust.arrsize(); ii++){ dust.get_arr()[ii] = dust0.get_arr()[ii]; }
+    BootesArray<double> cellgas, celldust, cellts;
+    cellgas.NewBootesArray(n, 5);
+    celldust.NewBootesArray(n, NS, 4);
+    cellts.NewBootesArray(n, NS);
+    for (int ii = 0; ii < n; ii++){
+        for (int cc = 0; cc < 5; cc++){ cellgas(ii, cc) = gas(cc, ii); }
+        for (int ss = 0; ss < NS; ss++){
+            for (int cc = 0; cc < 4; cc++){ celldust(ii, ss, cc) = dust(ss, cc, ii); }
+            cellts(ii, ss) = ts(ss, ii);
+        }
+    }
+    t0 = wtime();
+    for (int rr = 0; rr < reps; rr++){
+        for (int ii = 0; ii < n; ii++){
+            drag_sequential(NS, &cellgas(ii, 0), &celldust(ii, 0, 0), &cellts(ii, 0), dt);
+        }
+    }
+    double t_sequential = wtime() - t0;
+    double p1 = 0;
+    for (int ii = 0; ii < n; ii++){
+        p1 += cellgas(ii, 1);
+        for (int ss = 0; ss < NS; ss++){ p1 += celldust(ii, ss, 1); }
+    }
+    double err_sequential = abs(p1 - p0) / reps;
+
+    double cells = (double) n * reps;
+    cout << "  " << setw(3) << NS << "        " << setw(10) << cells / t_sequential / 1e6 << "  " << setw(10) << cells / t_implicit / 1e6
+         << "     " << setw(10) << err_sequential << "  " << setw(10) << err_implicit << endl;
+}
+
+
+int main(int argc, char *argv[]){
+    int nsample = 4096;
+    int reps = 2000;
+    double dt = 1.0;
+
+    // random states with dt / ts spread log-uniformly over 1e-3 .. 1e3
+    BootesArray<double> state;          // (sample, 11): rhod, ts, vg[3], accel[3], vd[3]
+    state.NewBootesArray(nsample, 11);
+    mt19937_64 rng(11);
+    uniform_real_distribution<double> uni(-1., 1.);
+    for (int ss = 0; ss < nsample; ss ++){
+        state(ss, 0) = 1. + 0.9 * uni(rng);
+        state(ss, 1) = dt * pow(10., -3. * uni(rng));
+        for (int dd = 0; dd < 3; dd++){
+            state(ss, 2 + dd) = uni(rng);
+            state(ss, 5 + dd) = 0.1 * uni(rng);
+            state(ss, 8 + dd) = 2. * uni(rng);
+        }
+    }
+
+    // throughput; the sum keeps the compiler from dropping the updates
+    double sum = 0;
+    double t0 = wtime();
+    for (int rr = 0; rr < reps; rr ++){
+        for (int ss = 0; ss < nsample; ss ++){
+            double rhod = state(ss, 0);
+            state_real pd[3] = {(state_real) (rhod * state(ss, 8)), (state_real) (rhod * state(ss, 9)), (state_real) (rhod * state(ss, 10))};
+            drag_explicit(&state(ss, 2), &state(ss, 5), rhod, state(ss, 1), dt, pd);
+            sum += pd[0];
+        }
+    }
+    double t_explicit = wtime() - t0;
+    t0 = wtime();
+    for (int rr = 0; rr < reps; rr ++){
+        for (int ss = 0; ss < nsample; ss ++){
+            double rhod = state(ss, 0);
+            double pd[3] = {rhod * state(ss, 8), rhod * state(ss, 9), rhod * state(ss, 10)};
+            double eps = 0;
+            dust_drag_exponential(&state(ss, 2), eps, rhod, state(ss, 1), dt, &state(ss, 5), pd);
+            sum += pd[0];
+        }
+    }
+    double t_exponential = wtime() - t0;
+    double updates = (double) nsample * reps;
+    cout << setprecision(3);
+    cout << "explicit + terminal velocity: " << updates / t_explicit / 1e6 << " M updates/s" << endl;
+    cout << "exponential:                  " << updates / t_exponential / 1e6 << " M updates/s" << endl;
+
+    // error of the dust velocity relative to the velocity scale |vd0 - vg| + |a| ts, per decade of dt / ts
+    const int nbin = 6;
+    double err_explicit[nbin] = {0}, err_exponential[nbin] = {0};
+    for (int ss = 0; ss < nsample; ss ++){
+        double rhod = state(ss, 0), ts = state(ss, 1);
+        int bin = min(nbin - 1, max(0, (int) floor(log10(dt / ts) + 3.)));
+        state_real pe[3] = {(state_real) (rhod * state(ss, 8)), (state_real) (rhod * state(ss, 9)), (state_real) (rhod * state(ss, 10))};
+        double px[3] = {rhod * state(ss, 8), rhod * state(ss, 9), rhod * state(ss, 10)};
+        double eps = 0;
+        drag_explicit(&state(ss, 2), &state(ss, 5), rhod, ts, dt, pe);
+        dust_drag_exponential(&state(ss, 2), eps, rhod, ts, dt, &state(ss, 5), px);
+        for (int dd = 0; dd < 3; dd++){
+            double vg = state(ss, 2 + dd), a = state(ss, 5 + dd), v0 = state(ss, 8 + dd);
+            double exact = vg + a * ts + (v0 - vg - a * ts) * exp(-dt / ts);
+            double scale = abs(v0 - vg) + abs(a) * ts;
+            err_explicit[bin]    = max(err_explicit[bin], abs(pe[dd] / rhod - exact) / scale);
+            err_exponential[bin] = max(err_exponential[bin], abs(px[dd] / rhod - exact) / scale);
+        }
+    }
+    cout << "max velocity error against the exact solution" << endl;
+    cout << "  dt / ts           explicit    exponential" << endl;
+    for (int bin = 0; bin < nbin; bin ++){
+        cout << "  1e" << bin - 3 << " .. 1e" << bin - 2 << "     " << setw(10) << err_explicit[bin] << "  " << setw(10) << err_exponential[bin] << endl;
+    }
+
+    cout << "coupled drag with feedback, M cells/s and momentum error per step (row of 256 cells)" << endl;
+    cout << "  species    exponential    implicit     exponential    implicit" << endl;
+    for (int NS : {20, 32, 50}){
+        coupled_drag(NS, 256, 400);
+    }
+    cout << "(checksum " << sum << ")" << endl;
+    return 0;
+}
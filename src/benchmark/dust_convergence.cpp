@@ -0,0 +1,71 @@
+/**
+ * Error of a src/setup/dust_advection.cpp frame against the exact solution, the initial pulse shifted by
+ * velocity * time (its parameters are in the UserScalers of the frame). Prints, for species 0 over the active
+ * cells, the L1 error sum|rho - rho_exact| dx1, the max error and the smallest dust density. Used by
+ * src/benchmark/dust_convergence.sh ("make dust_convergence").
+ *
+ *   dust_convergence.out <frame>
+ **/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <H5Cpp.h>
+
+using namespace std;
+using namespace H5;
+
+
+static vector<double> read_dataset(H5File &file, string name, vector<hsize_t> &dims){
+    DataSet dataset = file.openDataSet(name);
+    DataSpace space = dataset.getSpace();
+    dims.resize(space.getSimpleExtentNdims());
+    space.getSimpleExtentDims(dims.data(), NULL);
+    vector<double> values(space.getSimpleExtentNpoints());
+    dataset.read(values.data(), PredType::NATIVE_DOUBLE);
+    return values;
+}
+
+
+template <typename T>
+static T read_attribute(H5File &file, string name, const PredType &type){
+    T value;
+    file.openAttribute(name).read(type, &value);
+    return value;
+}
+
+
+int main(int argc, char *argv[]){
+    if (argc < 2){
+        cout << "usage: " << argv[0] << " <frame>" << endl;
+        return 2;
+    }
+    H5File frame(argv[1], H5F_ACC_RDONLY);
+    double time = read_attribute<double>(frame, "time", PredType::NATIVE_DOUBLE);
+    int x1s = read_attribute<int>(frame, "x1s", PredType::NATIVE_INT32);
+    int x1l = read_attribute<int>(frame, "x1l", PredType::NATIVE_INT32);
+    int x2s = read_attribute<int>(frame, "x2s", PredType::NATIVE_INT32);
+    int x3s = read_attribute<int>(frame, "x3s", PredType::NATIVE_INT32);
+    vector<hsize_t> dims, xdims, udims;
+    vector<double> dcons = read_dataset(frame, "dcons", dims);
+    vector<double> x1v = read_dataset(frame, "x1v", xdims);
+    vector<double> x1f = read_dataset(frame, "x1f", xdims);
+    vector<double> user = read_dataset(frame, "UserScalers", udims);
+    double x0 = user[0] + user[4] * time;
+    double width = user[1], amplitude = user[2], background = user[3];
+
+    // species 0, IDN, the row (x3s, x2s); dcons is (species, var, z, y, x)
+    size_t row = ((size_t) x3s * dims[3] + x2s) * dims[4];
+    double l1 = 0, linf = 0, rhomin = dcons[row + x1s];
+    for (int ii = x1s; ii < x1l; ii++){
+        double xi = (x1v[ii] - x0) / width;
+        double exact = background + amplitude * exp(- xi * xi);
+        double err = abs(dcons[row + ii] - exact);
+        l1 += err * (x1f[ii + 1] - x1f[ii]);
+        linf = max(linf, err);
+        rhomin = min(rhomin, dcons[row + ii]);
+    }
+    cout << setprecision(4) << scientific << l1 << " " << linf << " " << rhomin << endl;
+    return 0;
+}
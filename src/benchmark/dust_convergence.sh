@@ -0,0 +1,82 @@
+#!/bin/bash
+# Convergence of the dust reconstructions and Riemann solvers (dust_reconstruction, dust_riemann_solver in the
+# input file). src/setup/dust_advection.cpp, a smooth dust pulse carried along x1 by gas moving with it, is
+# built once (ENABLE_DUSTFLUID without grain growth and gravity) in a scratch copy of the tree and run at
+# several resolutions with every combination. bin/dust_convergence.out gives the L1 error against the shifted
+# pulse; the table lists it with the convergence order, the wall time of the run and the smallest dust
+# density. Compare the wall time different combinations need to reach the same error. Run from the repository
+# root with "make dust_convergence". BOOTES_CFLAGS, if set, replaces the Makefile CFLAGS; NX overrides the
+# resolutions (default "64 128 256 512 1024"). The scratch tree and outputs are kept in $WORK (default
+# /tmp/bootes_dust_convergence).
+set -e
+
+ROOT=$(pwd)
+WORK=${WORK:-/tmp/bootes_dust_convergence}
+ERROR=$ROOT/bin/dust_convergence.out
+NX=${NX:-64 128 256 512 1024}
+export OMP_NUM_THREADS=${OMP_NUM_THREADS:-1}
+rm -rf $WORK
+mkdir -p $WORK
+
+dir=$WORK/build
+mkdir -p $dir/obj $dir/bin
+cp -r $ROOT/src $ROOT/Makefile $dir/
+sed -i "s|#include \"setup/[^\"]*\"|#include \"setup/dust_advection.cpp\"|" $dir/src/main.cpp
+sed -i "s|^//#define ENABLE_DUSTFLUID\$|#define ENABLE_DUSTFLUID|" $dir/src/defs.hpp
+for flag in ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_MPI; do
+    sed -i "s|^#define $flag\$|//#define $flag|" $dir/src/defs.hpp
+done
+make -C $dir -j ${BOOTES_CFLAGS:+CFLAGS="$BOOTES_CFLAGS"} > $dir/build.log 2>&1 || { tail -20 $dir/build.log; exit 1; }
+
+echo "reconstruction riemann     nx1    L1 error   order   wall [s]   min rho"
+for recon in const minmod; do
+    for riemann in donor hll; do
+        prev=""
+        for nx in $NX; do
+            run=$WORK/run_${recon}_${riemann}_$nx
+            mkdir -p $run/out
+            cat > $run/input.txt <<EOF
+CFL = 0.3
+t_tot = 0.4001
+output_dt = 0.4
+foutput_root = ./out/
+foutput_pre  = da
+foutput_aft  = boot
+output_fields = dcons
+gamma_hydro = 1.4
+dimension = 1
+x1min = 0
+x1max = 1
+nx1 = $nx
+x2min = 0
+x2max = 1
+nx2 = 1
+x3min = 0
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+bc_x1i = standard
+bc_x1o = standard
+dust_bc_x1i = standard
+dust_bc_x1o = standard
+num_species = 1
+srho = 3
+smin = 1e-4
+smax = 1e-3
+dminDensity = 1e-20
+dust_reconstruction = $recon
+dust_riemann_solver = $riemann
+EOF
+            start=$(date +%s.%N)
+            (cd $run && $dir/bin/bootes.out -i input.txt > log.txt 2>&1) || { tail -20 $run/log.txt; exit 1; }
+            wall=$(awk -v a=$start -v b=$(date +%s.%N) 'BEGIN { print b - a }')
+            read l1 linf rhomin <<< "$($ERROR $run/out/da.00001.boot)"
+            order=$(awk -v a="$prev" -v b="$l1" 'BEGIN { if (a == "") print "-"; else printf "%.2f", log(a / b) / log(2) }')
+            printf "%-14s %-7s %7d   %s   %5s   %8.3f   %s\n" $recon $riemann $nx $l1 $order $wall $rhomin
+            prev=$l1
+        done
+    done
+done
@@ -0,0 +1,187 @@
+/**
+ * Species-major (default) vs cell-major (ENABLE_DUST_CELL_MAJOR) storage of dcons and dprim. The same kernels
+ * run on DustArray<double, false> and DustArray<double, true>:
+ *   species sweep  the loop order of cons_to_prim_dust and the flux updates (species outermost, x1 innermost)
+ *   cell gather    the loop order of grain_growth: all species of one cell, pairwise (NUMSPECIES^2 per cell)
+ *   coupled drag   dust_drag_implicit_row on every x1 row (dust_drag = implicit, dust_feedback = on)
+ * Build and run with "make layout_bench" (optional arguments: species, nx1, nx2); reports ms per call and
+ * checks that both layouts give the same numbers.
+ **/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/index_def.hpp"
+#include "../algorithm/dust/dust_array.hpp"
+#include "../algorithm/dust/gas_drag_on_dust.hpp"
+
+using namespace std;
+
+static double wtime(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+template<typename A>
+static void fill(A &dcons, int seed){
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> uni(-1., 1.);
+    int *s = dcons.shape();
+    // the same values in both layouts: drawn in logical order
+    for (int ss = 0; ss < s[0]; ss++){
+        for (int kk = 0; kk < s[2]; kk++){
+            for (int jj = 0; jj < s[3]; jj++){
+                for (int ii = 0; ii < s[4]; ii++){
+                    dcons(ss, IDN, kk, jj, ii) = 1. + 0.9 * uni(rng);
+                    for (int vv = 1; vv < s[1]; vv++){
+                        dcons(ss, vv, kk, jj, ii) = dcons(ss, IDN, kk, jj, ii) * uni(rng);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// cons_to_prim_dust
+template<typename A>
+static void species_sweep(A &dcons, A &dprim){
+    int *s = dcons.shape();
+    #pragma omp parallel for collapse (4) schedule (static)
+    for (int ss = 0; ss < s[0]; ss++){
+        for (int kk = 0; kk < s[2]; kk++){
+            for (int jj = 0; jj < s[3]; jj++){
+                for (int ii = 0; ii < s[4]; ii++){
+                    dprim(ss, IDN, kk, jj, ii) = dcons(ss, IDN, kk, jj, ii);
+                    dprim(ss, IV1, kk, jj, ii) = dcons(ss, IM1, kk, jj, ii) / dcons(ss, IDN, kk, jj, ii);
+                    dprim(ss, IV2, kk, jj, ii) = dcons(ss, IM2, kk, jj, ii) / dcons(ss, IDN, kk, jj, ii);
+                    dprim(ss, IV3, kk, jj, ii) = dcons(ss, IM3, kk, jj, ii) / dcons(ss, IDN, kk, jj, ii);
+                }
+            }
+        }
+    }
+}
+
+
+// collision-rate like sum over species pairs of rho_j rho_k |v_j - v_k|, written to out(k, j, i)
+template<typename A>
+static void cell_gather(A &dprim, BootesArray<double> &out){
+    int *s = dprim.shape();
+    #pragma omp parallel for collapse (3) schedule (static)
+    for (int kk = 0; kk < s[2]; kk++){
+        for (int jj = 0; jj < s[3]; jj++){
+            for (int ii = 0; ii < s[4]; ii++){
+                double sum = 0;
+                for (int js = 0; js < s[0]; js++){
+                    for (int ks = 0; ks < js; ks++){
+                        double dv1 = dprim(js, IV1, kk, jj, ii) - dprim(ks, IV1, kk, jj, ii);
+                        double dv2 = dprim(js, IV2, kk, jj, ii) - dprim(ks, IV2, kk, jj, ii);
+                        double dv3 = dprim(js, IV3, kk, jj, ii) - dprim(ks, IV3, kk, jj, ii);
+                        sum += dprim(js, IDN, kk, jj, ii) * dprim(ks, IDN, kk, jj, ii) * sqrt(dv1 * dv1 + dv2 * dv2 + dv3 * dv3);
+                    }
+                }
+                out(kk, jj, ii) = sum;
+            }
+        }
+    }
+}
+
+
+// dust_gas_drag with dust_drag = implicit; gas (5, z, y, x), ts (species, z, y, x), no other forces
+template<typename A>
+static void coupled_drag(A &dcons, BootesArray<double> &gas, BootesArray<double> &ts, BootesArray<double> &dts, BootesArray<double> &work){
+    int *s = dcons.shape();
+    size_t tstride = (size_t) s[2] * s[3] * s[4];
+    const double *accel[3] = {&work(0, 8, 0), &work(0, 9, 0), &work(0, 10, 0)};
+    for (int kk = 0; kk < s[2]; kk++){
+        for (int jj = 0; jj < s[3]; jj++){
+            double *gasrow[5] = {&gas(0, kk, jj, 0), &gas(1, kk, jj, 0), &gas(2, kk, jj, 0), &gas(3, kk, jj, 0), &gas(4, kk, jj, 0)};
+            dust_drag_implicit_row(s[4], s[0], 0.0, gasrow, &dcons(0, IDN, kk, jj, 0), dcons.stride(0), dcons.stride(1), dcons.stride(4),
+                                   &ts(0, kk, jj, 0), tstride, dts.get_arr(), accel, &work(0, 0, 0));
+        }
+    }
+}
+
+
+template<bool CellMajor>
+static void run(int NS, int nx1, int nx2, int reps, double times[3], double sums[3]){
+    DustArray<double, CellMajor> dcons, dprim;
+    dcons.NewDustArray(NS, 5, 1, nx2, nx1);
+    dprim.NewDustArray(NS, 5, 1, nx2, nx1);
+    fill(dcons, 5);
+    dprim.set_uniform(0.0);
+    BootesArray<double> out, gas, ts, dts, work;
+    out.NewBootesArray(1, nx2, nx1);
+    gas.NewBootesArray(5, 1, nx2, nx1);
+    ts.NewBootesArray(NS, 1, nx2, nx1);
+    dts.NewBootesArray(NS);
+    work.NewBootesArray(1, 11, nx1);
+    work.set_uniform(0.0);
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> uni(-1., 1.);
+    for (int ii = 0; ii < gas.arrsize(); ii++){
+        gas.get_arr()[ii] = 1. + 0.5 * uni(rng);
+    }
+    for (int ii = 0; ii < ts.arrsize(); ii++){
+        ts.get_arr()[ii] = pow(10., -3. * uni(rng));
+    }
+    for (int ss = 0; ss < NS; ss++){
+        dts(ss) = 1.0;
+    }
+
+    double t0 = wtime();
+    for (int rr = 0; rr < reps; rr++){
+        species_sweep(dcons, dprim);
+    }
+    times[0] = (wtime() - t0) / reps;
+    t0 = wtime();
+    for (int rr = 0; rr < reps; rr++){
+        cell_gather(dprim, out);
+    }
+    times[1] = (wtime() - t0) / reps;
+    t0 = wtime();
+    for (int rr = 0; rr < reps; rr++){
+        coupled_drag(dcons, gas, ts, dts, work);
+    }
+    times[2] = (wtime() - t0) / reps;
+
+    sums[0] = sums[1] = sums[2] = 0;
+    for (int jj = 0; jj < nx2; jj++){
+        for (int ii = 0; ii < nx1; ii++){
+            sums[1] += out(0, jj, ii);
+            for (int ss = 0; ss < NS; ss++){
+                sums[0] += dprim(ss, IV1, 0, jj, ii);
+                sums[2] += dcons(ss, IM1, 0, jj, ii);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char *argv[]){
+    int NS  = (argc > 1) ? atoi(argv[1]) : 32;
+    int nx1 = (argc > 2) ? atoi(argv[2]) : 128;
+    int nx2 = (argc > 3) ? atoi(argv[3]) : 128;
+    int reps = 10;
+
+    double tsm[3], tcm[3], ssm[3], scm[3];
+    run<false>(NS, nx1, nx2, reps, tsm, ssm);
+    run<true>(NS, nx1, nx2, reps, tcm, scm);
+
+    const char *names[3] = {"species sweep", "cell gather  ", "coupled drag "};
+    cout << NS << " species, " << nx1 << " x " << nx2 << " cells; ms per call" << endl;
+    cout << "                 species-major  cell-major   ratio   same result" << endl;
+    cout << setprecision(3);
+    bool same = true;
+    for (int kk = 0; kk < 3; kk++){
+        bool equal = (ssm[kk] == scm[kk]);
+        same = same && equal;
+        cout << "  " << names[kk] << "  " << setw(10) << tsm[kk] * 1e3 << "  " << setw(10) << tcm[kk] * 1e3
+             << "  " << setw(7) << tsm[kk] / tcm[kk] << "   " << (equal ? "yes" : "NO") << endl;
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/**
+ * calc_flux with flux_pass = axis (one sweep to reconstruct and one to solve per axis, face states in valsL
+ * and valsR) vs flux_pass = tiled (all axes in one sweep over cache tiles, face states in per thread rows).
+ * Build and run with "make flux_bench"; for 3D cubes of n^3 active cells (default 32 64 128, or the sizes
+ * given as arguments) it reports the measured time per cell of both passes, the bytes each pass streams
+ * through the arrays per cell, the working set against the L2 and L3 sizes of the machine, and checks that
+ * both give bit-identical fluxes. The bytes are counted from the array accesses (every array a pass sweeps
+ * is read or written once per sweep), not from hardware counters; once the working set is well beyond L3,
+ * the ratio of the measured times shows how much of the difference the saved traffic accounts for.
+ **/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <omp.h>
+
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/index_def.hpp"
+#include "../algorithm/mesh/mesh.hpp"
+#include "../algorithm/eos/eos.hpp"
+#include "../algorithm/timeadvance/adv_hydro.hpp"
+
+using namespace std;
+
+static double wtime(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// n^3 periodic box with a smooth flow plus noise in every cell, ghost cells included
+static void setup_box(mesh &m, int n, int flux_pass){
+    map<string, string> choices;
+    choices["flux_pass"] = flux_pass == FLUX_PASS_TILED ? "tiled" : "axis";
+    m.modules.setup_modules(choices);
+    int ng[3] = {2, 2, 2};
+    m.decomp.setup(3, n, n, n, ng, m.modules.bc);
+    m.SetupCartesian(3, 0, 1, n, 2, 0, 1, n, 2, 0, 1, n, 2);
+    m.setupScratchArrays();
+    m.hydro_gamma = 1.4;
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    m.minTemp = 0;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+
+    mt19937 gen(7);
+    uniform_real_distribution<double> noise(-0.05, 0.05);
+    for (int kk = 0; kk < m.x3v.shape()[0]; kk++){
+        for (int jj = 0; jj < m.x2v.shape()[0]; jj++){
+            for (int ii = 0; ii < m.x1v.shape()[0]; ii++){
+                double rho = 1 + 0.3 * sin(6.28 * m.x1v(ii)) * cos(6.28 * m.x2v(jj)) + noise(gen);
+                double v1  = 0.5 * sin(6.28 * m.x2v(jj)) + noise(gen);
+                double v2  = 0.5 * sin(6.28 * m.x3v(kk)) + noise(gen);
+                double v3  = 0.5 * sin(6.28 * m.x1v(ii)) + noise(gen);
+                double p   = 1 + noise(gen);
+                m.prim(IDN, kk, jj, ii) = rho;
+                m.prim(IV1, kk, jj, ii) = v1;
+                m.prim(IV2, kk, jj, ii) = v2;
+                m.prim(IV3, kk, jj, ii) = v3;
+                m.prim(IPN, kk, jj, ii) = p;
+                m.cons(IDN, kk, jj, ii) = rho;
+                m.cons(IM1, kk, jj, ii) = rho * v1;
+                m.cons(IM2, kk, jj, ii) = rho * v2;
+                m.cons(IM3, kk, jj, ii) = rho * v3;
+                m.cons(IEN, kk, jj, ii) = ene(rho, p, v1, v2, v3, m.hydro_gamma);
+            }
+        }
+    }
+}
+
+
+// seconds per call of calc_flux, best of three runs of nrep calls
+static double time_flux(mesh &m, double dt, int nrep){
+    calc_flux(m, dt, m.fcons, m.valsL, m.valsR);
+    double best = 1e30;
+    for (int run = 0; run < 3; run++){
+        double t0 = wtime();
+        for (int rep = 0; rep < nrep; rep++){
+            calc_flux(m, dt, m.fcons, m.valsL, m.valsR);
+        }
+        best = min(best, (wtime() - t0) / nrep);
+    }
+    return best;
+}
+
+
+int main(int argc, char *argv[]){
+    int sizes[16] = {32, 64, 128};
+    int nsize = 3;
+    if (argc > 1){
+        nsize = min(argc - 1, 16);
+        for (int ss = 0; ss < nsize; ss++){
+            sizes[ss] = atoi(argv[ss + 1]);
+        }
+    }
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    cout << "threads " << omp_get_max_threads() << ", L2 " << l2 / 1024 << " KiB, L3 " << l3 / 1024 << " KiB"
+         << " (0: not reported)" << endl;
+    cout << "per thread face state rows of the tiled pass: "
+         << FLUX_TILE_ROWS * NUMCONS * (FLUX_X1_BLOCK + 2) * sizeof(double) / 1024 << " KiB" << endl;
+
+    // bytes per active cell and step streamed through the arrays. axis: every axis reads cons and two prim
+    // variables, writes and reads back valsL and valsR, and writes fcons; tiled: cons and four prim variables
+    // once (the stencil of a tile stays in cache for all axes), and fcons of all axes.
+    double bytes_axis  = 3 * ((NUMCONS + 2) * sizeof(state_real) + 4 * NUMCONS * sizeof(double) + NUMCONS * sizeof(double));
+    double bytes_tiled = (NUMCONS + 4) * sizeof(state_real) + 3 * NUMCONS * sizeof(double);
+    cout << "streamed bytes per cell: axis " << bytes_axis << ", tiled " << bytes_tiled
+         << ", parallel regions per call: axis 6, tiled 1" << endl << endl;
+
+    cout << "    n   working set axis / tiled [MiB]   axis [ns/cell]   tiled [ns/cell]   time ratio   axis [GB/s]   tiled [GB/s]   identical" << endl;
+    for (int ss = 0; ss < nsize; ss++){
+        int n = sizes[ss];
+        double ncell = (double) n * n * n;
+        mesh axis, tiled;
+        setup_box(axis, n, FLUX_PASS_AXIS);
+        setup_box(tiled, n, FLUX_PASS_TILED);
+        double dt = 0.3 / n / 2.;
+        int nrep = max(1, (int) (4e6 / ncell));
+        double t_axis  = time_flux(axis, dt, nrep);
+        double t_tiled = time_flux(tiled, dt, nrep);
+        bool same = memcmp(axis.fcons.get_arr(), tiled.fcons.get_arr(), axis.fcons.arrsize() * sizeof(double)) == 0;
+
+        double ws_axis = (axis.cons.arrsize() + axis.prim.arrsize()) * sizeof(state_real)
+                       + (axis.valsL.arrsize() + axis.valsR.arrsize() + axis.fcons.arrsize()) * sizeof(double);
+        cout << setw(5) << n << "   " << setw(19) << fixed << setprecision(1) << ws_axis / 1048576
+             << " / " << setw(7) << (ws_axis - (axis.valsL.arrsize() + axis.valsR.arrsize()) * sizeof(double)) / 1048576
+             << "   " << setw(14) << setprecision(2) << t_axis / ncell * 1e9
+             << "   " << setw(15) << t_tiled / ncell * 1e9
+             << "   " << setw(10) << t_axis / t_tiled
+             << "   " << setw(11) << bytes_axis * ncell / t_axis / 1e9
+             << "   " << setw(12) << bytes_tiled * ncell / t_tiled / 1e9
+             << "   " << (same ? "yes" : "NO") << endl;
+        if (!same){
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * L1 error of the gas density of a frame against a reference frame of the same problem at a resolution that
+ * is an integer multiple of it: the reference is averaged over the cells of the coarse grid (uniform grids).
+ * Prints the mean |rho - rho_ref| over the active cells. Used by src/benchmark/integrator_convergence.sh
+ * ("make integrator_convergence").
+ *
+ *   integrator_convergence.out <frame> <reference frame>
+ **/
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <H5Cpp.h>
+
+using namespace std;
+using namespace H5;
+
+
+struct Density {
+    vector<double> cons;
+    vector<hsize_t> dims;       // (5, z, y, x), ghost zones included
+    int xs[3], nx[3];           // first active cell and active cells along x1, x2, x3
+};
+
+
+static Density read_density(const char *name){
+    H5File file(name, H5F_ACC_RDONLY);
+    Density d;
+    DataSet dataset = file.openDataSet("cons");
+    DataSpace space = dataset.getSpace();
+    d.dims.resize(space.getSimpleExtentNdims());
+    space.getSimpleExtentDims(d.dims.data(), NULL);
+    d.cons.resize(space.getSimpleExtentNpoints());
+    dataset.read(d.cons.data(), PredType::NATIVE_DOUBLE);
+    const char *start[3] = {"x1s", "x2s", "x3s"};
+    const char *end[3]   = {"x1l", "x2l", "x3l"};
+    for (int ax = 0; ax < 3; ax++){
+        int xl;
+        file.openAttribute(start[ax]).read(PredType::NATIVE_INT32, &d.xs[ax]);
+        file.openAttribute(end[ax]).read(PredType::NATIVE_INT32, &xl);
+        d.nx[ax] = xl - d.xs[ax];
+    }
+    return d;
+}
+
+
+// density (IDN = 0) of active cell (i, j, k), counted from the first active cell
+static double rho(Density &d, int i, int j, int k){
+    return d.cons[((size_t) (d.xs[2] + k) * d.dims[2] + d.xs[1] + j) * d.dims[3] + d.xs[0] + i];
+}
+
+
+int main(int argc, char *argv[]){
+    if (argc < 3){
+        cout << "usage: " << argv[0] << " <frame> <reference frame>" << endl;
+        return 2;
+    }
+    Density run = read_density(argv[1]);
+    Density ref = read_density(argv[2]);
+    int ratio[3];
+    for (int ax = 0; ax < 3; ax++){
+        ratio[ax] = ref.nx[ax] / run.nx[ax];
+        if (ratio[ax] < 1 || ratio[ax] * run.nx[ax] != ref.nx[ax]){
+            cout << "the reference grid is not a multiple of the grid of " << argv[1] << endl;
+            return 1;
+        }
+    }
+    double l1 = 0;
+    double norm = 1.0 / (ratio[0] * ratio[1] * ratio[2]);
+    for (int k = 0; k < run.nx[2]; k++){
+        for (int j = 0; j < run.nx[1]; j++){
+            for (int i = 0; i < run.nx[0]; i++){
+                double mean = 0;
+                for (int kr = 0; kr < ratio[2]; kr++){
+                    for (int jr = 0; jr < ratio[1]; jr++){
+                        for (int ir = 0; ir < ratio[0]; ir++){
+                            mean += rho(ref, i * ratio[0] + ir, j * ratio[1] + jr, k * ratio[2] + kr);
+                        }
+                    }
+                }
+                l1 += abs(rho(run, i, j, k) - mean * norm);
+            }
+        }
+    }
+    l1 /= (double) run.nx[0] * run.nx[1] * run.nx[2];
+    cout << setprecision(4) << scientific << l1 << endl;
+    return 0;
+}
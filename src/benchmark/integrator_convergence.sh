@@ -0,0 +1,118 @@
+#!/bin/bash
+# Error against CPU time of the time integrators (integrator = euler, rk2 or rk3 in the input file) on
+# shock_tube (1D, t = 0.2) and KH with kh_perturbation = sine (2D, smooth shear layers, t = 0.5). Each problem
+# is built once without dust in a scratch copy of the tree and run with every integrator at several
+# resolutions, and once with rk3 at a resolution that is a multiple of all of them as the reference.
+# bin/integrator_convergence.out gives the L1 density error against the reference averaged onto the coarse
+# grid; the table lists it with the convergence order and the wall time of the run. Compare the time the
+# integrators need to reach the same error. Run from the repository root with "make integrator_convergence".
+# RECON sets the reconstruction (default minmod; PPM and WENO5 skip euler); BOOTES_CFLAGS, if set, replaces the Makefile CFLAGS;
+# NX_ST, NX_KH override the resolutions and REF_ST, REF_KH the reference resolutions. The runs use
+# OMP_NUM_THREADS (default 1), the references REF_THREADS (default all cores). The scratch trees and outputs
+# are kept in $WORK (default /tmp/bootes_integrator_convergence).
+set -e
+
+ROOT=$(pwd)
+WORK=${WORK:-/tmp/bootes_integrator_convergence}
+ERROR=$ROOT/bin/integrator_convergence.out
+RECON=${RECON:-minmod}
+NX_ST=${NX_ST:-100 200 400 800}
+REF_ST=${REF_ST:-6400}
+NX_KH=${NX_KH:-32 64 128}
+REF_KH=${REF_KH:-512}
+export OMP_NUM_THREADS=${OMP_NUM_THREADS:-1}
+REF_THREADS=${REF_THREADS:-$(nproc)}
+INTEGRATORS="euler rk2 rk3"
+if [ $RECON == PPM ] || [ $RECON == WENO5 ]; then INTEGRATORS="rk2 rk3"; fi
+rm -rf $WORK
+mkdir -p $WORK
+
+# build <setup>: scratch tree without dust in $WORK/build_<setup>
+build(){
+    local dir=$WORK/build_$1
+    mkdir -p $dir/obj $dir/bin
+    cp -r $ROOT/src $ROOT/Makefile $dir/
+    sed -i "s|#include \"setup/[^\"]*\"|#include \"setup/$1.cpp\"|" $dir/src/main.cpp
+    for flag in ENABLE_DUSTFLUID ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_MPI ENABLE_FUSED_HYDRO; do
+        sed -i "s|^#define $flag\$|//#define $flag|" $dir/src/defs.hpp
+    done
+    make -C $dir -j ${BOOTES_CFLAGS:+CFLAGS="$BOOTES_CFLAGS"} > $dir/build.log 2>&1 || { tail -20 $dir/build.log; exit 1; }
+}
+
+# input <setup> <integrator> <nx>
+input(){
+    if [ $1 == shock_tube ]; then
+        cat <<EOF
+t_tot = 0.2001
+output_dt = 0.2
+dimension = 1
+x1min = 0
+x1max = 1
+nx1 = $3
+x2min = 0
+x2max = 1
+nx2 = 1
+EOF
+    else
+        cat <<EOF
+t_tot = 0.5001
+output_dt = 0.5
+dimension = 2
+x1min = -0.5
+x1max = 0.5
+nx1 = $3
+x2min = -1
+x2max = 1
+nx2 = $((2 * $3))
+kh_perturbation = sine
+bc_x1i = periodic
+bc_x1o = periodic
+bc_x2i = standard
+bc_x2o = standard
+EOF
+    fi
+    cat <<EOF
+CFL = 0.3
+foutput_root = ./out/
+foutput_pre  = ic
+foutput_aft  = boot
+output_fields = cons
+gamma_hydro = 1.4
+x3min = 0
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+reconstruction = $RECON
+integrator = $2
+EOF
+}
+
+# run <setup> <integrator> <nx>: prints the wall time, output in $WORK/run_<setup>_<integrator>_<nx>/out
+run(){
+    local dir=$WORK/run_$1_$2_$3
+    mkdir -p $dir/out
+    input $1 $2 $3 > $dir/input.txt
+    local start=$(date +%s.%N)
+    (cd $dir && $WORK/build_$1/bin/bootes.out -i input.txt > log.txt 2>&1) || { tail -20 $dir/log.txt; exit 1; }
+    awk -v a=$start -v b=$(date +%s.%N) 'BEGIN { print b - a }'
+}
+
+echo "problem      integrator     nx1    L1 error   order   wall [s]"
+for setup in shock_tube KH; do
+    build $setup
+    if [ $setup == shock_tube ]; then nxs=$NX_ST; ref=$REF_ST; else nxs=$NX_KH; ref=$REF_KH; fi
+    OMP_NUM_THREADS=$REF_THREADS run $setup rk3 $ref > /dev/null
+    for integrator in $INTEGRATORS; do
+        prev=""
+        for nx in $nxs; do
+            wall=$(run $setup $integrator $nx)
+            l1=$($ERROR $WORK/run_${setup}_${integrator}_$nx/out/ic.00001.boot $WORK/run_${setup}_rk3_$ref/out/ic.00001.boot)
+            order=$(awk -v a="$prev" -v b="$l1" 'BEGIN { if (a == "") print "-"; else printf "%.2f", log(a / b) / log(2) }')
+            printf "%-12s %-8s %9d   %s   %5s   %8.3f\n" $setup $integrator $nx $l1 $order $wall
+            prev=$l1
+        done
+    done
+done
@@ -0,0 +1,163 @@
+#!/bin/bash
+# Domain decomposition (ENABLE_MPI in src/defs.hpp) against a single-process run. shock_tube (1D), KH (2D and
+# 3D) and KH.dust (2D) are built once without MPI and once with ENABLE_MPI and CC=mpicxx in scratch copies of
+# the tree, the same input is run on 1 process and with "mpirun -np N" for several N, and every output frame
+# must be bit-identical (bin/precision_compare.out with tolerance 0). KH is also restarted on 4 ranks from a
+# single-process frame. Run from the repository root with "make mpi_check". MPIRUN overrides the launcher
+# (default "mpirun --oversubscribe"); BOOTES_CFLAGS, if set, replaces the Makefile CFLAGS. The scratch trees and
+# outputs are kept in $WORK (default /tmp/bootes_mpi).
+set -e
+
+ROOT=$(pwd)
+WORK=${WORK:-/tmp/bootes_mpi}
+COMPARE=$ROOT/bin/precision_compare.out
+MPIRUN=${MPIRUN:-mpirun --oversubscribe}
+export OMP_NUM_THREADS=${OMP_NUM_THREADS:-1}
+rm -rf $WORK
+mkdir -p $WORK
+
+# build <name> <setup> <compiler> <flags to enable> -- <flags to disable>
+build(){
+    local name=$1 setup=$2 compiler=$3
+    shift 3
+    local dir=$WORK/build_$name
+    mkdir -p $dir/obj $dir/bin
+    cp -r $ROOT/src $ROOT/Makefile $dir/
+    sed -i "s|#include \"setup/[^\"]*\"|#include \"setup/$setup.cpp\"|" $dir/src/main.cpp
+    local mode=on
+    for flag in "$@"; do
+        if [ "$flag" == "--" ]; then mode=off; continue; fi
+        if [ $mode == on ]; then
+            sed -i "s|^//#define $flag\$|#define $flag|" $dir/src/defs.hpp
+        else
+            sed -i "s|^#define $flag\$|//#define $flag|" $dir/src/defs.hpp
+        fi
+    done
+    make -C $dir -j CC=$compiler ${BOOTES_CFLAGS:+CFLAGS="$BOOTES_CFLAGS"} > $dir/build.log 2>&1 || { tail -20 $dir/build.log; exit 1; }
+}
+
+# run <build> <run name> <input> <launcher...> : output in $WORK/run_<run name>/out
+run(){
+    local build=$1 name=$2 input=$3
+    shift 3
+    local dir=$WORK/run_$name
+    mkdir -p $dir/out
+    cp $input $dir/input.txt
+    (cd $dir && "$@" $WORK/build_$build/bin/bootes.out -i input.txt > log.txt 2>&1) || { tail -20 $dir/log.txt; exit 1; }
+}
+
+# compare <reference run> <test run> <frame>
+compare(){
+    echo "== $2 $3"
+    $COMPARE $WORK/run_$1/out/$3 $WORK/run_$2/out/$3 -t 0 > $WORK/compare.log || { cat $WORK/compare.log; status=1; return; }
+    echo "bit-identical"
+}
+
+cat > $WORK/input.shock_tube <<EOF
+CFL = 0.3
+t_tot = 0.2001
+output_dt = 0.1
+foutput_root = ./out/
+foutput_pre  = st
+foutput_aft  = boot
+gamma_hydro = 1.4
+dimension = 1
+x1min = 0
+x1max = 1
+nx1 = 400
+x2min = 0
+x2max = 1
+nx2 = 1
+x3min = 0
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+EOF
+
+cat > $WORK/input.KH <<EOF
+CFL = 0.3
+t_tot = 1.001
+output_dt = 0.5
+foutput_root = ./out/
+foutput_pre  = kh
+foutput_aft  = boot
+gamma_hydro = 1.4
+dimension = 2
+x1min = -6
+x1max = 6
+nx1 = 96
+x2min = -4
+x2max = 4
+nx2 = 66
+x3min = -1
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+random_seed = 1
+bc_x1i = periodic
+bc_x1o = periodic
+bc_x2i = standard
+bc_x2o = standard
+EOF
+
+sed -e "s|dimension = 2|dimension = 3|; s|nx1 = 96|nx1 = 16|; s|nx2 = 66|nx2 = 16|; s|nx3 = 1|nx3 = 16|; s|t_tot = 1.001|t_tot = 0.201|; s|output_dt = 0.5|output_dt = 0.1|" \
+    $WORK/input.KH > $WORK/input.KH3D
+cat >> $WORK/input.KH3D <<EOF
+bc_x3i = periodic
+bc_x3o = periodic
+EOF
+
+sed -e "s|foutput_pre  = kh|foutput_pre  = khd|" $WORK/input.KH > $WORK/input.KH.dust
+cat >> $WORK/input.KH.dust <<EOF
+dust_bc_x1i = standard
+dust_bc_x1o = standard
+dust_bc_x2i = standard
+dust_bc_x2o = standard
+num_species = 3
+srho = 3e15
+smin = 6.684491978609625e-19
+smax = 6.684491978609625e-14
+ainimin = 6.684491978609625e-19
+ainimax = 6.684491978609625e-14
+dminDensity = 1e-20
+EOF
+
+NODUST="ENABLE_DUSTFLUID ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY"
+build st_serial   shock_tube g++     -- $NODUST ENABLE_MPI
+build st_mpi      shock_tube mpicxx  ENABLE_MPI -- $NODUST
+build kh_serial   KH         g++     -- $NODUST ENABLE_MPI
+build kh_mpi      KH         mpicxx  ENABLE_MPI -- $NODUST
+build khd_serial  KH.dust    g++     ENABLE_DUSTFLUID -- ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_MPI
+build khd_mpi     KH.dust    mpicxx  ENABLE_DUSTFLUID ENABLE_MPI -- ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY
+
+status=0
+run st_serial st_serial $WORK/input.shock_tube
+for np in 1 3; do
+    run st_mpi st_np$np $WORK/input.shock_tube $MPIRUN -np $np
+    compare st_serial st_np$np st.00002.boot
+done
+
+run kh_serial kh_serial $WORK/input.KH
+for np in 2 3 4 6; do
+    run kh_mpi kh_np$np $WORK/input.KH $MPIRUN -np $np
+    compare kh_serial kh_np$np kh.00002.boot
+done
+# restart on 4 ranks from the single-process frame at t = 0.5
+mkdir -p $WORK/run_kh_restart/out
+(cd $WORK/run_kh_restart && $MPIRUN -np 4 $WORK/build_kh_mpi/bin/bootes.out -r $WORK/run_kh_serial/out/kh.00001.boot > log.txt 2>&1) || { tail -20 $WORK/run_kh_restart/log.txt; exit 1; }
+compare kh_serial kh_restart kh.00002.boot
+
+run kh_serial kh3d_serial $WORK/input.KH3D
+run kh_mpi kh3d_np8 $WORK/input.KH3D $MPIRUN -np 8
+compare kh3d_serial kh3d_np8 kh.00002.boot
+
+run khd_serial khd_serial $WORK/input.KH.dust
+run khd_mpi khd_np6 $WORK/input.KH.dust $MPIRUN -np 6
+compare khd_serial khd_np6 khd.00002.boot
+exit $status
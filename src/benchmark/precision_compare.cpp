@@ -0,0 +1,98 @@
+/**
+ * Difference between two output frames of the same run, e.g. a float-storage build (ENABLE_FLOAT_STATE or
+ * ENABLE_FLOAT_DUST_PRIM) against the double build. For every requested field and every variable it
+ * reports the relative L1 error sum|a - b| / sum|a| and the relative max error max|a - b| / max|a|,
+ * ghost zones included. Used by src/benchmark/precision_regression.sh ("make precision_check").
+ *
+ *   precision_compare.out <reference frame> <test frame> [-t tol] [field ...]
+ *
+ * Fields default to cons prim dcons dprim (missing ones are skipped). With -t, the exit status is 1 if
+ * any relative L1 error exceeds tol.
+ **/
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <H5Cpp.h>
+
+using namespace std;
+using namespace H5;
+
+
+// all values of a dataset as double, and its shape
+static vector<double> read_dataset(H5File &file, string name, vector<hsize_t> &dims){
+    DataSet dataset = file.openDataSet(name);
+    DataSpace space = dataset.getSpace();
+    dims.resize(space.getSimpleExtentNdims());
+    space.getSimpleExtentDims(dims.data(), NULL);
+    vector<double> values(space.getSimpleExtentNpoints());
+    dataset.read(values.data(), PredType::NATIVE_DOUBLE);
+    return values;
+}
+
+
+int main(int argc, char *argv[]){
+    if (argc < 3){
+        cout << "usage: " << argv[0] << " <reference frame> <test frame> [-t tol] [field ...]" << endl;
+        return 2;
+    }
+    H5File reference(argv[1], H5F_ACC_RDONLY);
+    H5File test(argv[2], H5F_ACC_RDONLY);
+    double tol = -1;
+    vector<string> fields;
+    for (int ii = 3; ii < argc; ii++){
+        if (string(argv[ii]) == "-t" && ii + 1 < argc){
+            tol = atof(argv[++ii]);
+        }
+        else {
+            fields.push_back(argv[ii]);
+        }
+    }
+    if (fields.empty()){
+        fields = {"cons", "prim", "dcons", "dprim"};
+    }
+
+    bool failed = false;
+    cout << left << setw(8) << "field" << setw(5) << "var" << right << setw(14) << "L1 rel" << setw(14) << "max rel" << endl;
+    for (auto &field : fields){
+        if (!reference.nameExists(field) || !test.nameExists(field)){
+            continue;
+        }
+        vector<hsize_t> dims, test_dims;
+        vector<double> a = read_dataset(reference, field, dims);
+        vector<double> b = read_dataset(test, field, test_dims);
+        if (dims != test_dims || dims.size() < 4){
+            cout << field << ": shapes differ or not a state array" << endl;
+            failed = true;
+            continue;
+        }
+        // the variable axis is the 4th from the end: (var, z, y, x) or (species, var, z, y, x)
+        int varaxis = dims.size() - 4;
+        size_t inner = dims[dims.size() - 1] * dims[dims.size() - 2] * dims[dims.size() - 3];
+        size_t nvar = dims[varaxis];
+        size_t nouter = a.size() / (inner * nvar);
+        for (size_t var = 0; var < nvar; var++){
+            double sum_diff = 0, sum_ref = 0, max_diff = 0, max_ref = 0;
+            for (size_t outer = 0; outer < nouter; outer++){
+                size_t offset = (outer * nvar + var) * inner;
+                for (size_t cell = 0; cell < inner; cell++){
+                    double diff = abs(a[offset + cell] - b[offset + cell]);
+                    sum_diff += diff;
+                    sum_ref  += abs(a[offset + cell]);
+                    max_diff = max(max_diff, diff);
+                    max_ref  = max(max_ref, abs(a[offset + cell]));
+                }
+            }
+            double l1   = (sum_ref > 0) ? sum_diff / sum_ref : sum_diff;
+            double linf = (max_ref > 0) ? max_diff / max_ref : max_diff;
+            cout << left << setw(8) << field << setw(5) << var << right << scientific << setprecision(3)
+                 << setw(14) << l1 << setw(14) << linf << endl;
+            if (tol >= 0 && !(l1 <= tol)){
+                failed = true;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+#!/bin/bash
+# Accuracy of the float storage options (STORAGE PRECISION in src/defs.hpp) against full double precision.
+# For each of shock_tube, KH and KH.dust the code is built twice in a scratch copy of the tree, once in
+# double and once with ENABLE_FLOAT_STATE (KH.dust also with ENABLE_FLOAT_DUST_PRIM alone), the same input
+# is run with both, and bin/precision_compare.out reports the relative L1 and max errors of the frame at
+# t = output_dt. Run from the repository root with "make precision_check". If BOOTES_CFLAGS is set it
+# replaces the Makefile CFLAGS (e.g. to add the HDF5 include and library paths). The scratch trees and
+# outputs are kept in $WORK (default /tmp/bootes_precision).
+set -e
+
+ROOT=$(pwd)
+WORK=${WORK:-/tmp/bootes_precision}
+COMPARE=$ROOT/bin/precision_compare.out
+TOL=${TOL:-1e-3}                        # fail if any relative L1 error is larger
+rm -rf $WORK
+mkdir -p $WORK
+
+# build <name> <setup> <flags to enable> -- <flags to disable>
+build(){
+    local name=$1 setup=$2
+    shift 2
+    local dir=$WORK/build_$name
+    mkdir -p $dir/obj $dir/bin
+    cp -r $ROOT/src $ROOT/Makefile $dir/
+    sed -i "s|#include \"setup/[^\"]*\"|#include \"setup/$setup.cpp\"|" $dir/src/main.cpp
+    local mode=on
+    for flag in "$@"; do
+        if [ "$flag" == "--" ]; then mode=off; continue; fi
+        if [ $mode == on ]; then
+            sed -i "s|^//#define $flag\$|#define $flag|" $dir/src/defs.hpp
+        else
+            sed -i "s|^#define $flag\$|//#define $flag|" $dir/src/defs.hpp
+        fi
+    done
+    make -C $dir -j ${BOOTES_CFLAGS:+CFLAGS="$BOOTES_CFLAGS"} > $dir/build.log 2>&1 || { tail -20 $dir/build.log; exit 1; }
+}
+
+# run <name> <input> : output in $WORK/run_<name>/out
+run(){
+    local dir=$WORK/run_$1
+    mkdir -p $dir/out
+    cp $2 $dir/input.txt
+    (cd $dir && $WORK/build_$1/bin/bootes.out -i input.txt > log.txt 2>&1) || { tail -20 $dir/log.txt; exit 1; }
+}
+
+compare(){
+    echo "== $3"
+    $COMPARE $WORK/run_$1/out/$4 $WORK/run_$2/out/$4 -t $TOL || status=1
+}
+
+cat > $WORK/input.shock_tube <<EOF
+CFL = 0.3
+t_tot = 0.2001
+output_dt = 0.2
+foutput_root = ./out/
+foutput_pre  = st
+foutput_aft  = boot
+gamma_hydro = 1.4
+dimension = 1
+x1min = 0
+x1max = 1
+nx1 = 400
+x2min = 0
+x2max = 1
+nx2 = 1
+x3min = 0
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+EOF
+
+cat > $WORK/input.KH <<EOF
+CFL = 0.3
+t_tot = 1.001
+output_dt = 1
+foutput_root = ./out/
+foutput_pre  = kh
+foutput_aft  = boot
+gamma_hydro = 1.4
+dimension = 2
+x1min = -6
+x1max = 6
+nx1 = 192
+x2min = -4
+x2max = 4
+nx2 = 128
+x3min = -1
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+random_seed = 1
+bc_x1i = periodic
+bc_x1o = periodic
+bc_x2i = standard
+bc_x2o = standard
+EOF
+
+cat $WORK/input.KH > $WORK/input.KH.dust
+sed -i "s|foutput_pre  = kh|foutput_pre  = khd|" $WORK/input.KH.dust
+cat >> $WORK/input.KH.dust <<EOF
+dust_bc_x1i = standard
+dust_bc_x1o = standard
+dust_bc_x2i = standard
+dust_bc_x2o = standard
+num_species = 5
+srho = 3e15
+smin = 6.684491978609625e-19
+smax = 6.684491978609625e-14
+ainimin = 6.684491978609625e-19
+ainimax = 6.684491978609625e-14
+dminDensity = 1e-48
+EOF
+
+NODUST="ENABLE_DUSTFLUID ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY"
+build st_double   shock_tube                        -- $NODUST ENABLE_FLOAT_STATE ENABLE_FLOAT_DUST_PRIM
+build st_float    shock_tube ENABLE_FLOAT_STATE     -- $NODUST ENABLE_FLOAT_DUST_PRIM
+build kh_double   KH                                -- $NODUST ENABLE_FLOAT_STATE ENABLE_FLOAT_DUST_PRIM
+build kh_float    KH         ENABLE_FLOAT_STATE     -- $NODUST ENABLE_FLOAT_DUST_PRIM
+build khd_double  KH.dust    ENABLE_DUSTFLUID       -- ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_FLOAT_STATE ENABLE_FLOAT_DUST_PRIM
+build khd_float   KH.dust    ENABLE_DUSTFLUID ENABLE_FLOAT_STATE     -- ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_FLOAT_DUST_PRIM
+build khd_dprim   KH.dust    ENABLE_DUSTFLUID ENABLE_FLOAT_DUST_PRIM -- ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_FLOAT_STATE
+
+for name in st_double st_float; do run $name $WORK/input.shock_tube; done
+for name in kh_double kh_float; do run $name $WORK/input.KH; done
+for name in khd_double khd_float khd_dprim; do run $name $WORK/input.KH.dust; done
+
+status=0
+compare st_double  st_float  "shock_tube, ENABLE_FLOAT_STATE"   st.00001.boot
+compare kh_double  kh_float  "KH, ENABLE_FLOAT_STATE"           kh.00001.boot
+compare khd_double khd_float "KH.dust, ENABLE_FLOAT_STATE"      khd.00001.boot
+compare khd_double khd_dprim "KH.dust, ENABLE_FLOAT_DUST_PRIM"  khd.00001.boot
+exit $status
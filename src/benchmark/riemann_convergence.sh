@@ -0,0 +1,114 @@
+#!/bin/bash
+# Error against CPU time of the Riemann solvers (riemann_solver = hll, hlle, hllc or roe in the input file) on KH
+# with kh_perturbation = sine (2D, smooth shear layers, t = 0.5), where the diffusion of the contact and shear
+# waves sets the error. The problem is built once without dust in a scratch copy of the tree and run with every
+# solver at several resolutions, and once with hllc and rk3 at a resolution that is a multiple of all of them as
+# the reference. bin/integrator_convergence.out gives the L1 density error against the reference averaged onto
+# the coarse grid. The last column is the effective resolution: the nx1 hlle would need for the same error,
+# interpolated (or extrapolated) in log-log between the hlle runs. The cost per interface of the solvers alone
+# is reported by "make riemann_bench". Run from the repository root with "make riemann_convergence".
+# RECON sets the reconstruction (default minmod) and INTEGRATOR the time integrator (default euler, rk3 for PPM
+# and WENO5); BOOTES_CFLAGS, if set, replaces the Makefile CFLAGS; NX_KH overrides the resolutions and REF_KH
+# the reference resolution. The runs use OMP_NUM_THREADS (default 1), the reference REF_THREADS (default all
+# cores). The scratch tree and outputs are kept in $WORK (default /tmp/bootes_riemann_convergence).
+set -e
+
+ROOT=$(pwd)
+WORK=${WORK:-/tmp/bootes_riemann_convergence}
+ERROR=$ROOT/bin/integrator_convergence.out
+RECON=${RECON:-minmod}
+INTEGRATOR=${INTEGRATOR:-euler}
+if [ $RECON == PPM ] || [ $RECON == WENO5 ]; then INTEGRATOR=rk3; fi
+NX_KH=${NX_KH:-32 64 128}
+REF_KH=${REF_KH:-512}
+RIEMANNS="hll hlle hllc roe"
+export OMP_NUM_THREADS=${OMP_NUM_THREADS:-1}
+REF_THREADS=${REF_THREADS:-$(nproc)}
+rm -rf $WORK
+mkdir -p $WORK
+
+# build: scratch tree of KH without dust in $WORK/build
+build(){
+    local dir=$WORK/build
+    mkdir -p $dir/obj $dir/bin
+    cp -r $ROOT/src $ROOT/Makefile $dir/
+    sed -i "s|#include \"setup/[^\"]*\"|#include \"setup/KH.cpp\"|" $dir/src/main.cpp
+    for flag in ENABLE_DUSTFLUID ENABLE_DUST_GRAINGROWTH ENABLE_GRAVITY ENABLE_MPI ENABLE_FUSED_HYDRO; do
+        sed -i "s|^#define $flag\$|//#define $flag|" $dir/src/defs.hpp
+    done
+    make -C $dir -j ${BOOTES_CFLAGS:+CFLAGS="$BOOTES_CFLAGS"} > $dir/build.log 2>&1 || { tail -20 $dir/build.log; exit 1; }
+}
+
+# input <riemann> <integrator> <nx>
+input(){
+    cat <<EOF
+t_tot = 0.5001
+output_dt = 0.5
+dimension = 2
+x1min = -0.5
+x1max = 0.5
+nx1 = $3
+x2min = -1
+x2max = 1
+nx2 = $((2 * $3))
+kh_perturbation = sine
+bc_x1i = periodic
+bc_x1o = periodic
+bc_x2i = standard
+bc_x2o = standard
+CFL = 0.3
+foutput_root = ./out/
+foutput_pre  = kh
+foutput_aft  = boot
+output_fields = cons
+gamma_hydro = 1.4
+x3min = 0
+x3max = 1
+nx3 = 1
+length_scale = 1
+time_scale = 1
+mass_scale = 1
+mindensity = 1e-8
+reconstruction = $RECON
+riemann_solver = $1
+integrator = $2
+EOF
+}
+
+# run <riemann> <integrator> <nx>: prints the wall time, output in $WORK/run_<riemann>_<integrator>_<nx>/out
+run(){
+    local dir=$WORK/run_$1_$2_$3
+    mkdir -p $dir/out
+    input $1 $2 $3 > $dir/input.txt
+    local start=$(date +%s.%N)
+    (cd $dir && $WORK/build/bin/bootes.out -i input.txt > log.txt 2>&1) || { tail -20 $dir/log.txt; exit 1; }
+    awk -v a=$start -v b=$(date +%s.%N) 'BEGIN { print b - a }'
+}
+
+build
+OMP_NUM_THREADS=$REF_THREADS run hllc rk3 $REF_KH > /dev/null
+REF=$WORK/run_hllc_rk3_$REF_KH/out/kh.00001.boot
+# errors first, so that every solver can be compared with all the hlle runs
+for riemann in $RIEMANNS; do
+    for nx in $NX_KH; do
+        wall=$(run $riemann $INTEGRATOR $nx)
+        echo "$riemann $nx $($ERROR $WORK/run_${riemann}_${INTEGRATOR}_$nx/out/kh.00001.boot $REF) $wall" >> $WORK/errors.txt
+    done
+done
+
+echo "KH, reconstruction = $RECON, integrator = $INTEGRATOR, reference hllc rk3 nx1 = $REF_KH"
+echo "riemann     nx1    L1 error   order   wall [s]   hlle nx1 for the same error"
+awk '
+    { solver[NR] = $1; nx[NR] = $2; err[NR] = $3; wall[NR] = $4
+      if ($1 == "hlle"){ nh++; hnx[nh] = $2; herr[nh] = $3 } }
+    END {
+        for (ii = 1; ii <= NR; ii++){
+            # hlle segment bracketing the error, or the nearest end segment
+            kk = 1
+            while (kk < nh - 1 && err[ii] < herr[kk + 1]) kk++
+            slope = log(hnx[kk + 1] / hnx[kk]) / log(herr[kk + 1] / herr[kk])
+            eff = hnx[kk] * exp(slope * log(err[ii] / herr[kk]))
+            order = (ii > 1 && solver[ii - 1] == solver[ii]) ? sprintf("%.2f", log(err[ii - 1] / err[ii]) / log(nx[ii] / nx[ii - 1])) : "-"
+            printf "%-8s %6d   %s   %5s   %8.3f   %8.0f\n", solver[ii], nx[ii], err[ii], order, wall[ii], eff
+        }
+    }' $WORK/errors.txt
@@ -0,0 +1,137 @@
+/**
+ * Throughput of the Riemann solvers, single-face call vs the batched structure-of-arrays call, and the batched
+ * call from primitive states (reconstruction_variables = primitive or characteristic).
+ * Build and run with "make riemann_bench"; reports interfaces per second on one core, the cost per interface
+ * of the batched calls, and checks that the single-face and batched paths give bit-identical fluxes.
+ * The resolution each solver gains on KH is measured by src/benchmark/riemann_convergence.sh.
+ **/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <algorithm>
+
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/index_def.hpp"
+#include "../algorithm/hydro/hll.hpp"
+#include "../algorithm/hydro/hlle.hpp"
+#include "../algorithm/hydro/hllc.hpp"
+#include "../algorithm/hydro/roe.hpp"
+
+using namespace std;
+
+typedef void (*riemann_single)(double *, double *, double *, int, double &);
+typedef void (*riemann_batch)(int, double * const *, double * const *, double * const *, int, double);
+
+static double wtime(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// all faces through the single-face solver, states gathered from the same SoA arrays
+static void run_single(riemann_single solver, int nface, double **L, double **R, double **F, int IMP, double &gamma){
+    for (int ff = 0; ff < nface; ff ++){
+        double valL[5], valR[5], fxs[5];
+        for (int var = 0; var < NUMCONS; var++){
+            valL[var] = L[var][ff];
+            valR[var] = R[var][ff];
+        }
+        solver(valL, valR, fxs, IMP, gamma);
+        for (int var = 0; var < NUMCONS; var++){
+            F[var][ff] = fxs[var];
+        }
+    }
+}
+
+
+int main(int argc, char *argv[]){
+    int nface = 1024;               // one row of faces; small enough to stay in L1/L2
+    int reps = 4000;
+    double gamma = 1.4;
+
+    BootesArray<double> valsL, valsR, primL, primR, flux, flux_ref;
+    valsL.NewBootesArray(NUMCONS, nface);
+    valsR.NewBootesArray(NUMCONS, nface);
+    primL.NewBootesArray(NUMPRIM, nface);
+    primR.NewBootesArray(NUMPRIM, nface);
+    flux.NewBootesArray(NUMCONS, nface);
+    flux_ref.NewBootesArray(NUMCONS, nface);
+
+    // random states with a pressure jump every few faces, so that all wave patterns show up
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> uni(-1., 1.);
+    for (int ff = 0; ff < nface; ff ++){
+        double rhoL = 1. + 0.9 * uni(rng), rhoR = 1. + 0.9 * uni(rng);
+        double vL[3] = {2. * uni(rng), uni(rng), uni(rng)};
+        double vR[3] = {2. * uni(rng), uni(rng), uni(rng)};
+        double pL = 1. + 0.9 * uni(rng);
+        double pR = (ff % 7 == 0) ? 50. * (1. + uni(rng)) : 1. + 0.9 * uni(rng);
+        valsL(IDN, ff) = primL(IDN, ff) = rhoL;
+        valsR(IDN, ff) = primR(IDN, ff) = rhoR;
+        for (int dd = 0; dd < 3; dd++){
+            valsL(IM1 + dd, ff) = rhoL * vL[dd];
+            valsR(IM1 + dd, ff) = rhoR * vR[dd];
+            primL(IV1 + dd, ff) = vL[dd];
+            primR(IV1 + dd, ff) = vR[dd];
+        }
+        primL(IPN, ff) = pL;
+        primR(IPN, ff) = pR;
+        valsL(IEN, ff) = pL / (gamma - 1.) + 0.5 * rhoL * (vL[0] * vL[0] + vL[1] * vL[1] + vL[2] * vL[2]);
+        valsR(IEN, ff) = pR / (gamma - 1.) + 0.5 * rhoR * (vR[0] * vR[0] + vR[1] * vR[1] + vR[2] * vR[2]);
+    }
+    double *L[NUMCONS], *R[NUMCONS], *PL[NUMPRIM], *PR[NUMPRIM], *F[NUMCONS], *Fref[NUMCONS];
+    for (int var = 0; var < NUMCONS; var++){
+        L[var] = &valsL(var, 0);
+        R[var] = &valsR(var, 0);
+        PL[var] = &primL(var, 0);
+        PR[var] = &primR(var, 0);
+        F[var] = &flux(var, 0);
+        Fref[var] = &flux_ref(var, 0);
+    }
+
+    const char *names[4] = {"hll", "hlle", "hllc", "roe"};
+    riemann_single single[4] = {hll, hlle, hllc, roe};
+    riemann_batch batch[4] = {hll_batch, hlle_batch, hllc_batch, roe_batch};
+    riemann_batch prim_batch[4] = {hll_prim_batch, hlle_prim_batch, hllc_prim_batch, roe_prim_batch};
+    int fail = 0;
+    cout << setw(6) << "solver" << setw(16) << "single [M/s]" << setw(16) << "batched [M/s]" << setw(10) << "speedup"
+         << setw(20) << "batched [ns/face]" << setw(22) << "prim batched [M/s]" << setw(25) << "prim batched [ns/face]" << endl;
+    for (int ss = 0; ss < 4; ss++){
+        // check all three directions
+        for (int IMP = IM1; IMP <= IM3; IMP++){
+            run_single(single[ss], nface, L, R, Fref, IMP, gamma);
+            batch[ss](nface, L, R, F, IMP, gamma);
+            if (memcmp(flux.get_arr(), flux_ref.get_arr(), sizeof(double) * NUMCONS * nface) != 0){
+                cout << names[ss] << ": batched fluxes differ from single-face fluxes, IMP = " << IMP << endl;
+                fail = 1;
+            }
+        }
+        // best of three
+        double t_single = 1e30, t_batch = 1e30, t_prim = 1e30;
+        for (int trial = 0; trial < 3; trial++){
+            double t0 = wtime();
+            for (int rr = 0; rr < reps; rr++){
+                run_single(single[ss], nface, L, R, Fref, IM1, gamma);
+            }
+            t_single = min(t_single, wtime() - t0);
+            t0 = wtime();
+            for (int rr = 0; rr < reps; rr++){
+                batch[ss](nface, L, R, F, IM1, gamma);
+            }
+            t_batch = min(t_batch, wtime() - t0);
+            t0 = wtime();
+            for (int rr = 0; rr < reps; rr++){
+                prim_batch[ss](nface, PL, PR, F, IM1, gamma);
+            }
+            t_prim = min(t_prim, wtime() - t0);
+        }
+        double nsolve = (double) reps * nface * 1e-6;
+        cout << setw(6) << names[ss] << fixed << setprecision(1)
+             << setw(16) << nsolve / t_single << setw(16) << nsolve / t_batch
+             << setprecision(2) << setw(9) << t_single / t_batch << "x"
+             << setw(20) << 1e3 * t_batch / nsolve << fixed << setprecision(1) << setw(22) << nsolve / t_prim
+             << setprecision(2) << setw(25) << 1e3 * t_prim / nsolve << endl;
+    }
+    return fail;
+}
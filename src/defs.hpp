@@ -3,6 +3,10 @@
 #define CARTESIAN_COORD
 //#define SPHERICAL_POLAR_COORD
 
+/** HYDRO **/
+// reconstruct + Riemann + flux divergence in one cache-blocked sweep (minmod/hlle, Cartesian only)
+//#define ENABLE_FUSED_HYDRO
+
 /** PROTECTION **/
 #define DENSITY_PROTECTION
 #define ENABLE_TEMPERATURE_PROTECTION
@@ -13,6 +17,18 @@
 /** DUST **/
 #define ENABLE_DUSTFLUID
 #define ENABLE_DUST_GRAINGROWTH
+// store dcons and dprim cell-major (z, y, x, species, var) instead of (species, var, z, y, x); see dust/dust_array.hpp
+//#define ENABLE_DUST_CELL_MAJOR
+
+/** STORAGE PRECISION **/
+// store cons, prim, dcons and dprim in float; reconstruction, fluxes and updates are still done in double
+//#define ENABLE_FLOAT_STATE
+// store only dprim in float
+//#define ENABLE_FLOAT_DUST_PRIM
+
+/** MPI **/
+// Cartesian domain decomposition over MPI ranks; build with "make CC=mpicxx", run with "mpirun -np N bootes.out ..."
+//#define ENABLE_MPI
 
 /** DEBUG **/
 //#define DEBUG
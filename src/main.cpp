@@ -5,6 +5,8 @@
 #include "algorithm/timeadvance/timeintegration.hpp"
 #include "algorithm/hydro/donercell.hpp"
 #include "algorithm/inoutput/output.hpp"
+#include "algorithm/inoutput/async_output.hpp"
+#include "algorithm/inoutput/output_options.hpp"
 #include "algorithm/inoutput/input.hpp"
 #include "algorithm/index_def.hpp"
 #include "algorithm/boundary_condition/apply_bc.hpp"
@@ -22,30 +24,59 @@
 #ifdef ENABLE_DUSTFLUID
     #include "algorithm/eos/eos_dust.hpp"
     #include "algorithm/boundary_condition/dust/apply_bc_dust.hpp"
+    #include "algorithm/dust/dust_floor.hpp"
 #endif // ENABLE_DUSTFLUID
 
 #ifdef DEBUG
     #include "algorithm/util/checkok.hpp"
 #endif // DEBUG
 
+#ifdef ENABLE_MPI
+    #include <mpi.h>
+    #include "algorithm/mpi/halo_exchange.hpp"
+#endif // ENABLE_MPI
+
 #include "setup/shearboxdisk.cpp"
 
+/** prim, dprim and the ghost zones from cons and dcons; after every step and between the stages of the
+ *  Runge-Kutta integrators (time_integrate) **/
+void update_prim_and_ghosts(mesh &m){
+    /** step 3: use E.O.S. and relations to get primitive variables. **/
+    cons_to_prim(m);
+    #ifdef ENABLE_DUSTFLUID
+    cons_to_prim_dust(m);
+    #endif // ENABLE_DUSTFLUID
+
+    /** step 4: apply boundary conditions **/
+    apply_boundary_condition(m);
+    #ifdef ENABLE_DUSTFLUID
+    apply_boundary_condition_dust(m);
+    #endif
+    apply_user_extra_boundary_condition(m);
+}
+
+
 void doloop(double &ot, double &next_exit_loop_time, mesh &m, double &CFL){
     int loop_cycle = 0;
     while (ot < next_exit_loop_time){
+        #ifdef ENABLE_DUSTFLUID
+        find_floor_species(m);      // species at the floor sit out this step (dust_floor_skip)
+        #endif // ENABLE_DUSTFLUID
         double dt = timestep(m, CFL);
         dt = min(dt, next_exit_loop_time - ot);
         if (dt < 0){
             cout << "dt < 0!" << endl << flush;
             throw std::invalid_argument("dt < 0");
         }
-        cout << "\t integrate cycle: " << loop_cycle << "\t time: " << ot << "\t dt: " << dt << endl << flush;
+        if (m.decomp.is_root()){
+            cout << "\t integrate cycle: " << loop_cycle << "\t time: " << ot << "\t dt: " << dt << endl << flush;
+        }
         // step before 1: calculate variables necessary for hydro
         #ifdef ENABLE_VISCOSITY
             calculate_nu_vis(m);
         #endif // ENABLE_VISCOSITY
         // step 1: evolve the hydro by dt
-        first_order(m, dt);
+        time_integrate(m, dt, update_prim_and_ghosts);
         // step 2: update other fields
         // step 2.1: calculate source terms
         // step 2.1.1: gravity
@@ -57,18 +88,8 @@ void doloop(double &ot, double &next_exit_loop_time, mesh &m, double &CFL){
         /** step 5: work after loop **/
         work_after_loop(m, dt);
 
-        /** step 3: use E.O.S. and relations to get primitive variables. **/
-        cons_to_prim(m);
-        #ifdef ENABLE_DUSTFLUID
-        cons_to_prim_dust(m);
-        #endif // ENABLE_DUSTFLUID
-
-        /** step 4: apply boundary conditions **/
-        apply_boundary_condition(m);
-        #ifdef ENABLE_DUSTFLUID
-        apply_boundary_condition_dust(m);
-        #endif
-        apply_user_extra_boundary_condition(m);
+        /** step 3 and 4: primitive variables and boundary conditions **/
+        update_prim_and_ghosts(m);
 
 
         #ifdef DEBUG
@@ -87,10 +108,13 @@ void doloop(double &ot, double &next_exit_loop_time, mesh &m, double &CFL){
 }
 
 
-int main(int argc, char *argv[]){
-    /** start timer **/
-    auto start = std::chrono::steady_clock::now();
-
+/** Fill an output frame. fields: which of prim, cons, dprim, dcons and grav go into it; frame and
+ *  next_output_time are the index and time of the next analysis frame (this one, for analysis frames),
+ *  so that a restart from any frame continues the output sequence. **/
+void fill_output_frame(OutputFrame &output, mesh &m, set<string> &fields, OutputOptions &output_options,
+                       double &ot, double &t_tot, double &CFL, double &output_dt,
+                       int &frame, double &next_output_time, int &restart_frame, int &cycle,
+                       string &foutput_root, string &foutput_pre, string &foutput_aft){
     /** >>> these lines exist for output use only **/
     const int outputIDN = static_cast<int>(IDN);
     const int outputIM1 = static_cast<int>(IM1);
@@ -104,6 +128,208 @@ int main(int argc, char *argv[]){
     const int outputIPN = static_cast<int>(IPN);
     /** << end for output only << **/
 
+    output.writeattribute<double>(&m.pconst.mass_scale,   "mass_scale", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.pconst.length_scale, "length_scale", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.pconst.time_scale,   "time_scale", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&ot, "time", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&t_tot, "tot_time", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&t_tot, "t_tot", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&CFL, "CFL", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&output_dt, "output_dt", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<int>(&frame, "frame", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<double>(&next_output_time, "next_output_time", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<int>(&restart_frame, "restart_frame", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&cycle, "main_cycle", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.dim, "dim", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.nx1, "nx1", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.nx2, "nx2", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.nx3, "nx3", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.ng1, "ng1", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.ng2, "ng2", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.ng3, "ng3", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x1s, "x1s", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x1l, "x1l", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x2s, "x2s", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x2l, "x2l", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x3s, "x3s", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<int>(&m.x3l, "x3l", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<double>(&m.maxx1, "x1max", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.minx1, "x1min", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.maxx2, "x2max", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.minx2, "x2min", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.maxx3, "x3max", H5::PredType::NATIVE_DOUBLE, 1);
+    output.writeattribute<double>(&m.minx3, "x3min", H5::PredType::NATIVE_DOUBLE, 1);
+    #ifdef SPHERICAL_POLAR_COORD
+    output.writeattribute<double>(&m.ratio_dim1, "ratio1", H5::PredType::NATIVE_DOUBLE, 1);
+    #endif
+    output.writeattribute<const int>(&outputIDN, "rhoIND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIM1, "mo1IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIM2, "mo2IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIM3, "mo3IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIEN, "eneIND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIDP, "denIND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIV1, "ve1IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIV2, "ve2IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIV3, "ve3IND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<const int>(&outputIPN, "prsIND", H5::PredType::NATIVE_INT32, 1);
+    output.writeattribute<double>(&m.hydro_gamma, "hydro_gamma", H5::PredType::NATIVE_DOUBLE, 1);
+    #ifdef DENSITY_PROTECTION
+    output.writeattribute<double>(&m.minDensity, "mindensity", H5::PredType::NATIVE_DOUBLE, 1);
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    output.writeattribute<double>(&m.minTemp, "mintemp", H5::PredType::NATIVE_DOUBLE, 1);
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    output.writeStringdataset(foutput_root, "foutput_root");
+    output.writeStringdataset(foutput_pre, "foutput_pre");
+    output.writeStringdataset(foutput_aft, "foutput_aft");
+    map<string, string> module_names = m.modules.names();
+    for (auto &module_name : module_names){
+        output.writeStringdataset(module_name.second, module_name.first);
+    }
+    map<string, string> output_option_names = output_options.names();
+    for (auto &option_name : output_option_names){
+        output.writeStringdataset(option_name.second, option_name.first);
+    }
+    //output.writeattribute<string>(&foutput_pre, "foutput_pre", H5::PredType::NATIVE_SCHAR, 1);
+    //output.writeattribute<string>(&foutput_aft, "foutput_aft", H5::PredType::NATIVE_SCHAR, 1);
+    output.write1Ddataset(m.x1v,  "x1v",  H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.x2v,  "x2v",  H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.x3v,  "x3v",  H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.x1f,  "x1f",  H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.x2f,  "x2f",  H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.x3f,  "x3f",  H5::PredType::NATIVE_DOUBLE);
+    #if defined(CARTESIAN_COORD)
+    // dxip(kk, jj, ii) only depends on the index along axis i, store the 1D arrays
+    output.write1Ddataset(m.dx1,  "dx1p", H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.dx2,  "dx2p", H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.dx3,  "dx3p", H5::PredType::NATIVE_DOUBLE);
+    #else
+    output.write3Ddataset(m.dx1p, "dx1p", H5::PredType::NATIVE_DOUBLE);
+    output.write3Ddataset(m.dx2p, "dx2p", H5::PredType::NATIVE_DOUBLE);
+    output.write3Ddataset(m.dx3p, "dx3p", H5::PredType::NATIVE_DOUBLE);
+    #endif // defined(CARTESIAN_COORD)
+    if (fields.count("prim")){
+        output.write4Ddataset(m.prim, "prim", H5::PredType::NATIVE_DOUBLE);
+    }
+    if (fields.count("cons")){
+        output.write4Ddataset(m.cons, "cons", H5::PredType::NATIVE_DOUBLE);
+    }
+    #if defined(ENABLE_GRAVITY)
+    if (fields.count("grav")){
+        output.write3Ddataset(m.grav->Phi_grav, "Phi", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->Phi_grav_x1surface, "Phi_x1s", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->Phi_grav_x2surface, "Phi_x2s", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->Phi_grav_x3surface, "Phi_x3s", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->grav_x1, "grav_x1", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->grav_x2, "grav_x2", H5::PredType::NATIVE_DOUBLE);
+        output.write3Ddataset(m.grav->grav_x3, "grav_x3", H5::PredType::NATIVE_DOUBLE);
+    }
+    #endif
+    #if defined(ENABLE_DUSTFLUID)
+    output.write1Ddataset(m.GrainSizeList, "grain_size_list", H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.GrainEdgeList, "grain_edge_list", H5::PredType::NATIVE_DOUBLE);
+    output.write1Ddataset(m.GrainMassList, "grain_mass_list", H5::PredType::NATIVE_DOUBLE);
+    if (fields.count("dcons")){
+        output.write5Ddataset(m.dcons.canonical(), "dcons", H5::PredType::NATIVE_DOUBLE);
+    }
+    if (fields.count("dprim")){
+        output.write5Ddataset(m.dprim.canonical(), "dprim", H5::PredType::NATIVE_DOUBLE);
+    }
+    #ifdef ENABLE_DUST_GRAINGROWTH
+    if (fields.count("coag") && m.coag_substeps.checkallocated()){
+        output.write3Ddataset(m.coag_substeps, "coag_substeps", H5::PredType::NATIVE_DOUBLE);
+    }
+    #endif // ENABLE_DUST_GRAINGROWTH
+    #endif
+    if (m.UserScalers.checkallocated()){
+        output.write1Ddataset(m.UserScalers, "UserScalers", H5::PredType::NATIVE_DOUBLE);
+    }
+}
+
+
+#ifdef ENABLE_MPI
+/** The output files hold the whole domain. Rank 0 keeps mout, a mesh over the whole domain without scratch
+ *  buffers, and the blocks of all ranks are gathered into it before a frame is filled. **/
+void setup_output_mesh(mesh &m, mesh &mout){
+    mout.pconst.setup_physical_constants(m.pconst.length_scale, m.pconst.time_scale, m.pconst.mass_scale);
+    mout.modules = m.modules;
+    mout.hydro_gamma = m.hydro_gamma;
+    mout.vth_coeff = m.vth_coeff;
+    #ifdef DENSITY_PROTECTION
+    mout.minDensity = m.minDensity;
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    mout.minTemp = m.minTemp;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    #if defined(CARTESIAN_COORD)
+    mout.SetupCartesian(m.dim,
+                        m.minx1, m.maxx1, m.decomp.nx_global[0], m.ng1,
+                        m.minx2, m.maxx2, m.decomp.nx_global[1], m.ng2,
+                        m.minx3, m.maxx3, m.decomp.nx_global[2], m.ng3);
+    #elif defined(SPHERICAL_POLAR_COORD)
+    mout.SetupSphericalPolar(m.dim,
+                             m.minx1, m.maxx1, m.decomp.nx_global[0], m.ratio_dim1, m.ng1,
+                             m.minx2, m.maxx2, m.decomp.nx_global[1],               m.ng2,
+                             m.minx3, m.maxx3, m.decomp.nx_global[2],               m.ng3);
+    #endif // defined (COORDINATE)
+    #if defined(ENABLE_DUSTFLUID)
+    mout.NUMSPECIES = m.NUMSPECIES;
+    mout.rhodm = m.rhodm;
+    mout.dminDensity = m.dminDensity;
+    mout.GrainSizeList = m.GrainSizeList;
+    mout.GrainEdgeList = m.GrainEdgeList;
+    mout.GrainMassList = m.GrainMassList;
+    #endif // defined(ENABLE_DUSTFLUID)
+}
+
+
+// called by every rank; fields as in fill_output_frame
+void gather_output_mesh(mesh &m, mesh &mout, set<string> &fields){
+    if (fields.count("prim")){
+        gather_blocks(m, m.prim, mout.prim);
+    }
+    if (fields.count("cons")){
+        gather_blocks(m, m.cons, mout.cons);
+    }
+    #if defined(ENABLE_GRAVITY)
+    if (fields.count("grav")){
+        gather_blocks(m, m.grav->Phi_grav, mout.grav->Phi_grav);
+        gather_blocks(m, m.grav->Phi_grav_x1surface, mout.grav->Phi_grav_x1surface);
+        gather_blocks(m, m.grav->Phi_grav_x2surface, mout.grav->Phi_grav_x2surface);
+        gather_blocks(m, m.grav->Phi_grav_x3surface, mout.grav->Phi_grav_x3surface);
+        gather_blocks(m, m.grav->grav_x1, mout.grav->grav_x1);
+        gather_blocks(m, m.grav->grav_x2, mout.grav->grav_x2);
+        gather_blocks(m, m.grav->grav_x3, mout.grav->grav_x3);
+    }
+    #endif
+    #if defined(ENABLE_DUSTFLUID)
+    if (fields.count("dcons")){
+        gather_blocks(m, m.dcons.canonical(), mout.dcons.canonical());
+    }
+    if (fields.count("dprim")){
+        gather_blocks(m, m.dprim.canonical(), mout.dprim.canonical());
+    }
+    #ifdef ENABLE_DUST_GRAINGROWTH
+    if (fields.count("coag")){
+        gather_blocks(m, m.coag_substeps, mout.coag_substeps);
+    }
+    #endif // ENABLE_DUST_GRAINGROWTH
+    #endif
+    if (m.decomp.is_root() && m.UserScalers.checkallocated()){
+        mout.UserScalers = m.UserScalers;
+    }
+}
+#endif // ENABLE_MPI
+
+
+int main(int argc, char *argv[]){
+    #ifdef ENABLE_MPI
+    int mpi_thread_level;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_level);     // only the main thread calls MPI
+    #endif // ENABLE_MPI
+    /** start timer **/
+    auto start = std::chrono::steady_clock::now();
+
     /** Determine how to setup initial condition **/
     string input_filename;
     string restart_filename;
@@ -130,11 +356,15 @@ int main(int argc, char *argv[]){
     string foutput_root;
     string foutput_pre;
     string foutput_aft;
+    OutputOptions output_options;
 
     /** initialize time and cycle trackings **/
     int frame;
     double ot;
     int cycle;
+    double next_output_time;
+    int restart_frame = 0;
+    bool restart_has_prim = true;
 
     if (start_uinputf){
         /** read in necessary information from input file **/
@@ -160,12 +390,22 @@ int main(int argc, char *argv[]){
         double x3max  = finput.getDouble("x3max");
         int nx3       = finput.getInt("nx3");
         double ratio1 = pow(x1max / x1min, (1./ (double) nx1));
-        // determine number of ghost zones
+
+        /** Riemann solver, reconstruction and boundary conditions, defaults for keys not in the input file **/
+        m.modules.setup_modules(finput.inputdict);
+        // determine number of ghost zones, as many as the stencil of the reconstruction needs
+        int ngh = m.modules.ghost_zones();
         int ng1, ng2, ng3;
-        if      (dim == 1){ ng1 = 2; ng2 = 0; ng3 = 0; }
-        else if (dim == 2){ ng1 = 2; ng2 = 2; ng3 = 0; }
-        else if (dim == 3){ ng1 = 2; ng2 = 2; ng3 = 2; }
+        if      (dim == 1){ ng1 = ngh; ng2 = 0;   ng3 = 0; }
+        else if (dim == 2){ ng1 = ngh; ng2 = ngh; ng3 = 0; }
+        else if (dim == 3){ ng1 = ngh; ng2 = ngh; ng3 = ngh; }
         else { cout << "dimension not recognized! " << endl << flush; throw 1; }
+        /** block of the domain of this rank **/
+        int ng[3] = {ng1, ng2, ng3};
+        m.decomp.setup(dim, nx1, nx2, nx3, ng, m.modules.bc);
+        if (m.decomp.is_root()){
+            m.modules.print();
+        }
         #if defined(CARTESIAN_COORD)
         m.SetupCartesian(dim,
                           x1min, x1max, nx1, ng1,                       // ax1
@@ -179,21 +419,37 @@ int main(int argc, char *argv[]){
                               x3min, x3max, nx3,         ng3                        // ax3
                               );
         #endif // defined (COORDINATE)
+        m.setupScratchArrays();
         m.hydro_gamma = gamma_hydro;
         m.vth_coeff = 8.0 / M_PI * gamma_hydro;         // for calculating gas thermal speed
 
         #ifdef ENABLE_DUSTFLUID
             setup_dust(m, finput);          // fill in m.GrainEdgeList, m.GrainSizeList and m.NUMSPECIES
-            m.setupDustFluidMesh(m.NUMSPECIES);
-            for (int ii = 0; ii < m.NUMSPECIES; ii ++){
+            m.setupDustFluidMesh(m.NUMSPECIES);     // grain masses and the pair tables of grain growth
+            for (int ii = 0; ii < m.NUMSPECIES && m.decomp.is_root(); ii ++){
                 cout << m.GrainSizeList(ii) << endl << flush;
             }
-            m.GrainSizeTimesGrainDensity.NewBootesArray(m.NUMSPECIES);
-            m.GrainMassList.NewBootesArray(m.NUMSPECIES);
-            for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
-                m.GrainSizeTimesGrainDensity(specIND) = m.GrainSizeList(specIND) * m.rhodm;
-                m.GrainMassList(specIND) = 4. / 3. * M_PI * pow(m.GrainSizeList(specIND), 3) * m.rhodm;
+            if (finput.inputdict.count("dust_max_subcycles")){
+                m.dust_max_subcycles = finput.getInt("dust_max_subcycles");
+                if (m.dust_max_subcycles < 1){
+                    cout << "dust_max_subcycles must be at least 1" << endl << flush;
+                    throw 1;
+                }
+            }
+            if (finput.inputdict.count("dust_floor_skip")){
+                m.dust_floor_skip = finput.getInt("dust_floor_skip");
+            }
+            #ifdef ENABLE_DUST_GRAINGROWTH
+            if (finput.inputdict.count("coagulation_tol")){
+                m.coag_tol = finput.getDouble("coagulation_tol");
+            }
+            if (finput.inputdict.count("coagulation_min_density")){
+                m.coag_min_density = finput.getDouble("coagulation_min_density");
             }
+            if (finput.inputdict.count("coagulation_skip")){
+                m.coag_skip = finput.getDouble("coagulation_skip");
+            }
+            #endif // ENABLE_DUST_GRAINGROWTH
         #endif // ENABLE_DUSTFLUID
         /** setup initial condition **/
         setup(m, finput);   // setup according to the input file
@@ -210,11 +466,13 @@ int main(int argc, char *argv[]){
         foutput_root = finput.getString("foutput_root");
         foutput_pre  = finput.getString("foutput_pre");
         foutput_aft  = finput.getString("foutput_aft");
+        output_options.setup_options(finput.inputdict);
 
         /** initialize time and cycle trackings **/
         frame = 0;
         ot = 0;
         cycle = 0;
+        next_output_time = ot;
     }
 
     if (start_restart){
@@ -234,7 +492,14 @@ int main(int argc, char *argv[]){
         foutput_root = frestart.getString("foutput_root");
         foutput_pre  = frestart.getString("foutput_pre");
         foutput_aft  = frestart.getString("foutput_aft");
-        cout << ot << '\t' << frame << '\t' << cycle << endl << flush;
+        next_output_time = ot;
+        try {
+            next_output_time = frestart.getAttribute<double>("next_output_time");
+            restart_frame    = frestart.getAttribute<int>("restart_frame") + 1;
+        }
+        catch (H5::Exception &) {
+            ;
+        }
         int    dim = (int) frestart.getAttribute<unsigned int>("dim");
         int    nx1 = (int) frestart.getAttribute<unsigned int>("nx1");
         int    nx2 = (int) frestart.getAttribute<unsigned int>("nx2");
@@ -250,6 +515,38 @@ int main(int argc, char *argv[]){
         double x3max = frestart.getAttribute<double>("x3max");
         m.hydro_gamma = frestart.getAttribute<double>("hydro_gamma");
         m.vth_coeff = 8.0 / M_PI * m.hydro_gamma;         // for calculating gas thermal speed
+
+        /** modules of the run that wrote the restart file; older files without them get the defaults **/
+        map<string, string> module_choices = m.modules.names();
+        for (auto &choice : module_choices){
+            try {
+                choice.second = frestart.getString(choice.first);
+            }
+            catch (H5::Exception &) {
+                ;
+            }
+        }
+        m.modules.setup_modules(module_choices);
+        if (ng1 < m.modules.ghost_zones()){
+            cout << "the restart file has " << ng1 << " ghost zones, the reconstruction needs " << m.modules.ghost_zones() << endl << flush;
+            throw 1;
+        }
+        int ng[3] = {ng1, ng2, ng3};
+        m.decomp.setup(dim, nx1, nx2, nx3, ng, m.modules.bc);
+        if (m.decomp.is_root()){
+            cout << ot << '\t' << frame << '\t' << cycle << endl << flush;
+            m.modules.print();
+        }
+        map<string, string> output_option_choices = output_options.names();
+        for (auto &choice : output_option_choices){
+            try {
+                choice.second = frestart.getString(choice.first);
+            }
+            catch (H5::Exception &) {
+                ;
+            }
+        }
+        output_options.setup_options(output_option_choices);
         #if defined(CARTESIAN_COORD)
         m.SetupCartesian(dim,
                           x1min, x1max, nx1, ng1,                       // ax1
@@ -264,11 +561,16 @@ int main(int argc, char *argv[]){
                               x3min, x3max, nx3,         ng3                        // ax3
                               );
         #endif // defined (COORDINATE)
-        unsigned int h5start[4]     = {0, 0, 0, 0};
+        m.setupScratchArrays();
+        // the block of this rank (the whole arrays without MPI)
+        unsigned int h5start[4]     = {0, (unsigned int) m.decomp.offset[2], (unsigned int) m.decomp.offset[1], (unsigned int) m.decomp.offset[0]};
         unsigned int h5select[4]    = {5, (unsigned int) m.nx3 + 2 * m.ng3, (unsigned int) m.nx2 + 2 * m.ng2, (unsigned int) m.nx1 + 2 * m.ng1};
         unsigned int outputshape[4] = {5, (unsigned int) m.nx3 + 2 * m.ng3, (unsigned int) m.nx2 + 2 * m.ng2, (unsigned int) m.nx1 + 2 * m.ng1};
-        frestart.get4Ddata<double>("prim", h5start, h5select, outputshape, m.prim);
-        frestart.get4Ddata<double>("cons", h5start, h5select, outputshape, m.cons);
+        restart_has_prim = frestart.file->nameExists("prim");      // restart frames may carry cons only
+        if (restart_has_prim){
+            frestart.get4Ddata<state_real>("prim", h5start, h5select, outputshape, m.prim);
+        }
+        frestart.get4Ddata<state_real>("cons", h5start, h5select, outputshape, m.cons);
 
         /** setup gravity **/
         #if defined (ENABLE_GRAVITY)
@@ -283,7 +585,6 @@ int main(int argc, char *argv[]){
         }
         double ZERO = 0.0;
         work_after_loop(m, ZERO);
-        cout << m.grav->Phi_grav(0, 20, 20) << endl << flush;
         #endif // defined
 
         /** protections **/
@@ -293,126 +594,89 @@ int main(int argc, char *argv[]){
         #ifdef ENABLE_TEMPERATURE_PROTECTION
         m.minTemp = frestart.getAttribute<double>("mintemp");
         #endif // ENABLE_TEMPERATURE_PROTECTION
+        if (!restart_has_prim){
+            cons_to_prim(m);
+            apply_boundary_condition(m);
+        }
     }
 
     /** initialize decisions in loop **/
-    double next_output_time = ot;
+    double next_restart_time = ot + output_options.restart_dt;
     double next_exit_loop_time = next_output_time;
     bool det_output = false;
+    bool det_restart = false;
     bool det_doloop = false;
 
-    std::cout << "setup complete" << std::endl << flush;
+    /** output files are written by a background thread while the integration goes on **/
+    AsyncOutput writer;
+    #ifdef ENABLE_MPI
+    mesh mout;
+    if (m.decomp.is_root()){
+        setup_output_mesh(m, mout);
+    }
+    #else
+    mesh &mout = m;                 // a single block is the whole domain
+    #endif // ENABLE_MPI
+
+    if (m.decomp.is_root()){
+        std::cout << "setup complete" << std::endl << flush;
+    }
     /** main loop **/
     while (ot < t_tot){
         // step 1: determine when to exit the time integration loop
         next_exit_loop_time = min(next_output_time, t_tot);
-        // step 2: determine what needs to be done
-        if (ot >= next_output_time){
-            det_output = true;
-            det_doloop = false;
-        }
-        else{
-            det_output = false;
-            det_doloop = true;
+        if (output_options.restart_dt > 0){
+            next_exit_loop_time = min(next_exit_loop_time, next_restart_time);
         }
+        // step 2: determine what needs to be done
+        det_output  = (ot >= next_output_time);
+        det_restart = (output_options.restart_dt > 0 && ot >= next_restart_time);
+        det_doloop  = !det_output && !det_restart;
         // step 3: do what needs to be done
         if (det_doloop){
             doloop(ot, next_exit_loop_time, m, CFL);
         }
         if (det_output){
-            Output output(foutput_root + foutput_pre + "." + choosenumber(frame) + "." + foutput_aft, 'w');
-            output.writeattribute<double>(&m.pconst.mass_scale,   "mass_scale", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.pconst.length_scale, "length_scale", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.pconst.time_scale,   "time_scale", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&ot, "time", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&t_tot, "tot_time", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&t_tot, "t_tot", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&CFL, "CFL", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&output_dt, "output_dt", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<int>(&frame, "frame", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&cycle, "main_cycle", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.dim, "dim", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.nx1, "nx1", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.nx2, "nx2", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.nx3, "nx3", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.ng1, "ng1", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.ng2, "ng2", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.ng3, "ng3", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x1s, "x1s", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x1l, "x1l", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x2s, "x2s", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x2l, "x2l", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x3s, "x3s", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<int>(&m.x3l, "x3l", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<double>(&m.maxx1, "x1max", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.minx1, "x1min", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.maxx2, "x2max", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.minx2, "x2min", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.maxx3, "x3max", H5::PredType::NATIVE_DOUBLE, 1);
-            output.writeattribute<double>(&m.minx3, "x3min", H5::PredType::NATIVE_DOUBLE, 1);
-            #ifdef SPHERICAL_POLAR_COORD
-            output.writeattribute<double>(&m.ratio_dim1, "ratio1", H5::PredType::NATIVE_DOUBLE, 1);
-            #endif
-            output.writeattribute<const int>(&outputIDN, "rhoIND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIM1, "mo1IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIM2, "mo2IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIM3, "mo3IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIEN, "eneIND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIDP, "denIND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIV1, "ve1IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIV2, "ve2IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIV3, "ve3IND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<const int>(&outputIPN, "prsIND", H5::PredType::NATIVE_INT32, 1);
-            output.writeattribute<double>(&m.hydro_gamma, "hydro_gamma", H5::PredType::NATIVE_DOUBLE, 1);
-            #ifdef DENSITY_PROTECTION
-            output.writeattribute<double>(&m.minDensity, "mindensity", H5::PredType::NATIVE_DOUBLE, 1);
-            #endif // DENSITY_PROTECTION
-            #ifdef ENABLE_TEMPERATURE_PROTECTION
-            output.writeattribute<double>(&m.minTemp, "mintemp", H5::PredType::NATIVE_DOUBLE, 1);
-            #endif // ENABLE_TEMPERATURE_PROTECTION
-            output.writeStringdataset(foutput_root, "foutput_root");
-            output.writeStringdataset(foutput_pre, "foutput_pre");
-            output.writeStringdataset(foutput_aft, "foutput_aft");
-            //output.writeattribute<string>(&foutput_pre, "foutput_pre", H5::PredType::NATIVE_SCHAR, 1);
-            //output.writeattribute<string>(&foutput_aft, "foutput_aft", H5::PredType::NATIVE_SCHAR, 1);
-            output.write1Ddataset(m.x1v,  "x1v",  H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.x2v,  "x2v",  H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.x3v,  "x3v",  H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.x1f,  "x1f",  H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.x2f,  "x2f",  H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.x3f,  "x3f",  H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.dx1p, "dx1p", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.dx2p, "dx2p", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.dx3p, "dx3p", H5::PredType::NATIVE_DOUBLE);
-            output.write4Ddataset(m.prim, "prim", H5::PredType::NATIVE_DOUBLE);
-            output.write4Ddataset(m.cons, "cons", H5::PredType::NATIVE_DOUBLE);
-            #if defined(ENABLE_GRAVITY)
-            output.write3Ddataset(m.grav->Phi_grav, "Phi", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->Phi_grav_x1surface, "Phi_x1s", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->Phi_grav_x2surface, "Phi_x2s", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->Phi_grav_x3surface, "Phi_x3s", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->grav_x1, "grav_x1", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->grav_x2, "grav_x2", H5::PredType::NATIVE_DOUBLE);
-            output.write3Ddataset(m.grav->grav_x3, "grav_x3", H5::PredType::NATIVE_DOUBLE);
-            #endif
-            #if defined(ENABLE_DUSTFLUID)
-            output.write1Ddataset(m.GrainSizeList, "grain_size_list", H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.GrainEdgeList, "grain_edge_list", H5::PredType::NATIVE_DOUBLE);
-            output.write1Ddataset(m.GrainMassList, "grain_mass_list", H5::PredType::NATIVE_DOUBLE);
-            output.write5Ddataset(m.dcons, "dcons", H5::PredType::NATIVE_DOUBLE);
-            output.write5Ddataset(m.dprim, "dprim", H5::PredType::NATIVE_DOUBLE);
-            #endif
-            if (m.UserScalers.checkallocated()){
-            output.write1Ddataset(m.UserScalers, "UserScalers", H5::PredType::NATIVE_DOUBLE);
+            #ifdef ENABLE_MPI
+            gather_output_mesh(m, mout, output_options.output_fields);
+            #endif // ENABLE_MPI
+            if (m.decomp.is_root()){
+                OutputFrame &output = writer.acquire(foutput_root + foutput_pre + "." + choosenumber(frame) + "." + foutput_aft);
+                output_options.apply_filters(output, false);
+                fill_output_frame(output, mout, output_options.output_fields, output_options,
+                                  ot, t_tot, CFL, output_dt, frame, next_output_time, restart_frame, cycle,
+                                  foutput_root, foutput_pre, foutput_aft);
+                writer.submit(output);
+                double elasped = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.;
+                std::cout << "Output frame " << frame << '\t' << "Elapsed real time =" << elasped << " seconds" << std::endl;
             }
-            output.close();
-            double elasped = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.;
-            std::cout << "Output frame " << frame << '\t' << "Elapsed real time =" << elasped << " seconds" << std::endl;
             frame += 1;
             next_output_time += output_dt;
         }
+        if (det_restart){
+            #ifdef ENABLE_MPI
+            gather_output_mesh(m, mout, output_options.restart_fields);
+            #endif // ENABLE_MPI
+            if (m.decomp.is_root()){
+                OutputFrame &output = writer.acquire(foutput_root + foutput_pre + ".rst." + choosenumber(restart_frame) + "." + foutput_aft);
+                output_options.apply_filters(output, true);
+                fill_output_frame(output, mout, output_options.restart_fields, output_options,
+                                  ot, t_tot, CFL, output_dt, frame, next_output_time, restart_frame, cycle,
+                                  foutput_root, foutput_pre, foutput_aft);
+                writer.submit(output);
+                std::cout << "Restart frame " << restart_frame << std::endl;
+            }
+            restart_frame += 1;
+            next_restart_time += output_options.restart_dt;
+        }
         cycle += 1;
-        cout << "main cycle: " << cycle << "    time: " << ot << endl << flush;
+        if (m.decomp.is_root()){
+            cout << "main cycle: " << cycle << "    time: " << ot << endl << flush;
+        }
     }
+    writer.finish();
+    #ifdef ENABLE_MPI
+    MPI_Finalize();
+    #endif // ENABLE_MPI
     return 0;
 }
@@ -2,14 +2,43 @@
 #include "../algorithm/BootesArray.hpp"
 #include "../algorithm/boundary_condition/standard_bc.hpp"
 #include <cstdlib>
+#include <cmath>
 #include "../algorithm/inoutput/input.hpp"
 
 
+// rand() is drawn in the order of the whole domain, two numbers per zone, so the perturbation does not depend
+// on the number of MPI ranks: the numbers of the zones of other blocks before (kk, jj, ii) are skipped
+static void skip_draws(mesh &m, long long &drawn, int kk, int jj, int ii){
+    long long zone = ((long long) (kk - m.x3s + m.decomp.offset[2]) * m.decomp.nx_global[1] + jj - m.x2s + m.decomp.offset[1])
+                     * m.decomp.nx_global[0] + ii - m.x1s + m.decomp.offset[0];
+    for (; drawn < 2 * zone; drawn++){
+        rand();
+    }
+}
+
+
 void setup(mesh &m, input_file &finput){
-    srand(time(0));
+    // floors of the protections (mindensity and mintemp in the input file); without them the floors are 0
+    #ifdef DENSITY_PROTECTION
+    m.minDensity = finput.inputdict.count("mindensity") ? finput.getDouble("mindensity") : 0;
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    m.minTemp = finput.inputdict.count("mintemp") ? finput.getDouble("mintemp") : 0;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    // a fixed random_seed in the input file makes the perturbation reproducible, e.g. to compare builds
+    srand(finput.inputdict.count("random_seed") ? finput.getInt("random_seed") : time(0));
+    // kh_perturbation = sine: shear layers smoothed over kh_width (default 0.05) and a single mode of wavelength
+    // kh_wavelength (default 1) instead of the random perturbation, so that runs at different resolutions
+    // converge to the same flow (src/benchmark/integrator_convergence.sh)
+    bool sine = finput.inputdict.count("kh_perturbation") && finput.getString("kh_perturbation") == "sine";
+    double width      = finput.inputdict.count("kh_width") ? finput.getDouble("kh_width") : 0.05;
+    double wavelength = finput.inputdict.count("kh_wavelength") ? finput.getDouble("kh_wavelength") : 1.0;
+    long long drawn = 0;
     for (int kk = m.x3s; kk < m.x3l; kk++){
         for (int jj = m.x2s; jj < m.x2l; jj++){
             for (int ii = m.x1s; ii < m.x1l; ii++){
+                skip_draws(m, drawn, kk, jj, ii);
+                drawn += 2;
                 // 1
                 if (abs(m.x2v(jj)) < 0.5){
                     m.cons(IDN, kk, jj, ii) = 2.0;
@@ -43,6 +72,18 @@ void setup(mesh &m, input_file &finput){
                                                                   vel2,
                                                                   vel3, m.hydro_gamma);
                 }
+                if (sine){
+                    double y = m.x2v(jj);
+                    double band = 0.5 * (tanh((y + 0.5) / width) - tanh((y - 0.5) / width));     // 1 for |y| < 0.5, 0 outside
+                    double vel1 = 0.5 - band;
+                    double vel2 = 0.01 * sin(2 * M_PI * m.x1v(ii) / wavelength)
+                                * (exp(- pow((y - 0.5) / 0.2, 2)) + exp(- pow((y + 0.5) / 0.2, 2)));
+                    m.cons(IDN, kk, jj, ii) = 1.0 + band;
+                    m.cons(IM1, kk, jj, ii) = vel1 * m.cons(IDN, kk, jj, ii);
+                    m.cons(IM2, kk, jj, ii) = vel2 * m.cons(IDN, kk, jj, ii);
+                    m.cons(IM3, kk, jj, ii) = 0;
+                    m.cons(IEN, kk, jj, ii) = ene(m.cons(IDN, kk, jj, ii), m.prim(IPN, kk, jj, ii), vel1, vel2, 0., m.hydro_gamma);
+                }
             }
         }
     }
@@ -52,3 +93,8 @@ void setup(mesh &m, input_file &finput){
 void work_after_loop(mesh &m, double &dt){
     ;
 }
+
+
+void apply_user_extra_boundary_condition(mesh &m){
+    ;
+}
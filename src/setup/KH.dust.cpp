@@ -62,11 +62,33 @@ void setup_dust_IC(mesh &m, input_file &finput){
 }
 
 
+// rand() is drawn in the order of the whole domain, two numbers per zone, so the perturbation does not depend
+// on the number of MPI ranks: the numbers of the zones of other blocks before (kk, jj, ii) are skipped
+static void skip_draws(mesh &m, long long &drawn, int kk, int jj, int ii){
+    long long zone = ((long long) (kk - m.x3s + m.decomp.offset[2]) * m.decomp.nx_global[1] + jj - m.x2s + m.decomp.offset[1])
+                     * m.decomp.nx_global[0] + ii - m.x1s + m.decomp.offset[0];
+    for (; drawn < 2 * zone; drawn++){
+        rand();
+    }
+}
+
+
 void setup(mesh &m, input_file &finput){
-    srand(time(0));
+    // floors of the protections (mindensity and mintemp in the input file); without them the floors are 0
+    #ifdef DENSITY_PROTECTION
+    m.minDensity = finput.inputdict.count("mindensity") ? finput.getDouble("mindensity") : 0;
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    m.minTemp = finput.inputdict.count("mintemp") ? finput.getDouble("mintemp") : 0;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    // a fixed random_seed in the input file makes the perturbation reproducible, e.g. to compare builds
+    srand(finput.inputdict.count("random_seed") ? finput.getInt("random_seed") : time(0));
+    long long drawn = 0;
     for (int kk = m.x3s; kk < m.x3l; kk++){
         for (int jj = m.x2s; jj < m.x2l; jj++){
             for (int ii = m.x1s; ii < m.x1l; ii++){
+                skip_draws(m, drawn, kk, jj, ii);
+                drawn += 2;
                 // 1
                 if (abs(m.x2v(jj)) < 0.5){
                     m.cons(IDN, kk, jj, ii) = 2.0;
@@ -111,3 +133,8 @@ void setup(mesh &m, input_file &finput){
 void work_after_loop(mesh &m, double &dt){
     ;
 }
+
+
+void apply_user_extra_boundary_condition(mesh &m){
+    ;
+}
@@ -0,0 +1,83 @@
+#include "../algorithm/mesh/mesh.hpp"
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/inoutput/input.hpp"
+#include <cmath>
+
+
+// Gaussian pulse of dust advected along x1 by uniform gas moving with it, so the drag vanishes and the exact
+// solution is the pulse shifted by velocity * t. The profile is kept in UserScalers (x0, width, amplitude,
+// background, velocity), so the output holds what the error is measured against (src/benchmark/dust_convergence.sh).
+// Input: num_species, srho, smin, smax, dminDensity, and optionally dust_x0 (0.3), dust_width (0.05),
+// dust_amplitude (1), dust_background (0.01), dust_velocity (1).
+static double input_or(input_file &finput, const char *key, double value){
+    return finput.inputdict.count(key) ? finput.getDouble(key) : value;
+}
+
+
+void setup_dust(mesh &m, input_file &finput){
+    double smin    = finput.getDouble("smin");
+    double smax    = finput.getDouble("smax");
+    double rhodm   = finput.getDouble("srho");
+    int ns         = finput.getInt("num_species");
+    m.NUMSPECIES = ns;
+    m.rhodm = rhodm;
+
+    m.GrainEdgeList = logspace(log10(smin), log10(smax), ns + 1, true);
+    m.GrainSizeList.NewBootesArray(ns);
+    for (int specIND = 0; specIND < m.NUMSPECIES; specIND ++){
+        double s2 = m.GrainEdgeList(specIND + 1);
+        double s1 = m.GrainEdgeList(specIND);
+        m.GrainSizeList(specIND) = pow((pow(s2, 4) - pow(s1, 4)) / (4 * (s2 - s1)), 1./3.);
+    }
+}
+
+
+void setup(mesh &m, input_file &finput){
+    // floors of the protections (mindensity and mintemp in the input file); without them the floors are 0
+    #ifdef DENSITY_PROTECTION
+    m.minDensity = finput.inputdict.count("mindensity") ? finput.getDouble("mindensity") : 0;
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    m.minTemp = finput.inputdict.count("mintemp") ? finput.getDouble("mintemp") : 0;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
+    m.dminDensity = finput.getDouble("dminDensity");
+    m.UserScalers.NewBootesArray(5);
+    m.UserScalers(0) = input_or(finput, "dust_x0", 0.3);
+    m.UserScalers(1) = input_or(finput, "dust_width", 0.05);
+    m.UserScalers(2) = input_or(finput, "dust_amplitude", 1.0);
+    m.UserScalers(3) = input_or(finput, "dust_background", 0.01);
+    m.UserScalers(4) = input_or(finput, "dust_velocity", 1.0);
+    double vel1 = m.UserScalers(4);
+
+    for (int kk = m.x3s; kk < m.x3l; kk++){
+        for (int jj = m.x2s; jj < m.x2l; jj++){
+            for (int ii = m.x1s; ii < m.x1l; ii++){
+                m.cons(IDN, kk, jj, ii) = 1.0;
+                m.cons(IM1, kk, jj, ii) = vel1 * m.cons(IDN, kk, jj, ii);
+                m.cons(IM2, kk, jj, ii) = 0;
+                m.cons(IM3, kk, jj, ii) = 0;
+                m.prim(IPN, kk, jj, ii) = 1.0;
+                m.cons(IEN, kk, jj, ii) = ene(m.cons(IDN, kk, jj, ii), m.prim(IPN, kk, jj, ii), vel1, 0., 0., m.hydro_gamma);
+
+                double xi = (m.x1v(ii) - m.UserScalers(0)) / m.UserScalers(1);
+                double rho = m.UserScalers(3) + m.UserScalers(2) * exp(- xi * xi);
+                for (int ss = 0; ss < m.NUMSPECIES; ss++){
+                    m.dcons(ss, IDN, kk, jj, ii) = rho;
+                    m.dcons(ss, IM1, kk, jj, ii) = rho * vel1;
+                    m.dcons(ss, IM2, kk, jj, ii) = 0;
+                    m.dcons(ss, IM3, kk, jj, ii) = 0;
+                }
+            }
+        }
+    }
+}
+
+
+void work_after_loop(mesh &m, double &dt){
+    ;
+}
+
+
+void apply_user_extra_boundary_condition(mesh &m){
+    ;
+}
@@ -253,9 +253,12 @@ namespace {
     }
 
     void apply_user_extra_boundary_condition(mesh &m){
+        // only blocks at the upper and outer radial domain boundaries have these ghost zones (see Decomposition)
+        int ng_upper = m.decomp.domain_face(BX3O) ? m.ng3 : 0;
+        int ng_outer = m.decomp.domain_face(BX1O) ? m.ng1 : 0;
         // upper boundary has fixed density of initial density
         #pragma omp parallel for collapse(3)
-        for (int gind3 = 0; gind3 < m.ng3; gind3 ++){
+        for (int gind3 = 0; gind3 < ng_upper; gind3 ++){
             for (int jj = m.x2s; jj < m.x2l; jj++){
                 for (int ii = m.x1s; ii < m.x1l; ii++){
                     double v1 = m.prim(IV1, m.x3l + gind3, jj, ii);
@@ -276,7 +279,7 @@ namespace {
 
         // outer radial (x) boundary always has 0 radial speed.
         #pragma omp parallel for collapse(3) schedule (static)
-        for (int gind1 = 0; gind1 < m.ng1; gind1 ++){
+        for (int gind1 = 0; gind1 < ng_outer; gind1 ++){
             for (int kk = m.x3s; kk < m.x3l; kk++){
                 for (int jj = m.x2s; jj < m.x2l; jj++){
                     //quan(IDN, kk, jj, x1l + gind1)     = quan(IDN, kk, jj, x1l - (gind1 + 1));
@@ -296,7 +299,7 @@ namespace {
         // upper boundary has fixed density of initial density
         #pragma omp parallel for collapse(4)
         for (int ss = 0; ss < m.NUMSPECIES; ss++){
-            for (int gind3 = 0; gind3 < m.ng3; gind3 ++){
+            for (int gind3 = 0; gind3 < ng_upper; gind3 ++){
                 for (int jj = m.x2s; jj < m.x2l; jj++){
                     for (int ii = m.x1s; ii < m.x1l; ii++){
                         double v1 = m.dprim(ss, IV1, m.x3l + gind3, jj, ii);
@@ -306,7 +309,7 @@ namespace {
                         m.dcons(ss, IM1, m.x3l + gind3, jj, ii) = v1 * m.dcons(ss, IDN, m.x3l + gind3, jj, ii);
                         m.dcons(ss, IM2, m.x3l + gind3, jj, ii) = v2 * m.dcons(ss, IDN, m.x3l + gind3, jj, ii);
                         m.dcons(ss, IM3, m.x3l + gind3, jj, ii) = v3 * m.dcons(ss, IDN, m.x3l + gind3, jj, ii);
-                        m.dprim(ss, IDN, m.x3l + gind3, jj, ii) = m.dcons(IDN, m.x3l + gind3, jj, ii);
+                        m.dprim(ss, IDN, m.x3l + gind3, jj, ii) = m.dcons(ss, IDN, m.x3l + gind3, jj, ii);
                     }
                 }
             }
@@ -315,7 +318,7 @@ namespace {
         // TODO: outer radial boundary
         #pragma omp parallel for collapse(4)
         for (int ss = 0; ss < m.NUMSPECIES; ss++){
-            for (int gind1 = 0; gind1 < m.ng1; gind1 ++){
+            for (int gind1 = 0; gind1 < ng_outer; gind1 ++){
                 for (int kk = m.x3s; kk < m.x3l; kk++){
                     for (int jj = m.x2s; jj < m.x2l; jj++){
                         //quan(IDN, kk, jj, x1l + gind1)     = quan(IDN, kk, jj, x1l - (gind1 + 1));
@@ -1,15 +1,17 @@
 #include "../algorithm/mesh/mesh.hpp"
-#include "../algorithm/YishengArray.hpp"
+#include "../algorithm/BootesArray.hpp"
+#include "../algorithm/inoutput/input.hpp"
 
-void setup(mesh &m){
-    float gamma_hydro = 1.4;
-    m.SetupCartesian(1,
-                     0., 1., 100., 2,             // ax1
-                     0., 1., 1., 0,               // ax2
-                     0., 1., 1., 0                // ax3
-                     );
-    m.hydro_gamma = gamma_hydro;
 
+// Sod-like shock tube along x1 at x0 = 0.3; the grid and gamma come from the input file
+void setup(mesh &m, input_file &finput){
+    // floors of the protections (mindensity and mintemp in the input file); without them the floors are 0
+    #ifdef DENSITY_PROTECTION
+    m.minDensity = finput.inputdict.count("mindensity") ? finput.getDouble("mindensity") : 0;
+    #endif // DENSITY_PROTECTION
+    #ifdef ENABLE_TEMPERATURE_PROTECTION
+    m.minTemp = finput.inputdict.count("mintemp") ? finput.getDouble("mintemp") : 0;
+    #endif // ENABLE_TEMPERATURE_PROTECTION
     float x0 = 0.3;
     for (int kk = m.x3s; kk < m.x3l; kk++){
         for (int jj = m.x2s; jj < m.x2l; jj++){
@@ -46,11 +48,14 @@ void setup(mesh &m){
             }
         }
     }
-    //for (int jj = m.x2s; jj < m.x2l; jj ++){
-    //    m.mom1(m.nghost, jj, m.nghost) = 3;
-    //}
-    //m.mom1(1, m.x2s + m.nx2 * 1 / 4 + 2, 101) = 10;
+}
+
+
+void work_after_loop(mesh &m, double &dt){
+    ;
+}
+
 
-    m.cons_to_prim();
-    apply_boundary_condition(m);
+void apply_user_extra_boundary_condition(mesh &m){
+    ;
 }